@@ -0,0 +1,302 @@
+#pragma once
+
+// Default minimum distance between galaxies in a benchmark universe. Matches the New Game Screen.
+#define BENCHMARK_MIN_DISTANCE 20
+
+/*
+Settings for a headless benchmark run. Each may be set from the command line.
+*/
+struct BenchmarkSettings {
+
+	// Dimensions of the universe.
+	int width = 500;
+	int height = 500;
+
+	// Number and GalaxyType of galaxies to generate.
+	int numGalaxies = 1;
+	int shape = RING;
+
+	// Approximate number of empires per galaxy. Every system is colonized if 0.
+	int numEmpires = 0;
+
+	// Number of threads used by the scheduler. Every hardware thread is used if 0.
+	int numThreads = 0;
+
+	// Number of turns to perform.
+	int numTurns = 100;
+
+	// Number of planet searches timed after the turns.
+	int numSearches = 1000;
+
+	// Seed for generation. A time based seed is used if 0.
+	unsigned int seed = 0;
+
+};
+
+/*
+Results of timing planet searches. Each search is run once with lambdas and once with the same
+lambdas wrapped in std::functions, so that the cost of an indirect call per node can be seen.
+*/
+struct SearchBenchmark {
+
+	// Number of nodes expanded by each set of searches.
+	long long numNodes;
+
+	// Time taken by each set of searches, in microseconds.
+	long long lambdaTime;
+	long long functionTime;
+
+};
+
+// Parses the command line into BenchmarkSettings.
+bool parseBenchmarkArgs(int argc, char* args[], BenchmarkSettings* settings);
+
+// Times planetPathfind over random tiles of every HabitablePlanet.
+void benchmarkSearches(int numSearches, SearchBenchmark* results);
+
+// Prints the results of a benchmark as JSON.
+void printBenchmarkResults(const BenchmarkSettings* settings, long long generationTime, long long runTime, const SearchBenchmark* searches);
+
+/*
+Prints the command line usage of the benchmark.
+*/
+void printBenchmarkUsage(const char* name) {
+	fprintf(stderr,
+		"usage: %s [--width n] [--height n] [--galaxies n] [--shape random|ring|spiral]\n"
+		"          [--empires n] [--threads n] [--turns n] [--searches n] [--seed n]\n",
+		name);
+
+}
+
+/*
+Parses the command line into settings. Returns false if an argument is unknown or malformed.
+*/
+bool parseBenchmarkArgs(int argc, char* args[], BenchmarkSettings* settings) {
+
+	// Reads each argument and its value.
+	for (int i = 1; i < argc; ++i) {
+		if (i + 1 >= argc) return false;
+		const char* arg = args[i];
+		const char* value = args[++i];
+
+		// Reads the galaxy shape by name.
+		if (!strcmp(arg, "--shape")) {
+			if (!strcmp(value, "random")) settings->shape = RANDOM;
+			else if (!strcmp(value, "ring")) settings->shape = RING;
+			else if (!strcmp(value, "spiral")) settings->shape = SPIRAL;
+			else return false;
+			continue;
+
+		}
+
+		// Reads all other (numeric) arguments.
+		char* end;
+		long long number = strtoll(value, &end, 10);
+		if (*end || number < 0) return false;
+		if (!strcmp(arg, "--width")) settings->width = (int)number;
+		else if (!strcmp(arg, "--height")) settings->height = (int)number;
+		else if (!strcmp(arg, "--galaxies")) settings->numGalaxies = (int)number;
+		else if (!strcmp(arg, "--empires")) settings->numEmpires = (int)number;
+		else if (!strcmp(arg, "--threads")) settings->numThreads = (int)number;
+		else if (!strcmp(arg, "--turns")) settings->numTurns = (int)number;
+		else if (!strcmp(arg, "--searches")) settings->numSearches = (int)number;
+		else if (!strcmp(arg, "--seed")) settings->seed = (unsigned int)number;
+		else return false;
+
+	}
+
+	// Rejects universes which cannot hold a galaxy.
+	return settings->width > 50 && settings->height > 50 && settings->numGalaxies > 0;
+
+}
+
+/*
+Runs the simulation without a window or renderer, then prints turns per second and the wall
+time spent in each phase as JSON. Returns 0 on success, 1 if the arguments are invalid.
+
+Replaces the old speedTest, which had to be hand edited into main.
+*/
+int benchmarkMain(int argc, char* args[]) {
+	using std::chrono::steady_clock;
+	using std::chrono::microseconds;
+	using std::chrono::duration_cast;
+	BenchmarkSettings settings;
+	SearchBenchmark searches;
+
+	// Reads the settings from the command line.
+	if (!parseBenchmarkArgs(argc, args, &settings)) {
+		printBenchmarkUsage(args[0]);
+		return 1;
+
+	}
+
+	// Seeds generation and simulation.
+	if (!settings.seed) settings.seed = (unsigned int)time(NULL);
+	seedRandom(settings.seed);
+
+	// Initializes multithreading items.
+	initThreading(settings.numThreads);
+	initPathHeaps();
+	initExploredMaps();
+
+	// Creates the GalaxyInstructions. Uninitialized values are randomized during generation.
+	GalaxyInstruction* galInstrs = new GalaxyInstruction[settings.numGalaxies]();
+	for (int i = 0; i < settings.numGalaxies; ++i) {
+		galInstrs[i].type = settings.shape;
+		galInstrs[i].numEmpires = settings.numEmpires;
+
+	}
+
+	// Generates the universe.
+	auto generationStart = steady_clock::now();
+	universeWidth = settings.width;
+	universeHeight = settings.height;
+	numGals = settings.numGalaxies;
+	generateUniverse(universeWidth, universeHeight, numGals, BENCHMARK_MIN_DISTANCE, galInstrs);
+	long long generationTime = duration_cast<microseconds>(steady_clock::now() - generationStart).count();
+	delete[] galInstrs;
+
+	// Performs every turn back to back.
+	currTurn = 0;
+	resetProfile();
+	auto runStart = steady_clock::now();
+	while (currTurn < settings.numTurns) beginGameTurn();
+	long long runTime = duration_cast<microseconds>(steady_clock::now() - runStart).count();
+
+	// Times the search kernels on the final state of the universe.
+	benchmarkSearches(settings.numSearches, &searches);
+
+	// Prints the results.
+	printBenchmarkResults(&settings, generationTime, runTime, &searches);
+	fflush(stdout);
+
+	// Stops the worker threads so that the process can exit.
+	shutdownThreading();
+	return 0;
+
+}
+
+/*
+Times numSearches searches with planetPathfind, each between two random tiles of a HabitablePlanet.
+The planets are visited in turn. Searches have no heuristic, so each floods outwards until it
+reaches its target, as most of the game's searches do.
+
+The searches are run once with lambdas and then repeated with std::functions, using the same
+planets and tiles. endCondition is called once per expanded node, so it counts the nodes.
+*/
+void benchmarkSearches(int numSearches, SearchBenchmark* results) {
+	using std::chrono::steady_clock;
+	using std::chrono::microseconds;
+	using std::chrono::duration_cast;
+	HabitablePlanet** planets;
+	int* tiles;
+	int numPlanets = 0;
+	long long numNodes = 0;
+	*results = {};
+
+	// Lists every HabitablePlanet.
+	habitablePool.forEach([&numPlanets](HabitablePlanet* planet) { ++numPlanets; });
+	if (!numPlanets || !numSearches) return;
+	planets = (HabitablePlanet**)malloc(numPlanets * sizeof(HabitablePlanet*));
+	numPlanets = 0;
+	habitablePool.forEach([planets, &numPlanets](HabitablePlanet* planet) { planets[numPlanets++] = planet; });
+
+	// Picks the starting and target tile of each search.
+	tiles = (int*)malloc(numSearches * 4 * sizeof(int));
+	for (int i = 0; i < numSearches; ++i) {
+		int size = planets[i % numPlanets]->size;
+		for (int j = 0; j < 4; ++j) tiles[i * 4 + j] = randS() % size;
+
+	}
+
+	// Callbacks shared by both sets of searches.
+	int xTarget, yTarget;
+	auto endCondition = [&numNodes, &xTarget, &yTarget](HabitablePlanet* planet, LinkedListNode<PathCoordinate>* currPos)->bool {
+		++numNodes;
+		return currPos->value->coord.x == xTarget && currPos->value->coord.y == yTarget;
+
+	};
+	auto action = [](HabitablePlanet* planet, LinkedListNode<PathCoordinate>* currPos) {};
+	auto calcG = [](HabitablePlanet* planet, int xBeg, int yBeg, int xDest, int yDest)->int { return 1; };
+	auto calcH = [](HabitablePlanet* planet, LinkedListNode<PathCoordinate>* currPos)->double { return 0; };
+
+	// Times the searches with lambdas.
+	auto start = steady_clock::now();
+	for (int i = 0; i < numSearches; ++i) {
+		HabitablePlanet* planet = planets[i % numPlanets];
+		xTarget = tiles[i * 4 + 2];
+		yTarget = tiles[i * 4 + 3];
+		planet->planetPathfind(tiles[i * 4], tiles[i * 4 + 1], planet->size * 2, endCondition, action, calcG, calcH);
+
+	}
+	results->lambdaTime = duration_cast<microseconds>(steady_clock::now() - start).count();
+	results->numNodes = numNodes;
+
+	// Times the same searches through std::functions.
+	std::function<bool(HabitablePlanet*, LinkedListNode<PathCoordinate>*)> endFunction = endCondition;
+	std::function<void(HabitablePlanet*, LinkedListNode<PathCoordinate>*)> actionFunction = action;
+	std::function<int(HabitablePlanet*, int, int, int, int)> gFunction = calcG;
+	std::function<double(HabitablePlanet*, LinkedListNode<PathCoordinate>*)> hFunction = calcH;
+	start = steady_clock::now();
+	for (int i = 0; i < numSearches; ++i) {
+		HabitablePlanet* planet = planets[i % numPlanets];
+		xTarget = tiles[i * 4 + 2];
+		yTarget = tiles[i * 4 + 3];
+		planet->planetPathfind(tiles[i * 4], tiles[i * 4 + 1], planet->size * 2, endFunction, actionFunction, gFunction, hFunction);
+
+	}
+	results->functionTime = duration_cast<microseconds>(steady_clock::now() - start).count();
+
+	// Releases held data.
+	free(planets);
+	free(tiles);
+
+}
+
+/*
+Prints the settings and results of a benchmark as a single JSON object. Times are in milliseconds,
+except for the cost of each search node, which is in nanoseconds.
+*/
+void printBenchmarkResults(const BenchmarkSettings* settings, long long generationTime, long long runTime, const SearchBenchmark* searches) {
+	static const char* shapeNames[] = {"random", "ring", "spiral"};
+
+	// Prints the settings and how the universe is stored. numGals may be lower than requested if
+	// a galaxy failed to be placed.
+	printf("{\n");
+	printf("\t\"width\": %d,\n", settings->width);
+	printf("\t\"height\": %d,\n", settings->height);
+	printf("\t\"galaxies\": %d,\n", numGals);
+	printf("\t\"shape\": \"%s\",\n", shapeNames[settings->shape]);
+	printf("\t\"empires\": %d,\n", settings->numEmpires);
+	printf("\t\"threads\": %d,\n", numThreads);
+	printf("\t\"sparse\": %s,\n", universe.sparse ? "true" : "false");
+	printf("\t\"universe_blocks\": %d,\n", universe.numBlocks);
+	printf("\t\"turns\": %d,\n", settings->numTurns);
+	printf("\t\"seed\": %u,\n", settings->seed);
+
+	// Prints the overall times.
+	printf("\t\"generation_ms\": %.3f,\n", generationTime / 1000.0);
+	printf("\t\"run_ms\": %.3f,\n", runTime / 1000.0);
+	printf("\t\"turns_per_sec\": %.3f,\n", runTime ? settings->numTurns * 1000000.0 / runTime : 0.0);
+
+	// Prints the cost of each node expanded by the search kernels.
+	printf("\t\"search\": {\"searches\": %d, \"nodes\": %lld, \"lambda_ms\": %.3f, \"lambda_ns_per_node\": %.2f, \"function_ms\": %.3f, \"function_ns_per_node\": %.2f},\n",
+		settings->numSearches, searches->numNodes, searches->lambdaTime / 1000.0, searches->numNodes ? searches->lambdaTime * 1000.0 / searches->numNodes : 0.0,
+		searches->functionTime / 1000.0, searches->numNodes ? searches->functionTime * 1000.0 / searches->numNodes : 0.0);
+
+	// Prints the time spent in each zone. Work and idle are summed over every thread.
+	TurnProfile totals;
+	int histogram[PROFILE_HISTOGRAM_BUCKETS];
+	getProfileTotals(&totals);
+	printf("\t\"phases\": {\n");
+	for (int z = 0; z < NUM_PROFILE_ZONES; ++z) {
+		int count = getProfileHistogram(z, histogram);
+		printf("\t\t\"%s\": {\"count\": %d, \"wall_ms\": %.3f, \"mean_ms\": %.3f, \"work_ms\": %.3f, \"idle_ms\": %.3f, \"utilization\": %.3f}%s\n",
+			profileZoneNames[z], count, totals.wall[z] / 1000000.0, count ? totals.wall[z] / 1000000.0 / count : 0.0, totals.work[z] / 1000000.0,
+			totals.idle[z] / 1000000.0, totals.wall[z] ? (double)totals.work[z] / ((double)totals.wall[z] * numThreads) : 0.0, z + 1 < NUM_PROFILE_ZONES ? "," : "");
+
+	}
+	printf("\t}\n");
+	printf("}\n");
+
+}
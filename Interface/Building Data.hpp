@@ -51,6 +51,7 @@ void initBorealForest(HabitablePlanet* planet, Market* market, int owner, int xP
 	// Places the forest.
 	++planet->netGases[Oxygen];
 	--planet->netGases[Pollutants];
+	planet->updateActivity();
 	pBuilding(xPos, yPos, planet) = BorealForest;
 	++pOwnerBuildingQ(owner, LAND_OWNED, planet, 1);
 
@@ -58,6 +59,7 @@ void initBorealForest(HabitablePlanet* planet, Market* market, int owner, int xP
 void destroyBorealForest(HabitablePlanet* planet, Market* market, int owner, int xPos, int yPos, void* extraData) {
 	--planet->netGases[Oxygen];
 	++planet->netGases[Pollutants];
+	planet->updateActivity();
 	pBuilding(xPos, yPos, planet) = NoBuilding;
 	--pOwnerBuildingQ(owner, LAND_OWNED, planet, 1);
 
@@ -74,6 +76,7 @@ void initDeciduousForest(HabitablePlanet* planet, Market* market, int owner, int
 	// Places the forest.
 	++planet->netGases[Oxygen];
 	--planet->netGases[Pollutants];
+	planet->updateActivity();
 	pBuilding(xPos, yPos, planet) = DeciduousForest;
 	++pOwnerBuildingQ(owner, LAND_OWNED, planet, 1);
 
@@ -81,6 +84,7 @@ void initDeciduousForest(HabitablePlanet* planet, Market* market, int owner, int
 void destroyDeciduousForest(HabitablePlanet* planet, Market* market, int owner, int xPos, int yPos, void* extraData) {
 	--planet->netGases[Oxygen];
 	++planet->netGases[Pollutants];
+	planet->updateActivity();
 	pBuilding(xPos, yPos, planet) = NoBuilding;
 	--pOwnerBuildingQ(owner, LAND_OWNED, planet, 1);
 
@@ -97,6 +101,7 @@ void initTemperateForest(HabitablePlanet* planet, Market* market, int owner, int
 	// Places the forest.
 	++planet->netGases[Oxygen];
 	--planet->netGases[Pollutants];
+	planet->updateActivity();
 	pBuilding(xPos, yPos, planet) = TemperateForest;
 	++pOwnerBuildingQ(owner, LAND_OWNED, planet, 1);
 
@@ -104,6 +109,7 @@ void initTemperateForest(HabitablePlanet* planet, Market* market, int owner, int
 void destroyTemperateForest(HabitablePlanet* planet, Market* market, int owner, int xPos, int yPos, void* extraData) {
 	--planet->netGases[Oxygen];
 	++planet->netGases[Pollutants];
+	planet->updateActivity();
 	pBuilding(xPos, yPos, planet) = NoBuilding;
 	--pOwnerBuildingQ(owner, LAND_OWNED, planet, 1);
 
@@ -120,6 +126,7 @@ void initAridForest(HabitablePlanet* planet, Market* market, int owner, int xPos
 	// Places the forest.
 	++planet->netGases[Oxygen];
 	--planet->netGases[Pollutants];
+	planet->updateActivity();
 	pBuilding(xPos, yPos, planet) = AridForest;
 	++pOwnerBuildingQ(owner, LAND_OWNED, planet, 1);
 
@@ -127,6 +134,7 @@ void initAridForest(HabitablePlanet* planet, Market* market, int owner, int xPos
 void destroyAridForest(HabitablePlanet* planet, Market* market, int owner, int xPos, int yPos, void* extraData) {
 	--planet->netGases[Oxygen];
 	++planet->netGases[Pollutants];
+	planet->updateActivity();
 	pBuilding(xPos, yPos, planet) = NoBuilding;
 	--pOwnerBuildingQ(owner, LAND_OWNED, planet, 1);
 
@@ -143,6 +151,7 @@ void initTropicalForest(HabitablePlanet* planet, Market* market, int owner, int
 	// Places the forest.
 	++planet->netGases[Oxygen];
 	--planet->netGases[Pollutants];
+	planet->updateActivity();
 	pBuilding(xPos, yPos, planet) = TropicalForest;
 	++pOwnerBuildingQ(owner, LAND_OWNED, planet, 1);
 
@@ -150,6 +159,7 @@ void initTropicalForest(HabitablePlanet* planet, Market* market, int owner, int
 void destroyTropicalForest(HabitablePlanet* planet, Market* market, int owner, int xPos, int yPos, void* extraData) {
 	--planet->netGases[Oxygen];
 	++planet->netGases[Pollutants];
+	planet->updateActivity();
 	pBuilding(xPos, yPos, planet) = NoBuilding;
 	--pOwnerBuildingQ(owner, LAND_OWNED, planet, 1);
 
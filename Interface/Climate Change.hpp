@@ -1,31 +1,30 @@
 #pragma once
 
+// Number of climatePlanets given to each atmosphereChange task.
+#define CLIMATE_GRAIN 256
+
 /*
-Manages atmosphere change for a page of planets.
+Manages atmosphere change for a range of the climatePlanets.
 */
-void atmosphereChange() {
-	int page = requestHabitablePage();
-
-	// Returns if there is no available page.
-	if (page < 0) return;
+void atmosphereChange(int beg, int end) {
+	HabitablePlanet* planet;
 
 	// Updates the gases for each planet.
-	for (int i = 0; i < habitablePages[page]->arrCurrPlanet; ++i) {
-		for (int j = 0; j < NUM_GASES; ++j) {
-			habitablePages[page]->planets[i].gases[j] += habitablePages[page]->planets[i].netGases[j] / 256;
+	for (int i = beg; i < end; ++i) {
+		planet = climatePlanets.planets[i];
+		for (int j = 0; j < NUM_GASES; ++j) planet->gases[j] += planet->netGases[j] / 256;
 
-		}
 	}
-
-	// Continues until there are no remaining HabitablePages.
-	atmosphereChange();
-
 }
 
 /*
-Manages climate change for each planet.
+Manages climate change for each planet. Only the climatePlanets are visited, since the gases of every
+other planet are at a steady state. They are spread over all threads in runs of CLIMATE_GRAIN.
 */
 void climateChange() {
-	atmosphereChange();
+	ProfileScope scope(CLIMATE_ZONE);
+	parallelFor(0, climatePlanets.numPlanets, CLIMATE_GRAIN, [](int beg, int end) {
+		atmosphereChange(beg, end);
 
-}
\ No newline at end of file
+	});
+}
@@ -135,91 +135,23 @@ void Market::removeColony(Colony* colony) {
 	}
 }
 
-// Number of elements in a ColonyPage. Should be around 1MB.
-#define COLONY_PAGE_SIZE ((1048576 - 8) / sizeof(Colony))
-
-// Default number of Colony pages. This is also the number used when expanding the roster of
-// Colony pages.
-#define NUM_COLONY_PAGES 256
-
-// Page of Colonies.
-struct ColonyPage {
-	Colony colonies[COLONY_PAGE_SIZE];
-	uint16_t arrCurrColony;
-	uint16_t numOpen;
-	bool active;
-
-	// 3 bytes of padding?
-
-};
-
-// Contains all ColonyPages. Minimizes memory use from allocations.
-int numColonyPages;
-ColonyPage** colonyPages;
+// Contains all Colonies. Minimizes memory use from allocations.
+PagedPool<Colony> colonyPool;
 
 /*
-Creates a paging table of Colonies. Initialized with capacity for numColonies.
+Creates colonyPool. Initialized with capacity for numColonies.
 It is expected that this function will be called exactly once per universe and in a single-threaded manner.
 */
 void initColonies(int numColonies) {
-
-	// Frees colonyPages for reuse.
-	if (numColonyPages) {
-		for (int i = 0; i < numColonyPages; ++i) {
-			if (colonyPages[i]) delete colonyPages[i];
-			colonyPages[i] = nullptr;
-
-		}
-		free(colonyPages);
-
-	}
-
-	// Initializes colonyPages.
-	numColonyPages = numColonies / COLONY_PAGE_SIZE + 1;
-	colonyPages = (ColonyPage**)calloc(numColonyPages + NUM_COLONY_PAGES - (numColonyPages % NUM_COLONY_PAGES), sizeof(ColonyPage*));
-	for (int i = 0; i < numColonyPages; ++i) colonyPages[i] = (ColonyPage*)calloc(1, sizeof(ColonyPage));
+	colonyPool.init(numColonies);
 
 }
 
 /*
-Places a Colony. Generates a new ColonyPage if there are none available.
-Resizes colonyPages in increments of 256 when the object pool is insufficiently large.
+Places a Colony.
 */
 Colony* placeColony() {
-	static std::shared_mutex placeColonyMutex;
-
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex > lock(placeColonyMutex);
-
-	// Attempts to place the colony within one of the current pages.
-	Colony* colony = nullptr;
-	for (int page = 0; page < numColonyPages; ++page) {
-		if (colonyPages[page]->arrCurrColony < COLONY_PAGE_SIZE) {
-			colony = &colonyPages[page]->colonies[colonyPages[page]->arrCurrColony];
-			++colonyPages[page]->arrCurrColony;
-			break;
-
-		}
-	}
-
-	// If placement failed, creates a new page and places the colony there.
-	if (colony == nullptr) {
-
-		// If the page table is not large enough, reallocates it.
-		if (!(numColonyPages + 1 % NUM_COLONY_PAGES))
-			colonyPages = (ColonyPage**)realloc(colonyPages, (numColonyPages + NUM_COLONY_PAGES) * sizeof(ColonyPage*));
-
-		// Creates a new ColonyPage.
-		colonyPages[numColonyPages] = (ColonyPage*)calloc(1, sizeof(ColonyPage));
-
-		// Places the colony in the first index of the new page.
-		colony = &(colonyPages[numColonyPages]->colonies[0]);
-		++colonyPages[numColonyPages]->arrCurrColony;
-
-		// Moves on to the next page.
-		++numColonyPages;
-
-	}
+	Colony* colony = colonyPool.allocate();
 
 	// Initializes the Colony.
 	colony->threats = std::vector<Threat>();
@@ -231,91 +163,11 @@ Colony* placeColony() {
 }
 
 /*
-Requests a ColonyPage. Returns the index of the next available page in colonyPages, otherwise -1.
-TODO if infrastructure permits it, use a static global to increment through colony pages.
-*/
-int requestColonyPage() {
-	static std::shared_mutex requestColonyPageMutex;
-
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex> lock(requestColonyPageMutex);
-
-	// Parses through each galaxy and returns the next available one.
-	for (int i = 0; i < numColonyPages; ++i) {
-		if (!colonyPages[i]->active) {
-			colonyPages[i]->active = true;
-			return i;
-
-		}
-	}
-
-	// Returns -1 if no ColonyPage was found.
-	return -1;
-
-}
-
-/*
-Returns a ColonyPage.
-*/
-void releaseColonyPage(int index) {
-	colonyPages[index]->active = false;
-
-}
-
-// Returns all ColonyPages.
-void releaseAllColonyPages() {
-	for (int i = 0; i < numColonyPages; ++i) colonyPages[i]->active = false;
-
-}
-
-/*
-Searches through the entire paging table in order to find a Given colony.
+Searches through every live Colony in order to find a given colony.
 Return the desired Colony if it is found, else nullptr.
 */
 Colony* searchColonyTable(std::function<bool(Colony*)> search) {
-
-	// Searches through the paging table.
-	for (int page = 0; page < numColonyPages; ++page) {
-		for (int col = 0; col < colonyPages[page]->arrCurrColony; ++col) {
-
-			// Returns the desired Colony if it is found.
-			if (search(&colonyPages[page]->colonies[colonyPages[page]->arrCurrColony])) {
-				return &colonyPages[page]->colonies[colonyPages[page]->arrCurrColony];
-
-			}
-		}
-	}
-
-	// Returns nullptr if the desired Colony is not found.
-	return nullptr;
-
-}
-
-/*
-Finds the page of a given Colony within the paging table.
-*/
-inline void findColonyPage(int& page, Colony* colony) {
-
-	// Finds the page.
-	for (page = 0; page < numColonyPages; ++page) {
-
-		// Returns the value if the Colony is within bounds.
-		if ((char*)colony >= (char*)colonyPages[page] &&
-			(char*)colony < (char*)colonyPages[page] + sizeof(ColonyPage)) {
-			return;
-
-		}
-	}
-}
-
-/*
-Finds the page and index of a given Colony within the paging table.
-*/
-inline void findColonyIndex(int& page, int& index, Colony* colony) {
-
-	// Finds the page.
-	findColonyPage(page, colony);
-	index = ((char*)colony - (char*)colonyPages[page]) / sizeof(Colony);
+	return colonyPool.search(search);
 
 }
 
@@ -323,22 +175,14 @@ inline void findColonyIndex(int& page, int& index, Colony* colony) {
 Marks a Colony as being available for reuse.
 */
 inline void freeColony(Colony* colony) {
-	int page;
-
-	// Marks that there is a free Colony in the page.
-	findColonyPage(page, colony);
-	++colonyPages[page]->numOpen;
 
 	// Clears the Colony.
 	colony->~Colony();
 
-}
+	// Returns the Colony to the pool.
+	colonyPool.free(colony);
 
-// Undefines variables which are used only for initializing Colonies.
-#undef NUM_COLONY_PAGES
-#undef ColonyPage
-#undef numColonyPages
-#undef colonyPages
+}
 
 /*
 Deconstructs the Colony.
@@ -356,6 +200,7 @@ Colony::~Colony() {
 	// Clears the Colony's owner.
 	// TODO manage colony changing hands more specifically, i.e. manage corporations.
 	memset(&planet->owners[governmentOwner], 0, sizeof(planet->owners[governmentOwner]));
+	planet->updateActivity();
 
 	// Deletes this Colony's pops.
 	delete pops;
@@ -466,8 +311,9 @@ void Colony::findLand() {
 	int xPos, yPos;
 	int n;
 
-	// Acquires a dummy.
-	Coord* expansions = (Coord*)requestLargeDummy();
+	// Allocates scratch space for the expansions.
+	ScratchScope scratch;
+	Coord* expansions = scratch.array<Coord>(planet->size * planet->size);
 
 	// Resets landTarget.
 	landTarget = 0;
@@ -538,9 +384,6 @@ void Colony::findLand() {
 		}
 	}
 
-	// Releases the dummy.
-	releaseLargeDummy((uint_least8_t*)expansions);
-
 }
 
 /*
@@ -585,8 +428,9 @@ void Colony::findWater() {
 	int xPos, yPos;
 	int n;
 
-	// Acquires a dummy.
-	Coord* expansions = (Coord*)requestLargeDummy();
+	// Allocates scratch space for the expansions.
+	ScratchScope scratch;
+	Coord* expansions = scratch.array<Coord>(planet->size * planet->size);
 
 	// Resets waterTarget.
 	waterTarget = 0;
@@ -658,9 +502,6 @@ void Colony::findWater() {
 		}
 	}
 
-	// Releases the dummy.
-	releaseLargeDummy((uint_least8_t*)expansions);
-
 }
 
 /*
@@ -88,122 +88,23 @@ void initMarkets(int numMarkets);
 // Returns the next available market.
 Market* placeMarket();
 
-// Number of elements in a MarketPage. Should be around 1MB.
-#define MARKET_PAGE_SIZE ((1048576 - 8) / sizeof(Market))
-
-// Default number of Market pages. This is also the number used when expanding the roster of
-// Market pages.
-#define NUM_MARKET_PAGES 256
-
-// Page of Markets.
-struct MarketPage {
-	Market markets[MARKET_PAGE_SIZE];
-	uint16_t arrCurrMarket;
-	uint16_t numOpen;
-	bool active;
-
-	// 3 bytes of padding?.
-
-};
-
-// Contains all MarketPages. Minimizes memory use from allocations.
-int numMarketPages;
-MarketPage** marketPages;
+// Contains all Markets. Minimizes memory use from allocations.
+PagedPool<Market> marketPool;
 
 /*
-Creates a paging table of Markets. Initialized with capacity for numMarkets.
+Creates marketPool. Initialized with capacity for numMarkets.
 It is expected that this function will be called exactly once per universe and in a single-threaded manner.
 */
 void initMarkets(int numMarkets) {
-
-	// Frees marketPages for reuse.
-	if (numMarketPages) {
-		for (int i = 0; i < numMarketPages; ++i) {
-			if (marketPages[i]) delete marketPages[i];
-			marketPages[i] = nullptr;
-
-		}
-		delete[] marketPages;
-
-	}
-
-	// Initializes marketPages.
-	numMarketPages = numMarkets / MARKET_PAGE_SIZE + 1;
-	marketPages = (MarketPage**)calloc(numMarketPages + NUM_MARKET_PAGES - (numMarketPages % NUM_MARKET_PAGES), sizeof(MarketPage*));
-	for (int i = 0; i < numMarketPages; ++i) marketPages[i] = (MarketPage*)calloc(1, sizeof(MarketPage));
+	marketPool.init(numMarkets);
 
 }
 
 /*
-Places a Market. Generates a new MarketPage if there are none available.
-Resizes marketPages in increments of 256 when the object pool is insufficiently large.
+Places a Market.
 */
 Market* placeMarket() {
-	static std::shared_mutex placeMarketMutex;
-
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex> lock(placeMarketMutex);
-
-	// Attempts to place the Market within one of the current pages.
-	Market* market = nullptr;
-	for (int page = 0; page < numMarketPages; ++page) {
-		if (marketPages[page]->arrCurrMarket < MARKET_PAGE_SIZE) {
-			market = &marketPages[page]->markets[marketPages[page]->arrCurrMarket];
-			++marketPages[page]->arrCurrMarket;
-			break;
-
-		}
-	}
-
-	// If placement failed, creates a new MarketPage and places the Market there.
-	if (market == nullptr) {
-
-		// If the page table is not large enough, reallocates it.
-		if (!(numMarketPages + 1 % NUM_MARKET_PAGES))
-			marketPages = (MarketPage**)realloc(marketPages, (numMarketPages + NUM_MARKET_PAGES) * sizeof(MarketPage*));
-
-		// Creates a new MarketPage.
-		marketPages[numMarketPages] = (MarketPage*)calloc(1, sizeof(MarketPage));
-
-		// Places the Market in the first index of the new page.
-		market = &(marketPages[numMarketPages]->markets[0]);
-		++marketPages[numMarketPages]->arrCurrMarket;
-
-		// Moves on to the next page.
-		++numMarketPages;
-
-	}
-
-	// Returns a pointer to the Market.
-	return market;
-
-}
-
-/*
-Finds the page of a given Market within the paging table.
-*/
-inline void findMarketPage(int& page, Market* market) {
-
-	// Finds the page.
-	for (page = 0; page < numMarketPages; ++page) {
-
-		// Returns the value if the Market is within bounds.
-		if ((char*)market >= (char*)marketPages[page] &&
-			(char*)market < (char*)marketPages[page] + sizeof(MarketPage)) {
-			return;
-
-		}
-	}
-}
-
-/*
-Finds the page and index of a given Market within the paging table.
-*/
-inline void findMarketIndex(int& page, int& index, Market* market) {
-
-	// Finds the page.
-	findMarketPage(page, market);
-	index = ((char*)market - (char*)marketPages[page]) / sizeof(Market);
+	return marketPool.allocate();
 
 }
 
@@ -211,15 +112,13 @@ inline void findMarketIndex(int& page, int& index, Market* market) {
 Marks a Market as being available for reuse.
 */
 inline void freeMarket(Market* market) {
-	int page;
-
-	// Marks that there is a free Market in the page.
-	findMarketPage(page, market);
-	++marketPages[page]->numOpen;
 
 	// Clears the Market.
 	market->~Market();
 
+	// Returns the Market to the pool.
+	marketPool.free(market);
+
 }
 
 /*
@@ -1,7 +1,14 @@
 #pragma once
 
-// Macro for accessing a universe tile.
-#define uIndex(x, y) universe[index(x, y, universeWidth)]
+// Macros for reading the fields of a universe tile. Each field is stored in its own
+// array within the tile's UniverseBlock (see Galaxy Tiles.hpp). In a sparse universe,
+// writes must go through UniverseGrid::touch.
+#define uTileID(x, y) universe.block(x, y)->tileIDs[UniverseGrid::offset(x, y)]
+#define uClosureID(x, y) universe.block(x, y)->closures[UniverseGrid::offset(x, y)]
+#define uNumSquadrons(x, y) universe.block(x, y)->numSquadrons[UniverseGrid::offset(x, y)]
+
+// Macro for accessing the summary of the chunk containing a universe tile.
+#define uChunk(x, y) universe.chunks[universe.chunkOf(x, y)]
 
 // Macros for and unlocking universe tiles.
 // y is a parameter for extensibility.
@@ -10,29 +17,26 @@
 #define uTryLock(x, y) universeMutexes[x].try_lock()
 
 // Macro for accessing a closure.
-#define indexClosure(closure) closurePages[closure / CLOSURE_PAGE_SIZE]->closures[closure % CLOSURE_PAGE_SIZE]
-#define indexClosurePage(closure) closurePages[closure / CLOSURE_PAGE_SIZE]
+#define indexClosure(closure) (*closurePool.at(closure))
+#define indexClosurePage(closure) closurePool.pages[(closure) / CLOSURE_PAGE_SIZE]
 
 // Macro for accessing a universe tile's closure.
-#define uClosure(x, y) indexClosure(uIndex(x, y).closure)
+#define uClosure(x, y) indexClosure(uClosureID(x, y))
 
 // Macro for accessing a universe tile's controller.
 #define uController(x, y) uClosure(x, y).owner
 
-// Macro for accessing a universe tile's de-jure owner.
-#define uOwner(x, y) uIndex(x, y).owner
-
 // Macro for accessing a universe tile's system.
-#define uSystem(x, y) (universe[index(x, y, universeWidth)].system)
+#define uSystem(x, y) (universe.block(x, y)->systems[UniverseGrid::offset(x, y)])
 
 // Macro for accessing a universe tile's squadron.
-#define uSquadron(x, y, squadron) universe[index(x, y, universeWidth)].squadrons[squadron]
+#define uSquadron(x, y, squadron) universe.block(x, y)->squadrons[UniverseGrid::offset(x, y)][squadron]
 
 // Macro for accessing a universe tile's sensor cost.
-#define uSensorCost(x, y) uIndex(x, y).sensorCost()
+#define uSensorCost(x, y) universeSensorDifficulty[uTileID(x, y)]
 
 // Macro for accessing a universe tile's movement cost.
-#define uMovementCost(x, y) uIndex(x, y).movementCost()
+#define uMovementCost(x, y) universeMovementCost[uTileID(x, y)]
 
 // Macro for accessing a planet tile.
 #define pIndex(x, y, plan) plan->planet[index(x, y, plan->size)]
@@ -24,6 +24,9 @@ inline int estimateNumGovernments(Galaxy* galaxies, GalaxyInstruction* instrs, i
 // Generates appropriate RaceTemplates for an empire.
 void generateRaces(Colony* colony);
 
+// Counts the systems within a Galaxy.
+int countGalaxySystems(const Galaxy* galaxy);
+
 /*
 Generates empires within each galaxy.
 
@@ -32,9 +35,17 @@ is recursive and can cover all galaxies with a single thread, a single thread ca
 */
 void generateEmpiresUniverse(Galaxy* galaxies, GalaxyInstruction* instrs, int numGalaxies) {
 
-	// TODO DEBUG REMOVE
-	// Places colonies in all systems.
-	for (int i = 0; i < numGalaxies; ++i) instrs[i].empireChance = 1001;
+	// Converts numEmpires into an empireChance for each Galaxy which requests a number of empires.
+	// Galaxies which request no empires get an empireChance of 1001, which places a colony in every system.
+	for (int i = 0; i < numGalaxies; ++i) {
+		if (instrs[i].numEmpires > 0) {
+			int numSystems = countGalaxySystems(&galaxies[i]);
+			instrs[i].empireChance = numSystems ? (instrs[i].numEmpires * 1000 + numSystems - 1) / numSystems : 0;
+
+		}
+		else instrs[i].empireChance = 1001;
+
+	}
 
 	// Allocates Markets.
 	initMarkets(estimateNumMarkets(galaxies, instrs, numGalaxies));
@@ -53,11 +64,13 @@ void generateEmpiresUniverse(Galaxy* galaxies, GalaxyInstruction* instrs, int nu
 	initClosures(estGovernments);
 
 	// Generates empires in a multi threaded manner.
-	for (int i = 0; i < numThreads - 1 && i < numGalaxies - 1; ++i) threads[demandThread()] = new std::thread(generateEmpiresUniverseThreaded, galaxies, instrs, numGalaxies);
+	TaskGroup group;
+	for (int i = 0; i < numThreads - 1 && i < numGalaxies - 1; ++i)
+		group.run([galaxies, instrs, numGalaxies] { generateEmpiresUniverseThreaded(galaxies, instrs, numGalaxies); });
 	generateEmpiresUniverseThreaded(galaxies, instrs, numGalaxies);
 
-	// Joins all threads.
-	joinAllThreads();
+	// Waits for all Tasks to finish.
+	group.wait();
 
 	// Reclaims the galaxies.
 	releaseAllGalaxies();
@@ -66,7 +79,7 @@ void generateEmpiresUniverse(Galaxy* galaxies, GalaxyInstruction* instrs, int nu
 	int numInhabited = 0;
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				System* tile = uSystem(i, j);
 				for (int p = 0; p < tile->numHabitable; ++p) {
 					if (tile->planets[p]->owners[1].colony) ++numInhabited;
@@ -75,7 +88,7 @@ void generateEmpiresUniverse(Galaxy* galaxies, GalaxyInstruction* instrs, int nu
 			}
 		}
 	}
-	printf("numInhabited : %d\n", numInhabited);
+	fprintf(stderr, "numInhabited : %d\n", numInhabited);
 
 }
 
@@ -86,10 +99,13 @@ This function will be completed even if only one thread is used for it.
 */
 void generateEmpiresUniverseThreaded(Galaxy* galaxies, GalaxyInstruction* instrs, int numGalaxies) {
 
-	// If there is an available galaxy, generates empires within it.
-	for (int galaxy = requestGalaxy(); galaxy >= 0; galaxy = requestGalaxy())
+	// If there is an available galaxy, generates empires within it using the galaxy's own stream.
+	for (int galaxy = requestGalaxy(); galaxy >= 0; galaxy = requestGalaxy()) {
+		seedRandomStream(randomStream(EMPIRE_STREAM, galaxy, 0));
 		generateEmpiresGalaxy(&galaxies[galaxy], &instrs[galaxy]);
 
+	}
+
 }
 
 /*
@@ -157,6 +173,7 @@ void generateInitialColony(HabitablePlanet* planet, Government* government) {
 	// Creates an owner corresponding to the planet's Government.
 	planet->owners[owner].owner = government;
 	planet->owners[owner].colony = colony;
+	planet->updateActivity();
 
 }
 
@@ -360,7 +377,7 @@ void generateEmpiresGalaxy(const Galaxy* galaxy, const GalaxyInstruction* instr)
 	// Generates empires on appropriate planets.
 	for (int i = galaxy->area.x; i < galaxy->area.x + galaxy->area.w; ++i) {
 		for (int j = galaxy->area.y; j < galaxy->area.y + galaxy->area.h; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE && randB(10) % 1000 < instr->empireChance) {
+			if (uTileID(i, j) == SYSTEM_TILE && randB(10) % 1000 < instr->empireChance) {
 				system = uSystem(i, j);
 
 				// Chooses a planet to place the race on.
@@ -416,13 +433,7 @@ inline int estimateNumRaces(Galaxy* galaxies, GalaxyInstruction* instrs, int num
 
 	// For each galaxy, estimates the needed number of races.
 	for (int gal = 0; gal < numGalaxies; ++gal) {
-		numSystems = 0;
-		for (int w = galaxies[gal].area.x; w < galaxies[gal].area.x + galaxies[gal].area.w; ++w) {
-			for (int h = galaxies[gal].area.y; h < galaxies[gal].area.y + galaxies[gal].area.h; ++h) {
-				if (uIndex(w, h).tileID == SYSTEM_TILE) ++numSystems;
-
-			}
-		}
+		numSystems = countGalaxySystems(&galaxies[gal]);
 
 		// Estimates the needed number of races for each galaxy.
 		numRaces += ((numSystems * instrs[gal].empireChance) / 1000) * racesPerEmpire + 20;
@@ -497,4 +508,23 @@ void generateRaces(Colony* colony) {
 	// Places 200 pops of the generated race into the colony.
 	colony->newPops(race, 200);
 
+}
+
+/*
+Counts the systems within the inputed Galaxy's area. Chunks without systems are skipped.
+*/
+int countGalaxySystems(const Galaxy* galaxy) {
+	int numSystems = 0;
+
+	// Counts SYSTEM_TILEs in chunks which have any.
+	forUniverseWindow(galaxy->area.x, galaxy->area.y, galaxy->area.x + galaxy->area.w, galaxy->area.y + galaxy->area.h,
+		[](UniverseChunk& chunk)->bool { return chunk.numSystems > 0; },
+		[&numSystems](int x, int y)->bool {
+			if (uTileID(x, y) == SYSTEM_TILE) ++numSystems;
+			return true;
+
+		}
+	);
+	return numSystems;
+
 }
\ No newline at end of file
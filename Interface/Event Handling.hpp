@@ -35,12 +35,13 @@ Begins tracking a Squadron that threatens this Colony.
 TODO calculate time.
 */
 inline void Colony::addThreat(Squadron* squadron) {
+	SquadronHandle handle = squadron->handle;
 	Threat threat;
 
 	// Adds the Threat if it is not redundant.
 	if (std::find_if(threats.begin(), threats.end(),
-		[squadron](Threat threat) { return threat.squadron == squadron; }) == threats.end()) {
-		threat = { squadron, {0, 0}, 1, squadron->strength };
+		[handle](Threat threat) { return threat.squadron == handle; }) == threats.end()) {
+		threat = { handle, {0, 0}, 1, squadron->strength };
 		addThreat(threat);
 
 	}
@@ -50,7 +51,11 @@ inline void Colony::addThreat(Squadron* squadron) {
 Stops tracking a Threat to this Colony.
 */
 inline void Colony::removeThreat(Threat threat) {
-	removeThreat(threat.squadron);
+	SquadronHandle handle = threat.squadron;
+	if (!threats.size()) return;
+	threats.erase(std::remove_if(threats.begin(), threats.end(),
+		[handle](const Threat& threat) { return threat.squadron == handle; }),
+		threats.end());
 
 }
 
@@ -58,10 +63,8 @@ inline void Colony::removeThreat(Threat threat) {
 Stops tracking a Squadron that threatens this Colony.
 */
 inline void Colony::removeThreat(Squadron* squadron) {
-	if (!threats.size()) return;
-	threats.erase(std::remove_if(threats.begin(), threats.end(),
-		[squadron](const Threat& threat) { return threat.squadron == squadron; }),
-		threats.end());
+	Threat threat = { squadron->handle };
+	removeThreat(threat);
 
 }
 
@@ -74,10 +77,12 @@ inline void Colony::handleThreats() {
 	// Tracks the threats.
 	for (Threat& threat : threats) trackThreat(threat);
 
-	// Removes threats from tracking if they are finished.
-	threats.erase(std::remove_if(threats.begin(), threats.end(),
-		[](const Threat& threat) { return !threat.squadron || !threat.squadron->strength; }),
-		threats.end());
+	// Removes threats from tracking if they are finished, or if their Squadron has been destroyed.
+	threats.erase(std::remove_if(threats.begin(), threats.end(), [](const Threat& threat) {
+		Squadron* squadron = squadronStore.get(threat.squadron);
+		return !squadron || !squadron->strength;
+
+	}), threats.end());
 
 }
 
@@ -95,12 +100,13 @@ Begins tracking a Squadron that threatens this Squadron.
 TODO calculate time.
 */
 inline void Squadron::addThreat(Squadron* squadron) {
+	SquadronHandle handle = squadron->handle;
 	Threat threat;
 
 	// Adds the Threat if it is not redundant.
 	if (std::find_if(threats.begin(), threats.end(),
-		[squadron](Threat threat) { return threat.squadron == squadron; }) == threats.end()) {
-		threat = { squadron, {0, 0}, 1, squadron->strength };
+		[handle](Threat threat) { return threat.squadron == handle; }) == threats.end()) {
+		threat = { handle, {0, 0}, 1, squadron->strength };
 		addThreat(threat);
 
 	}
@@ -110,7 +116,11 @@ inline void Squadron::addThreat(Squadron* squadron) {
 Stops tracking a Threat to this Squadron.
 */
 inline void Squadron::removeThreat(Threat threat) {
-	removeThreat(threat.squadron);
+	SquadronHandle handle = threat.squadron;
+	if (!threats.size()) return;
+	threats.erase(std::remove_if(threats.begin(), threats.end(),
+		[handle](const Threat& threat) { return threat.squadron == handle; }),
+		threats.end());
 
 }
 
@@ -118,10 +128,8 @@ inline void Squadron::removeThreat(Threat threat) {
 Stops tracking a Squadron that threatens this Squadron.
 */
 inline void Squadron::removeThreat(Squadron* squadron) {
-	if (!threats.size()) return;
-	threats.erase(std::remove_if(threats.begin(), threats.end(),
-		[squadron](const Threat& threat) { return threat.squadron == squadron; }),
-		threats.end());
+	Threat threat = { squadron->handle };
+	removeThreat(threat);
 
 }
 
@@ -134,10 +142,12 @@ inline void Squadron::handleThreats() {
 	// Tracks the threats.
 	for (Threat& threat : threats) trackThreat(threat);
 
-	// Removes threats from tracking if they are finished.
-	threats.erase(std::remove_if(threats.begin(), threats.end(),
-		[](const Threat& threat) { return !threat.squadron || !threat.squadron->strength; }),
-		threats.end());
+	// Removes threats from tracking if they are finished, or if their Squadron has been destroyed.
+	threats.erase(std::remove_if(threats.begin(), threats.end(), [](const Threat& threat) {
+		Squadron* squadron = squadronStore.get(threat.squadron);
+		return !squadron || !squadron->strength;
+
+	}), threats.end());
 
 }
 
@@ -154,8 +164,16 @@ TODO enemy flight speed, nation flight speed, and communication should be
 	factored into replacing tempTime/tempRange
 */
 void Squadron::trackThreat(Threat& threat) {
-	int distance = calcTaxiDistance(loc.x, loc.y,
-		threat.squadron->loc.x, threat.squadron->loc.y);
+	Squadron* squadron = squadronStore.get(threat.squadron);
+	int distance;
+
+	// Stops tracking the threat if its Squadron has been destroyed.
+	if (!squadron) {
+		threat.squadron = 0;
+		return;
+
+	}
+	distance = calcTaxiDistance(loc.x, loc.y, squadron->loc.x, squadron->loc.y);
 
 	// TODO tempTime is temporarily the time taken to discover the squadron.
 	const int tempTime = 5;
@@ -164,10 +182,10 @@ void Squadron::trackThreat(Threat& threat) {
 	const int tempRange = 8;
 
 	// Reveals the Squadron if it is within scanning distance.
-	if (scan(threat.squadron->loc, distance)) {
+	if (scan(squadron->loc, distance)) {
 		threat.time = 0;
-		threat.coord = threat.squadron->loc;
-		threat.strength = threat.squadron->strength;
+		threat.coord = squadron->loc;
+		threat.strength = squadron->strength;
 
 	}
 	// Counts down time if the Squadron's current location has not yet been revealed.
@@ -178,17 +196,17 @@ void Squadron::trackThreat(Threat& threat) {
 		if (!threat.time) {
 
 			// Reveals the location and strength of the threat.
-			threat.coord = threat.squadron->loc;
-			threat.strength = threat.squadron->strength;
+			threat.coord = squadron->loc;
+			threat.strength = squadron->strength;
 
 			// Marks the threat for removal from tracking if it has moved
 			// outside of tracking range.
-			if (distance > tempRange) threat.squadron = nullptr;
+			if (distance > tempRange) threat.squadron = 0;
 
 		}
 	}
 	// Increases time if the Squadron has been discovered and has since moved.
-	else if (threat.coord.x != threat.squadron->loc.x || threat.coord.y != threat.squadron->loc.y) threat.time = tempTime;
+	else if (threat.coord.x != squadron->loc.x || threat.coord.y != squadron->loc.y) threat.time = tempTime;
 
 }
 
@@ -200,8 +218,16 @@ TODO enemy flight speed, nation flight speed, and communication should be
 	factored into replacing tempTime/tempRange
 */
 void Colony::trackThreat(Threat& threat) {
-	int distance = calcTaxiDistance(loc().x, loc().y,
-		threat.squadron->loc.x, threat.squadron->loc.y);
+	Squadron* squadron = squadronStore.get(threat.squadron);
+	int distance;
+
+	// Stops tracking the threat if its Squadron has been destroyed.
+	if (!squadron) {
+		threat.squadron = 0;
+		return;
+
+	}
+	distance = calcTaxiDistance(loc().x, loc().y, squadron->loc.x, squadron->loc.y);
 
 	// TODO tempTime is temporarily the time taken to discover the squadron.
 	const int tempTime = 5;
@@ -210,10 +236,10 @@ void Colony::trackThreat(Threat& threat) {
 	const int tempRange = 8;
 
 	// Reveals the Squadron if it is within scanning distance.
-	if (scan(threat.squadron->loc, distance)) {
+	if (scan(squadron->loc, distance)) {
 		threat.time = 0;
-		threat.coord = threat.squadron->loc;
-		threat.strength = threat.squadron->strength;
+		threat.coord = squadron->loc;
+		threat.strength = squadron->strength;
 
 	}
 	// Counts down time if the Squadron's current location has not yet been revealed.
@@ -224,16 +250,16 @@ void Colony::trackThreat(Threat& threat) {
 		if (!threat.time) {
 
 			// Reveals the location and strength of the threat.
-			threat.coord = threat.squadron->loc;
-			threat.strength = threat.squadron->strength;
+			threat.coord = squadron->loc;
+			threat.strength = squadron->strength;
 
 			// Marks the threat for removal from tracking if it has moved
 			// outside of tracking range.
-			if (distance > tempRange) threat.squadron = nullptr;
+			if (distance > tempRange) threat.squadron = 0;
 
 		}
 	}
 	// Increases time if the Squadron has been discovered and has since moved.
-	else if (threat.coord.x != threat.squadron->loc.x || threat.coord.y != threat.squadron->loc.y) threat.time = tempTime;
+	else if (threat.coord.x != squadron->loc.x || threat.coord.y != squadron->loc.y) threat.time = tempTime;
 
 }
\ No newline at end of file
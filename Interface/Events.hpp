@@ -50,16 +50,20 @@ enum GovernmentEvents {
 // Lets the compiler know about the Colony Event handler.
 extern void (*colonyEventHandler[])(Event& event, Colony* colony);
 
+// Handle to a Squadron within the SquadronStore (see Space Combat.hpp). Handles to destroyed
+// Squadrons resolve to nullptr. 0 is never a valid handle.
+typedef uint_least32_t SquadronHandle;
+
 /*
 Contains a threat for tracking.
 
-14 bytes, 2 bytes padding.
-sizeof is 16 bytes.
+12 bytes, 0 bytes padding.
+sizeof is 12 bytes.
 */
 struct Threat {
 
 	// Squadron being tracked.
-	Squadron* squadron; // 8 bytes.
+	SquadronHandle squadron; // 4 bytes.
 
 	// Last known location of the Squadron.
 	CoordU coord; // 4 bytes.
@@ -407,9 +407,169 @@ inline void wrapAroundPlanet(int size, int* xPos, int* yPos) {
 
 }
 
+// Number of tiles adjacent to a planet tile.
+#define PLANET_NEIGHBOURS 8
+
+/*
+Position within a PlanetGrid. Stores the planet tile which that position refers to.
+*/
+struct PlanetCell {
+
+	// Index of the tile, as given by index(x, y, size).
+	uint_least16_t tile;
+
+	// Coordinates of the tile. Planets are at most MAX_PLANET_WIDTH wide.
+	uint_least8_t x;
+	uint_least8_t y;
+
+};
+
+/*
+Padded grid shared by every planet of a given width. The grid surrounds the planet with a one
+tile ghost border, each position of which refers to the tile that wrapAroundPlanet wraps it to.
+Adjacent tiles are then found by adding a fixed offset to a padded index, with no wrapping.
+
+The ghost border stores where each position leads rather than a copy of the tile, so it never
+needs to be refreshed when planet tiles or battlefields are written to.
+*/
+struct PlanetGrid {
+
+	// Width of the planet.
+	int size;
+
+	// Width of the padded grid.
+	int stride;
+
+	// Tile referred to by each padded position.
+	PlanetCell* cells;
+
+	// Tiles to which each tile is adjacent, PLANET_NEIGHBOURS per tile, indexed by tile. Wrapping over
+	// the poles is not symmetric on planets of odd width, so near the poles these may differ from
+	// the tiles adjacent to a tile.
+	PlanetCell* incoming;
+
+	// Offsets of the adjacent tiles, in the order of a 3x3 loop over x and then y.
+	int adjacent[PLANET_NEIGHBOURS];
+
+	// Offsets of the tiles within a 3x3 area, including the centre, in the same order.
+	int around[PLANET_NEIGHBOURS + 1];
+
+	// Offsets of the adjacent tiles in the order northwest, north, northeast, east, west,
+	// southeast, south, southwest. This matches planetDirections.
+	int directions[PLANET_NEIGHBOURS];
+
+	// Returns the padded index of a tile.
+	inline int pad(int x, int y) { return (x + 1) * stride + y + 1; }
+
+	// Returns the tile offset from a padded index.
+	inline PlanetCell& cell(int padded, int offset) { return cells[padded + offset]; }
+
+};
+
+// Directions matching PlanetGrid::directions.
+Dir planetDirections[PLANET_NEIGHBOURS] = { northwest, north, northeast, east, west, southeast, south, southwest };
+
+// Grid of each planet width. Grids are created the first time a width is used.
+std::atomic<PlanetGrid*> planetGrids[MAX_PLANET_WIDTH + 1];
+
+// Guards the creation of grids.
+std::mutex planetGridMutex;
+
+/*
+Creates the padded grid of a planet width.
+*/
+PlanetGrid* createPlanetGrid(int size) {
+	PlanetGrid* grid = (PlanetGrid*)malloc(sizeof(PlanetGrid));
+	int xPos, yPos;
+	int currAdjacent = 0, currAround = 0;
+	int* numIncoming;
+
+	// Wraps every padded position onto the planet.
+	grid->size = size;
+	grid->stride = size + 2;
+	grid->cells = (PlanetCell*)malloc(grid->stride * grid->stride * sizeof(PlanetCell));
+	for (int x = -1; x <= size; ++x) {
+		for (int y = -1; y <= size; ++y) {
+			xPos = x;
+			yPos = y;
+			wrapAroundPlanet(size, &xPos, &yPos);
+			grid->cells[grid->pad(x, y)] = { (uint_least16_t)index(xPos, yPos, size), (uint_least8_t)xPos, (uint_least8_t)yPos };
+
+		}
+	}
+
+	// Finds the offsets of the surrounding tiles.
+	for (int i = -1; i < 2; ++i) {
+		for (int j = -1; j < 2; ++j) {
+			grid->around[currAround++] = i * grid->stride + j;
+			if (i || j) grid->adjacent[currAdjacent++] = i * grid->stride + j;
+
+		}
+	}
+
+	// Finds the offsets of each direction.
+	grid->directions[0] = -grid->stride - 1;
+	grid->directions[1] = -1;
+	grid->directions[2] = grid->stride - 1;
+	grid->directions[3] = grid->stride;
+	grid->directions[4] = -grid->stride;
+	grid->directions[5] = grid->stride + 1;
+	grid->directions[6] = 1;
+	grid->directions[7] = -grid->stride + 1;
+
+	// Lists each tile against every tile adjacent to it. Every tile is adjacent to exactly
+	// PLANET_NEIGHBOURS tiles, counting repeats on the smallest planets.
+	grid->incoming = (PlanetCell*)malloc(size * size * PLANET_NEIGHBOURS * sizeof(PlanetCell));
+	numIncoming = (int*)calloc(size * size, sizeof(int));
+	for (int x = 0; x < size; ++x) {
+		for (int y = 0; y < size; ++y) {
+			for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+				const PlanetCell& cell = grid->cell(grid->pad(x, y), grid->adjacent[d]);
+				grid->incoming[cell.tile * PLANET_NEIGHBOURS + numIncoming[cell.tile]++] = grid->cells[grid->pad(x, y)];
+
+			}
+		}
+	}
+	free(numIncoming);
+
+	return grid;
+
+}
+
+/*
+Returns the padded grid of a planet width, creating it if it does not yet exist.
+*/
+PlanetGrid* planetGrid(int size) {
+	PlanetGrid* grid = planetGrids[size].load(std::memory_order_acquire);
+
+	// Returns the grid if it exists.
+	if (grid) return grid;
+
+	// Creates the grid, unless another thread already has.
+	planetGridMutex.lock();
+	grid = planetGrids[size].load(std::memory_order_relaxed);
+	if (!grid) {
+		grid = createPlanetGrid(size);
+		planetGrids[size].store(grid, std::memory_order_release);
+
+	}
+	planetGridMutex.unlock();
+	return grid;
+
+}
+
 // Tells the compiler about Battles.
 extern struct Battle;
 
+// PlanetSets which a HabitablePlanet may belong to. Each has a slot in HabitablePlanet::setSlots.
+enum PlanetSetID {
+	WAR_PLANETS,
+	OWNED_PLANETS,
+	CLIMATE_PLANETS,
+	NUM_PLANET_SETS
+
+};
+
 /*
 Tile within a System that contains a solid, habitable celestial body.
 Size: 3048bytes
@@ -459,6 +619,9 @@ public:
 	// Size of the planet in tiles.
 	uint_least8_t size;
 
+	// Position of the planet within each PlanetSet plus one, or 0 if the planet is not in that set.
+	std::atomic<int> setSlots[NUM_PLANET_SETS];
+
 	// No argument constructor for a HabitablePlanet.
 	HabitablePlanet();
 
@@ -477,21 +640,111 @@ public:
 	// Parses through the planet's owners and adds their goods to the market.
 	void ownersProduction();
 
+	// Adds the planet to or removes it from each PlanetSet, according to its Battle, owners and gases.
+	void updateActivity();
+
+	// Returns the padded grid used to find adjacent tiles without wrapping.
+	inline PlanetGrid* grid() { return planetGrid(size); }
+
 	// Function that determines if there exists an adjacent tile matching the inputed condition.
-	bool checkAdjacency(int x, int y, std::function<bool(int, int, PlanetTile)> condition);
+	// condition is called as bool(int x, int y, PlanetTile tile).
+	template<class Condition>
+	bool checkAdjacency(int x, int y, const Condition& condition);
 
 	// Function that pathfinds to the nearest tile matching the inputed condition.
 	// When the tile is found, performs the inputed action.
 	// It also requires functions for calculating the gValue between two tiles
-	// and the hValue of a given tile.
-	bool planetPathfind(int x1, int y1, int maxG,
-		std::function<bool(HabitablePlanet*, LinkedListNode<PathCoordinate>*)> endCondition,
-		std::function<void(HabitablePlanet*, LinkedListNode<PathCoordinate>*)> action,
-		std::function<int(HabitablePlanet*, int, int, int, int)> calcG,
-		std::function<double(HabitablePlanet*, LinkedListNode<PathCoordinate>*)> calcH);
+	// and the hValue of a given tile. The functions are called as:
+	// endCondition: bool(HabitablePlanet*, LinkedListNode<PathCoordinate>*)
+	// action: void(HabitablePlanet*, LinkedListNode<PathCoordinate>*)
+	// calcG: int(HabitablePlanet*, int xBeg, int yBeg, int xDest, int yDest)
+	// calcH: double(HabitablePlanet*, LinkedListNode<PathCoordinate>*)
+	template<class EndCondition, class Action, class CalcG, class CalcH>
+	bool planetPathfind(int x1, int y1, int maxG, const EndCondition& endCondition, const Action& action, const CalcG& calcG, const CalcH& calcH);
 
 };
 
+/*
+Dense set of HabitablePlanets, so that a phase visits only the planets it acts on rather than every
+page of the habitablePool. Planets are added and removed in O(1), a removed planet being replaced by
+the last planet of the set. Each planet keeps its position within the set, so unchanged membership
+is found without taking the mutex.
+
+The order of the planets depends on the order in which they joined, which may vary between threads,
+so phases must not depend on it. Sets must not change while a phase iterates over them.
+*/
+struct PlanetSet {
+	HabitablePlanet** planets;
+	int numPlanets;
+	int capacity;
+
+	// Slot of HabitablePlanet::setSlots used by this set.
+	int id;
+
+	// Guards planets, numPlanets and capacity.
+	std::mutex mtx;
+
+	// Constructor. The set is empty.
+	PlanetSet(int id) : planets(nullptr), numPlanets(0), capacity(0), id(id) { }
+
+	// Adds a planet to or removes it from the set. Does nothing if the planet's membership is unchanged.
+	void assign(HabitablePlanet* planet, bool member);
+
+	// Empties the set. Used when the habitablePool is recreated.
+	void clear();
+
+};
+
+// Planets containing a Battle.
+PlanetSet warPlanets(WAR_PLANETS);
+
+// Planets with at least one owner.
+PlanetSet ownedPlanets(OWNED_PLANETS);
+
+// Planets whose gases change each climate turn.
+PlanetSet climatePlanets(CLIMATE_PLANETS);
+
+/*
+Adds a planet to or removes it from the set. Does nothing if the planet's membership is unchanged.
+Only the thread holding the planet may change its membership, but any thread may move it within the set.
+*/
+void PlanetSet::assign(HabitablePlanet* planet, bool member) {
+	std::atomic<int>& slot = planet->setSlots[id];
+	HabitablePlanet* last;
+
+	// Does nothing if the planet's membership is unchanged.
+	if ((slot.load(std::memory_order_relaxed) != 0) == member) return;
+	const std::lock_guard<std::mutex> lock(mtx);
+
+	// Appends the planet, growing the set if it is full.
+	if (member) {
+		if (numPlanets == capacity) {
+			capacity = capacity ? capacity * 2 : 64;
+			planets = (HabitablePlanet**)realloc(planets, capacity * sizeof(HabitablePlanet*));
+
+		}
+		planets[numPlanets++] = planet;
+		slot.store(numPlanets, std::memory_order_relaxed);
+		return;
+
+	}
+
+	// Replaces the planet with the last planet of the set.
+	last = planets[--numPlanets];
+	planets[slot.load(std::memory_order_relaxed) - 1] = last;
+	last->setSlots[id].store(slot.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	slot.store(0, std::memory_order_relaxed);
+
+}
+
+/*
+Empties the set. The planets themselves are expected to have been freed along with their slots.
+*/
+void PlanetSet::clear() {
+	numPlanets = 0;
+
+}
+
 /*
 Unused no argument constructor for a HabitablePlanet.
 */
@@ -581,24 +834,43 @@ void HabitablePlanet::ownersProduction() {
 	}
 }
 
+/*
+Adds the planet to or removes it from each PlanetSet. The planet is at war while it has a Battle, is owned while
+any owner other than unowned land remains, and is changing climate while atmosphereChange would alter any gas.
+Must be called whenever the planet's Battle, owners or netGases change.
+*/
+void HabitablePlanet::updateActivity() {
+	bool owned = false;
+	bool changing = false;
+
+	// Finds whether any owner remains. owners[0] is unowned land.
+	for (int i = 1; i < NUM_HABITABLE_OWNERS; ++i) owned |= owners[i].owner != nullptr;
+
+	// Finds whether any gas changes.
+	for (int j = 0; j < NUM_GASES; ++j) changing |= netGases[j] / 256 != 0;
+
+	// Updates each set.
+	warPlanets.assign(this, battle != nullptr);
+	ownedPlanets.assign(this, owned);
+	climatePlanets.assign(this, changing);
+
+}
+
 /*
 Determines if there exists any adjacent tile matching the inputed condition.
 */
-bool HabitablePlanet::checkAdjacency(int x, int y, std::function<bool(int, int, PlanetTile)> condition) {
-	int xPos, yPos;
+template<class Condition>
+bool HabitablePlanet::checkAdjacency(int x, int y, const Condition& condition) {
+	PlanetGrid* grid = this->grid();
+	int padded = grid->pad(x, y);
 
 	// Checks all adjacent tiles.
-	for (int i = -1; i < 2; ++i) {
-		for (int j = -1; j < 2; ++j) {
-			if (!i && !j) continue;
-			xPos = x + i;
-			yPos = y + j;
-			wrapAroundPlanet(size, &xPos, &yPos);
-			
-			// If the condition is met by any tile, returns true.
-			if (condition(xPos, yPos, planet[index(xPos, yPos, size)])) return true;
+	for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+		const PlanetCell& cell = grid->cell(padded, grid->adjacent[d]);
+
+		// If the condition is met by any tile, returns true.
+		if (condition(cell.x, cell.y, planet[cell.tile])) return true;
 
-		}
 	}
 
 	// Returns false if no tile meets the condition.
@@ -610,48 +882,53 @@ bool HabitablePlanet::checkAdjacency(int x, int y, std::function<bool(int, int,
 TODO header comment.
 
 Return false if and only if pathfinding fails, otherwise returns true.
+
+The callbacks are template parameters rather than std::functions, so each call site compiles
+its own search with the callbacks inlined into the node expansion.
 */
-bool HabitablePlanet::planetPathfind(int x1, int y1, int maxG,
-	std::function<bool (HabitablePlanet*, LinkedListNode<PathCoordinate>*)> endCondition,
-	std::function<void (HabitablePlanet*, LinkedListNode<PathCoordinate>*)> action,
-	std::function<int(HabitablePlanet*, int, int, int, int)> calcG,
-	std::function<double(HabitablePlanet*, LinkedListNode<PathCoordinate>*)> calcH) {
+template<class EndCondition, class Action, class CalcG, class CalcH>
+bool HabitablePlanet::planetPathfind(int x1, int y1, int maxG, const EndCondition& endCondition, const Action& action, const CalcG& calcG, const CalcH& calcH) {
 	bool ret = false;
 	int gValue;
 	int xPos, yPos;
+	int padded;
 	LinkedListNode<PathCoordinate>* currPos = nullptr;
 	LinkedListNode<PathCoordinate>* coord;
+	PlanetGrid* grid = this->grid();
 
 	// Uses a map to mark down explored tiles.
-	uint_least8_t* exploredMap = requestDummy();
-	memset(exploredMap, 0, sizeof(uint_least8_t) * size * size);
+	ExploredMap* exploredMap = requestExploredMap(size * size);
 
-	// Requests a coordList for this function.
-	LinkedList<PathCoordinate>* coordList = requestCoordList();
+	// Creates a coordList for this function from scratch space.
+	ScratchScope scratch;
+	CoordList coordList;
 
-	// Creates a LinkedList for storing the frontier.
-	LinkedList<PathCoordinate> frontier = LinkedList<PathCoordinate>();
+	// Requests a PathHeap for storing the frontier.
+	PathHeap* frontier = requestPathHeap(size, size);
 
 	// Creates a LinkedList for storing explored.
 	LinkedList<PathCoordinate> explored = LinkedList<PathCoordinate>();
 
 	// Adds the initial tile to the frontier.
-	coord = coordList->popc();
+	coord = coordList.popc();
 	coord->value->coord.x = x1;
 	coord->value->coord.y = y1;
 	coord->value->gValue = 0;
 	coord->value->hValue = calcH(this, coord);
 	coord->previous = nullptr;
-	frontier.addc(coord);
-	exploredMap[index(coord->value->coord.x, coord->value->coord.y, size)] = true;
+	frontier->push(coord);
+	exploredMap->set(index(coord->value->coord.x, coord->value->coord.y, size), PATH_OPEN);
 
 	// Pathfinds until the desired coordinate is found.
-	while (!frontier.isEmpty()) {
+	while (!frontier->isEmpty()) {
 
 		// Starts exploring the node.
-		currPos = frontier.popc();
+		currPos = frontier->pop();
 		explored.addc(currPos);
 
+		// Marks this tile explored.
+		exploredMap->set(index(currPos->value->coord.x, currPos->value->coord.y, size), PATH_CLOSED);
+
 		// If currPos meets the inputed criteria, stops looping.
 		if (endCondition(this, currPos)) {
 			action(this, currPos);
@@ -660,283 +937,54 @@ bool HabitablePlanet::planetPathfind(int x1, int y1, int maxG,
 
 		}
 
-		// Adds all adjacent tiles to the frontier.
-		// This is slower than the old code, so it is not used.
-		//actionDirection(currPos->value->coord.x, currPos->value->coord.y,
-		//	[this, &exploredMap, &coordList, &frontier, currPos, calcG, calcH, maxG](int x, int y, Dir d)->void {
-		//		int gValue;
-		//		LinkedListNode<PathCoordinate>* coord;
-
-		//		// Places the coord if it has not been explored.
-		//		wrapAroundPlanet(size, &x, &y);
-		//		if (!exploredMap[index(x, y, size)]) {
-
-		//			// Marks this tile explored.
-		//			exploredMap[index(x, y, size)] = true;
-
-		//			// Selects the gValue.
-		//			gValue = currPos->value->gValue + calcG(this, currPos->value->coord.x, currPos->value->coord.y, x, y);
-
-		//			// Adds the coord to the frontier if it has an appropriate gValue.
-		//			if (gValue < maxG) {
-
-		//				// Places the coord.
-		//				coord = coordList->popc();
-		//				coord->value->coord.x = x;
-		//				coord->value->coord.y = y;
-		//				coord->value->gValue = gValue;
-		//				coord->value->hValue = calcH(this, coord);
-		//				coord->previous = currPos;
-		//				coord->value->dir.d = d;
-		//				frontier.addcAsc(coord);
-
-		//			}
-		//		}
-		//	}
-		//);
-		
-		// Old pathfinding code.
-		// This is consistently slightly faster than the new code, so it is kept.
-		{
-
-		//Adds all adjacent tiles to the frontier.
-		//This is done verbosely because it allows for expression of direction.
-		//Northwest.
-		xPos = currPos->value->coord.x - 1;
-		yPos = currPos->value->coord.y - 1;
-		wrapAroundPlanet(size, &xPos, &yPos);
-		// Places the coord if it has not been explored.
-		if (!exploredMap[index(xPos, yPos, size)]) {
-
-			// Marks this tile explored.
-			exploredMap[index(xPos, yPos, size)] = true;
-
-			// Selects the gValue.
-			gValue = currPos->value->gValue + calcG(this, currPos->value->coord.x, currPos->value->coord.y, xPos, yPos);
-
-			// Adds the coord to the frontier if it has an appropriate gValue.
-			if (gValue < maxG) {
-
-				// Places the coord.
-				coord = coordList->popc();
-				coord->value->coord.x = xPos;
-				coord->value->coord.y = yPos;
-				coord->value->gValue = gValue;
-				coord->value->hValue = calcH(this, coord);
-				coord->previous = currPos;
-				coord->value->dir.d = northwest;
-				frontier.addcAsc(coord);
+		// Adds all adjacent tiles to the frontier. Directions come from the planet's padded grid,
+		// so no wrapping is needed.
+		padded = grid->pad(currPos->value->coord.x, currPos->value->coord.y);
+		for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+			const PlanetCell& cell = grid->cell(padded, grid->directions[d]);
+			xPos = cell.x;
+			yPos = cell.y;
 
-			}
-		}
-		// North.
-		xPos = currPos->value->coord.x;
-		yPos = currPos->value->coord.y - 1;
-		wrapAroundPlanet(size, &xPos, &yPos);
-		// Places the coord if it has not been explored.
-		if (!exploredMap[index(xPos, yPos, size)]) {
-
-			// Marks this tile explored.
-			exploredMap[index(xPos, yPos, size)] = true;
-
-			// Selects the gValue.
-			gValue = currPos->value->gValue + calcG(this, currPos->value->coord.x, currPos->value->coord.y, xPos, yPos);
-
-			// Adds the coord to the frontier if it has an appropriate gValue.
-			if (gValue < maxG) {
-
-				// Places the coord.
-				coord = coordList->popc();
-				coord->value->coord.x = xPos;
-				coord->value->coord.y = yPos;
-				coord->value->gValue = gValue;
-				coord->value->hValue = calcH(this, coord);
-				coord->previous = currPos;
-				coord->value->dir.d = north;
-				frontier.addcAsc(coord);
+			// Places or updates the coord if it has not been explored.
+			if (exploredMap->get(cell.tile) != PATH_CLOSED) {
 
-			}
-		}
-		// Northeast.
-		xPos = currPos->value->coord.x + 1;
-		yPos = currPos->value->coord.y - 1;
-		wrapAroundPlanet(size, &xPos, &yPos);
-		// Places the coord if it has not been explored.
-		if (!exploredMap[index(xPos, yPos, size)]) {
-
-			// Marks this tile explored.
-			exploredMap[index(xPos, yPos, size)] = true;
-
-			// Selects the gValue.
-			gValue = currPos->value->gValue + calcG(this, currPos->value->coord.x, currPos->value->coord.y, xPos, yPos);
-
-			// Adds the coord to the frontier if it has an appropriate gValue.
-			if (gValue < maxG) {
-
-				// Places the coord.
-				coord = coordList->popc();
-				coord->value->coord.x = xPos;
-				coord->value->coord.y = yPos;
-				coord->value->gValue = gValue;
-				coord->value->hValue = calcH(this, coord);
-				coord->previous = currPos;
-				coord->value->dir.d = northeast;
-				frontier.addcAsc(coord);
+				// Selects the gValue.
+				gValue = currPos->value->gValue + calcG(this, currPos->value->coord.x, currPos->value->coord.y, xPos, yPos);
 
-			}
-		}
-		// East.
-		xPos = currPos->value->coord.x + 1;
-		yPos = currPos->value->coord.y;
-		wrapAroundPlanet(size, &xPos, &yPos);
-		// Places the coord if it has not been explored.
-		if (!exploredMap[index(xPos, yPos, size)]) {
-
-			// Marks this tile explored.
-			exploredMap[index(xPos, yPos, size)] = true;
-
-			// Selects the gValue.
-			gValue = currPos->value->gValue + calcG(this, currPos->value->coord.x, currPos->value->coord.y, xPos, yPos);
-
-			// Adds the coord to the frontier if it has an appropriate gValue.
-			if (gValue < maxG) {
-
-				// Places the coord.
-				coord = coordList->popc();
-				coord->value->coord.x = xPos;
-				coord->value->coord.y = yPos;
-				coord->value->gValue = gValue;
-				coord->value->hValue = calcH(this, coord);
-				coord->previous = currPos;
-				coord->value->dir.d = east;
-				frontier.addcAsc(coord);
+				// Lowers the coord's gValue if it is already in the frontier.
+				if (exploredMap->get(cell.tile) == PATH_OPEN) {
+					if (coord = frontier->decreaseKey(xPos, yPos, gValue, currPos)) coord->value->dir.d = planetDirections[d];
 
-			}
-		}
-		// West.
-		xPos = currPos->value->coord.x - 1;
-		yPos = currPos->value->coord.y;
-		wrapAroundPlanet(size, &xPos, &yPos);
-		// Places the coord if it has not been explored.
-		if (!exploredMap[index(xPos, yPos, size)]) {
-
-			// Marks this tile explored.
-			exploredMap[index(xPos, yPos, size)] = true;
-
-			// Selects the gValue.
-			gValue = currPos->value->gValue + calcG(this, currPos->value->coord.x, currPos->value->coord.y, xPos, yPos);
-
-			// Adds the coord to the frontier if it has an appropriate gValue.
-			if (gValue < maxG) {
-
-				// Places the coord.
-				coord = coordList->popc();
-				coord->value->coord.x = xPos;
-				coord->value->coord.y = yPos;
-				coord->value->gValue = gValue;
-				coord->value->hValue = calcH(this, coord);
-				coord->previous = currPos;
-				coord->value->dir.d = west;
-				frontier.addcAsc(coord);
+				}
 
-			}
-		}
-		// Southeast.
-		xPos = currPos->value->coord.x + 1;
-		yPos = currPos->value->coord.y + 1;
-		wrapAroundPlanet(size, &xPos, &yPos);
-		// Places the coord if it has not been explored.
-		if (!exploredMap[index(xPos, yPos, size)]) {
-
-			// Marks this tile explored.
-			exploredMap[index(xPos, yPos, size)] = true;
-
-			// Selects the gValue.
-			gValue = currPos->value->gValue + calcG(this, currPos->value->coord.x, currPos->value->coord.y, xPos, yPos);
-
-			// Adds the coord to the frontier if it has an appropriate gValue.
-			if (gValue < maxG) {
-
-				// Places the coord.
-				coord = coordList->popc();
-				coord->value->coord.x = xPos;
-				coord->value->coord.y = yPos;
-				coord->value->gValue = gValue;
-				coord->value->hValue = calcH(this, coord);
-				coord->previous = currPos;
-				coord->value->dir.d = southeast;
-				frontier.addcAsc(coord);
+				// Adds the coord to the frontier if it has an appropriate gValue.
+				else if (gValue < maxG) {
 
-			}
-		}
-		// South.
-		xPos = currPos->value->coord.x;
-		yPos = currPos->value->coord.y + 1;
-		wrapAroundPlanet(size, &xPos, &yPos);
-		// Places the coord if it has not been explored.
-		if (!exploredMap[index(xPos, yPos, size)]) {
-
-			// Marks this tile explored.
-			exploredMap[index(xPos, yPos, size)] = true;
-
-			// Selects the gValue.
-			gValue = currPos->value->gValue + calcG(this, currPos->value->coord.x, currPos->value->coord.y, xPos, yPos);
-
-			// Adds the coord to the frontier if it has an appropriate gValue.
-			if (gValue < maxG) {
-
-				// Places the coord.
-				coord = coordList->popc();
-				coord->value->coord.x = xPos;
-				coord->value->coord.y = yPos;
-				coord->value->gValue = gValue;
-				coord->value->hValue = calcH(this, coord);
-				coord->previous = currPos;
-				coord->value->dir.d = south;
-				frontier.addcAsc(coord);
-
-			}
-		}
-		// Southwest.
-		xPos = currPos->value->coord.x - 1;
-		yPos = currPos->value->coord.y + 1;
-		wrapAroundPlanet(size, &xPos, &yPos);
-		// Places the coord if it has not been explored.
-		if (!exploredMap[index(xPos, yPos, size)]) {
-
-			// Marks this tile explored.
-			exploredMap[index(xPos, yPos, size)] = true;
-
-			// Selects the gValue.
-			gValue = currPos->value->gValue + calcG(this, currPos->value->coord.x, currPos->value->coord.y, xPos, yPos);
-
-			// Adds the coord to the frontier if it has an appropriate gValue.
-			if (gValue < maxG) {
-
-				// Places the coord.
-				coord = coordList->popc();
-				coord->value->coord.x = xPos;
-				coord->value->coord.y = yPos;
-				coord->value->gValue = gValue;
-				coord->value->hValue = calcH(this, coord);
-				coord->previous = currPos;
-				coord->value->dir.d = southwest;
-				frontier.addcAsc(coord);
+					// Places the coord.
+					coord = coordList.popc();
+					coord->value->coord.x = xPos;
+					coord->value->coord.y = yPos;
+					coord->value->gValue = gValue;
+					coord->value->hValue = calcH(this, coord);
+					coord->previous = currPos;
+					coord->value->dir.d = planetDirections[d];
+					frontier->push(coord);
+					exploredMap->set(cell.tile, PATH_OPEN);
 
+				}
 			}
 		}
 	}
-	}
 
 	// Returns values from frontier and explored to coordList.
-	while (!frontier.isEmpty()) coordList->addc(frontier.popc());
-	while (!explored.isEmpty()) coordList->addc(explored.popc());
+	frontier->empty(&coordList);
+	while (!explored.isEmpty()) coordList.addc(explored.popc());
 
-	// Releases exploredMap.
-	releaseDummy(exploredMap);
+	// Releases the frontier.
+	releasePathHeap(frontier);
 
-	// Releases the coordList.
-	releaseCoordList(coordList);
+	// Releases exploredMap.
+	releaseExploredMap(exploredMap);
 
 	// Returns true if the action lambda was performed.
 	return ret;
@@ -1147,53 +1195,151 @@ int universeSensorDifficulty[] = {
 	32   // THIN_SPACE_TILE
 };
 
+// Width and height of a universe chunk as a power of 2, and in tiles.
+#define UNIVERSE_CHUNK_SHIFT 5
+#define UNIVERSE_CHUNK_SIZE (1 << UNIVERSE_CHUNK_SHIFT)
+
+// Number of tiles in a universe chunk.
+#define UNIVERSE_CHUNK_TILES (UNIVERSE_CHUNK_SIZE * UNIVERSE_CHUNK_SIZE)
+
 /*
-Parent for any given GalaxyTile.
+Summary of a UNIVERSE_CHUNK_SIZE square chunk of the universe. Sweeps over the universe
+check these first, so that chunks with nothing of interest are skipped wholesale.
+Most chunks are empty space without systems, Squadrons or owners.
 
-28 bytes, 4 bytes padding.
-sizeof is 32.
+Counts are exact. closures is conservative: a closure's bit may remain set after its
+tiles have left the chunk, but is always set while it has a tile in the chunk. It is
+cleared when the chunk has no owned tiles left.
 */
-class GalaxyTile {
-public:
+struct UniverseChunk {
 
-	// Contains the System of this GalaxyTile if there is one.
-	System* system; // 8 bytes.
+	// Number of Squadrons in the chunk.
+	std::atomic<int> numSquadrons;
 
-	// Stores the Squadrons in this GalaxyTile.
-	Squadron** squadrons; // 8 bytes.
+	// Number of tiles in the chunk which belong to a closure.
+	std::atomic<int> numOwned;
 
-	// Stores the de-jure owner of this GalaxyTile.
-	Government* owner; // 8 bytes.
+	// Closures which may have tiles in the chunk. Closure c sets bit c % 64.
+	std::atomic<uint_least64_t> closures;
 
-	// Stores the closure of this GalaxyTile.
-	uint_least16_t closure; // 2 bytes.
+	// Number of SYSTEM_TILEs in the chunk. Set when the universe is created.
+	int numSystems;
 
-	// Stores the number of Squadrons in this GalaxyTile.
-	uint_least8_t numSquadrons; // 1 byte.
+	// Checks if the inputed closure may have tiles in the chunk.
+	inline bool mayContain(int closure) { return closures.load(std::memory_order_relaxed) >> (closure & 63) & 1; }
 
-	// tileID for the GalaxyTile.
-	uint_least8_t tileID; // 1 byte.
+};
 
-	// 4 bytes padding.
+/*
+Tiles of one chunk of the universe, stored as one array per field. Scans over a single
+field therefore touch only that field, rather than a whole 32 byte GalaxyTile per tile.
 
-	// Gets the sprite and tileID for this tile.
-	SDL_Rect getSprite();
-	GalaxyTileID getTileID();
+Fields which are read across the whole chunk are kept in arrays of 1 to 4 bytes per tile.
+Pointers are kept in separate (cold) arrays, which are read only for tiles which need them.
+Tiles are in Morton order, so that tiles which are near in both x and y are near in memory.
+*/
+struct UniverseBlock {
+
+	// tileID of each tile. 1 byte.
+	uint_least8_t tileIDs[UNIVERSE_CHUNK_TILES];
+
+	// Closure of each tile. 2 bytes.
+	uint_least16_t closures[UNIVERSE_CHUNK_TILES];
 
-	// Adds a Squadron to this GalaxyTile.
-	void addSquadron(Squadron* squadron);
+	// Number of Squadrons in each tile. 1 byte.
+	uint_least8_t numSquadrons[UNIVERSE_CHUNK_TILES];
 
-	// Removes a Squadron from this GalaxyTile.
-	void removeSquadron(Squadron* squadron);
+	// De-jure owner of each tile, stored as its index in governmentPool + 1. 0 if the tile
+	// has no owner. 4 bytes.
+	uint_least32_t owners[UNIVERSE_CHUNK_TILES];
 
-	// Gets movement difficulty for this GalaxyTile.
-	inline int movementCost();
+	// System of each tile, or nullptr if the tile has none.
+	System* systems[UNIVERSE_CHUNK_TILES];
 
-	// Gets sensor difficulty for this GalaxyTile.
-	inline int sensorCost();
+	// Squadrons in each tile. Only allocated while numSquadrons is non-zero.
+	Squadron** squadrons[UNIVERSE_CHUNK_TILES];
 
 };
 
+/*
+Tiles of the universe, stored in chunks of UNIVERSE_CHUNK_SIZE by UNIVERSE_CHUNK_SIZE.
+Each chunk has a UniverseBlock holding its tiles and a UniverseChunk summarizing them.
+Chunks which lie partially outside the universe are padded with unowned thin space.
+
+A sparse universe only allocates blocks for chunks which overlap a Galaxy or which have
+been written to. Every other chunk shares a single empty block of unowned thin space,
+so that reading any tile through the u* macros works as usual. Writes which may land
+outside of a Galaxy must first call touch, which gives the chunk its own block.
+A dense universe allocates every block up front, so touch never allocates.
+*/
+struct UniverseGrid {
+
+	// Block of each chunk. Chunks without their own block point to empty.
+	std::atomic<UniverseBlock*>* blocks;
+
+	// Shared block of unowned thin space. Must never be written to.
+	UniverseBlock* empty;
+
+	// Summary of each chunk.
+	UniverseChunk* chunks;
+
+	// Number of chunks along each axis.
+	int chunksWide;
+	int chunksHigh;
+
+	// Number of chunks which have their own block.
+	int numBlocks;
+
+	// True if blocks are only allocated when needed.
+	bool sparse;
+
+	// Returns the block containing a tile.
+	inline UniverseBlock* block(int x, int y) { return blocks[chunkOf(x, y)].load(std::memory_order_acquire); }
+
+	// Returns the index of a tile within its block.
+	static inline int offset(int x, int y) {
+		return mortonSpread(x & (UNIVERSE_CHUNK_SIZE - 1)) << 1 | mortonSpread(y & (UNIVERSE_CHUNK_SIZE - 1));
+
+	}
+
+	// Returns the index of the chunk containing a tile.
+	inline int chunkOf(int x, int y) { return (x >> UNIVERSE_CHUNK_SHIFT) * chunksHigh + (y >> UNIVERSE_CHUNK_SHIFT); }
+
+	// Checks if a chunk has its own block.
+	inline bool owned(int chunk) { return blocks[chunk].load(std::memory_order_acquire) != empty; }
+
+	// Returns a chunk's block, giving the chunk its own block if it has none.
+	UniverseBlock* touch(int chunk);
+
+	// Returns the block containing a tile, giving its chunk its own block if it has none.
+	inline UniverseBlock* touch(int x, int y) { return touch(chunkOf(x, y)); }
+
+	// Allocates a width by height universe. Tiles start as unowned thin space.
+	void allocate(int width, int height, bool sparse);
+
+	// Frees every block.
+	void deallocate();
+
+private:
+
+	// Guards the creation of blocks.
+	std::mutex blockMutex;
+
+	// Creates a block of unowned thin space.
+	static UniverseBlock* createBlock();
+
+	// Spreads the bits of a chunk coordinate out to every second bit.
+	static inline int mortonSpread(int v) {
+		v = (v | v << 4) & 0x0F0F;
+		v = (v | v << 2) & 0x3333;
+		return (v | v << 1) & 0x5555;
+
+	}
+};
+
+// Gets the sprite for a tileID.
+SDL_Rect universeTileSprite(int tileID);
+
 /*
 Unused no argument constructor for a SystemSpaceTile.
 */
@@ -1271,14 +1417,14 @@ void System::initTradeLanes(int maxLength) {
 	int curr = 0;
 
 	// Informs the compiler about the universe.
-	extern GalaxyTile* universe;
+	extern UniverseGrid universe;
 
 	// Uses a map to mark down explored tiles.
-	uint_least8_t* exploredMap = requestDummy();
-	memset(exploredMap, 0, sizeof(uint_least8_t) * universeWidth * universeHeight);
+	ExploredMap* exploredMap = requestExploredMap(universeWidth * universeHeight);
 
-	// Requests a coordList for this function.
-	LinkedList<PathCoordinate>* coordList = requestCoordList();
+	// Creates a coordList for this function from scratch space.
+	ScratchScope scratch;
+	CoordList coordList;
 
 	// Creates a LinkedList for storing the frontier.
 	LinkedList<PathCoordinate> frontier = LinkedList<PathCoordinate>();
@@ -1287,14 +1433,14 @@ void System::initTradeLanes(int maxLength) {
 	LinkedList<PathCoordinate> explored = LinkedList<PathCoordinate>();
 
 	// Adds the initial tile to the frontier.
-	coord = coordList->popc();
+	coord = coordList.popc();
 	coord->value->coord.x = loc.x;
 	coord->value->coord.y = loc.y;
 	coord->value->gValue = 0;
 	coord->previous = nullptr;
 	coord->value->info = false;
 	frontier.addc(coord);
-	exploredMap[index(loc.x, loc.y, universeWidth)] = true;
+	exploredMap->visit(index(loc.x, loc.y, universeWidth));
 
 	// Pathfinds until there are no available tiles.
 	while (!frontier.isEmpty()) {
@@ -1305,15 +1451,15 @@ void System::initTradeLanes(int maxLength) {
 
 		// Adds all adjacent tiles to the frontier.
 		actionDirection(currPos->value->coord.x, currPos->value->coord.y,
-			[this, &exploredMap, &coordList, &frontier, currPos, maxLength](int x, int y)->void {
+			[this, exploredMap, &coordList, &frontier, currPos, maxLength](int x, int y)->void {
 				int gValue;
 				LinkedListNode<PathCoordinate>* coord;
 
 				// Places the coord if it has not been explored.
-				if (!exploredMap[index(x, y, universeWidth)] && uIndex(x, y).tileID != THIN_SPACE_TILE) {
+				if (!exploredMap->visited(index(x, y, universeWidth)) && uTileID(x, y) != THIN_SPACE_TILE) {
 
 					// Marks this tile explored.
-					exploredMap[index(x, y, universeWidth)] = true;
+					exploredMap->visit(index(x, y, universeWidth));
 
 					// Selects the gValue.
 					gValue = currPos->value->gValue + 1;
@@ -1322,7 +1468,7 @@ void System::initTradeLanes(int maxLength) {
 					if (gValue < maxLength) {
 
 						// Places the coord.
-						coord = coordList->popc();
+						coord = coordList.popc();
 						coord->value->coord.x = x;
 						coord->value->coord.y = y;
 						coord->value->gValue = gValue;
@@ -1415,83 +1561,91 @@ void System::initTradeLanes(int maxLength) {
 	tradeLanes[tSize - 1].y = 0;
 
 	// Returns all explored nodes to the coordList.
-	while (!explored.isEmpty()) coordList->addc(explored.popc());
+	while (!explored.isEmpty()) coordList.addc(explored.popc());
 
 	// Releases held data.
-	releaseCoordList(coordList);
-	releaseDummy(exploredMap);
+	releaseExploredMap(exploredMap);
 
 }
 
 /*
-Adds a Squadron to this GalaxyTile.
+Allocates a width by height universe, rounded up to a whole number of chunks. Tiles start as
+unowned thin space. A sparse universe starts with every chunk sharing the empty block.
 */
-void GalaxyTile::addSquadron(Squadron* squadron) {
-
-	// Array size will be incremented by 8.
-	const int inc = 8;
-
-	// If squadrons is empty, initializes it.
-	if (!numSquadrons) squadrons = (Squadron**)malloc(sizeof(Squadron*) * inc);
-	// If squadrons is too small, resizes it.
-	else if (!(numSquadrons % inc)) squadrons = (Squadron**)realloc(squadrons, sizeof(Squadron*) * (numSquadrons + inc));
-
-	// Assigns the Squadron to the GalaxyTile.
-	squadrons[numSquadrons] = squadron;
-	++numSquadrons;
+void UniverseGrid::allocate(int width, int height, bool sparse) {
+	this->sparse = sparse;
+	chunksWide = (width + UNIVERSE_CHUNK_SIZE - 1) >> UNIVERSE_CHUNK_SHIFT;
+	chunksHigh = (height + UNIVERSE_CHUNK_SIZE - 1) >> UNIVERSE_CHUNK_SHIFT;
+	chunks = (UniverseChunk*)calloc(chunksWide * chunksHigh, sizeof(UniverseChunk));
+	blocks = (std::atomic<UniverseBlock*>*)malloc(chunksWide * chunksHigh * sizeof(std::atomic<UniverseBlock*>));
+	empty = createBlock();
+	numBlocks = 0;
+
+	// Gives every chunk the empty block, or its own block if the universe is dense.
+	for (int c = 0; c < chunksWide * chunksHigh; ++c) {
+		blocks[c].store(empty, std::memory_order_relaxed);
+		if (!sparse) touch(c);
 
+	}
 }
 
 /*
-Removes a Squadron from this GalaxyTile.
+Frees every block.
 */
-void GalaxyTile::removeSquadron(Squadron* squadron) {
-
-	// Finds the squadron.
-	int curr = 0;
-	for (; squadrons[curr] != squadron && curr < numSquadrons; ++curr);
-
-	// Removes the squadron.
-	--numSquadrons;
-	for (int i = curr; i < numSquadrons; ++i) squadrons[i] = squadrons[i + 1];
-
-	// Deletes squadrons if numSquadrons is 0.
-	if (!numSquadrons) free(squadrons);
+void UniverseGrid::deallocate() {
+	for (int c = 0; c < chunksWide * chunksHigh; ++c) if (owned(c)) free(blocks[c].load(std::memory_order_relaxed));
+	free(blocks);
+	free(empty);
+	free(chunks);
+	blocks = nullptr;
 
 }
 
 /*
-Gets movement difficulty for this GalaxyTile.
+Returns the inputed chunk's block. If the chunk shares the empty block, gives it its own.
+May be called concurrently.
 */
-inline int GalaxyTile::movementCost() {
-	return universeMovementCost[tileID];
+UniverseBlock* UniverseGrid::touch(int chunk) {
+	UniverseBlock* block = blocks[chunk].load(std::memory_order_acquire);
+
+	// Returns the chunk's block if it has one.
+	if (block != empty) return block;
+
+	// Creates a block, unless another thread already has.
+	blockMutex.lock();
+	block = blocks[chunk].load(std::memory_order_relaxed);
+	if (block == empty) {
+		block = createBlock();
+		blocks[chunk].store(block, std::memory_order_release);
+		++numBlocks;
+
+	}
+	blockMutex.unlock();
+	return block;
 
 }
 
 /*
-Gets sensor difficulty for this GalaxyTile.
+Creates a block of unowned thin space.
 */
-inline int GalaxyTile::sensorCost() {
-	return universeSensorDifficulty[tileID];
+UniverseBlock* UniverseGrid::createBlock() {
+	UniverseBlock* block = (UniverseBlock*)calloc(1, sizeof(UniverseBlock));
+	memset(block->tileIDs, THIN_SPACE_TILE, sizeof(block->tileIDs));
+	return block;
 
 }
 
 /*
-Returns the appropriate sprite for this tile.
+Returns the appropriate sprite for a tileID.
 */
-SDL_Rect GalaxyTile::getSprite() {
+SDL_Rect universeTileSprite(int tileID) {
 	switch (tileID) {
 	case(SYSTEM_TILE):
 		return { 2 * SPRITE_SIZE, 0, SPRITE_SIZE, SPRITE_SIZE };
 	case(THICK_SPACE_TILE):
 		return { SPRITE_SIZE, 0, SPRITE_SIZE, SPRITE_SIZE };
-	case(THIN_SPACE_TILE):
+	default:
 		return { 0, 0, SPRITE_SIZE, SPRITE_SIZE };
 
 	}
-}
-
-/*
-Returns this tile's tileID.
-*/
-GalaxyTileID GalaxyTile::getTileID() { return (GalaxyTileID)tileID; }
\ No newline at end of file
+}
\ No newline at end of file
@@ -41,6 +41,9 @@ struct GalaxyInstruction {
 	// Chance of spawning an empire (in thousandths) in any given system.
 	int empireChance;
 
+	// Approximate number of empires to spawn in the Galaxy. Replaces empireChance if positive.
+	int numEmpires;
+
 };
 
 /*
@@ -57,9 +60,6 @@ struct Galaxy {
 	// Number of unowned tiles in this Galaxy.
 	int unowned;
 
-	// Tracks whether a thread is currently using this galaxy.
-	bool active;
-
 };
 
 // List of galaxies in the universe.
@@ -15,9 +15,15 @@ bool ctrl;
 // Pointer to the View that the user is interacting with.
 void (*view)(SDL_Event) = universeView;
 
-// Tells the compiler about gameSpeed and highSpeedMode.
+// Tells the compiler about gameSpeed, highSpeedMode and gamePaused.
 extern int gameSpeed;
 extern bool highSpeedMode;
+extern bool gamePaused;
+
+// Tells the compiler about the gameLoop controls.
+void setGamePaused(bool paused);
+void setHighSpeedMode(bool mode);
+void wakeGameLoop();
 
 /*
 Initializes the Game Screen.
@@ -87,14 +93,13 @@ ButtonCode interfaceLoop() {
 			// Quits BigSpace if the X button is pressed.
 			if (event.type == SDL_QUIT) {
 
-				// Raises the exit flag.
+				// Raises the exit flag and wakes the gameLoop to see it.
 				exitFlag = 1;
+				wakeGameLoop();
 
-				// Joins the gameLoop thread.
+				// Joins the gameLoop thread. Worker threads are kept for the next game.
 				gameLoopThread->join();
-
-				// Joins all threads.
-				joinAllThreads();
+				delete gameLoopThread;
 
 				// Lowers the exit flag.
 				exitFlag = 0;
@@ -206,13 +211,13 @@ ButtonCode interfaceLoop() {
 			}
 			// Pauses and unpauses the game when the Spacebar is pressed.
 			else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_SPACE) {
-				gameSpeed = gameSpeed ? 0 : 1;
+				setGamePaused(!gamePaused);
 
 			}
 			// Places the game in high speed mode when 0 is pressed.
 			// TODO DEBUG REMOVE
 			else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_0) {
-				highSpeedMode = !highSpeedMode;
+				setHighSpeedMode(!highSpeedMode);
 
 			}
 
@@ -9,122 +9,87 @@
 // Current turn.
 int currTurn;
 
-// Speed of the game.
-int gameSpeed;
+// Speed of the game. Turns take TURN_TIME / gameSpeed milliseconds.
+int gameSpeed = 1;
 
-// High speed mode flag.
+// High speed mode flag. Turns are performed back to back while raised, even when paused.
 bool highSpeedMode;
 
-// Locks for the gameplay loop.
-std::shared_mutex gameplayMutex1;
-std::shared_mutex gameplayMutex2;
+// Pause flag. Turns are not performed while raised (or while gameSpeed is 0).
+bool gamePaused = true;
+
+// Hard budget for how far the gameLoop may fall behind schedule, in milliseconds.
+// Turns missed beyond this are dropped rather than caught up.
+#define TURN_BUDGET 2000
+
+// Maximum number of overdue turns performed back to back before the schedule is reset.
+#define MAX_CATCH_UP_TURNS 4
+
+// Number of turns which finished after the next turn was due.
+int overrunTurns;
+
+// Number of times the schedule was reset because the gameLoop fell too far behind.
+int droppedSchedules;
+
+// Used to park the gameLoop thread between turns.
+std::mutex gameLoopMutex;
+std::condition_variable gameLoopCV;
 
 /*
-Performs actions depending on the turn. This function will be managed by multiple threads.
+Performs the actions for the current turn. Each phase is spread over all threads by
+the scheduler, and returns only once every thread has finished it.
+
+Turns cycle through climate change, production and government action. Space and
+ground battles are performed every turn.
 */
 void gameTurn() {
-	while (true) {
 
-		// Performs climate change on 0 turns.
-		gameplayMutex1.lock_shared();
-		climateChange();
-		gameplayMutex1.unlock_shared();
-		threadingSemaphore.post();
-		gameplayMutex2.lock_shared();
-		spaceBattles();
-		groundBattles();
-		threadingSemaphore.post();
-		gameplayMutex2.unlock_shared();
+	// Performs the phases for this turn, timing the turn as a whole.
+	{
+		ProfileScope scope(TURN_ZONE);
+		switch (currTurn % NUM_TURNS) {
 
-		// Closes the thread if the exitFlag is raised.
-		if (exitFlag) return;
+		// Performs climate change on 0 turns.
+		case 0:
+			climateChange();
+			spaceBattles();
+			groundBattles();
+			break;
 
 		// Performs production on 1 turns.
-		gameplayMutex1.lock_shared();
-		planetProduction();
-		gameplayMutex1.unlock_shared();
-		threadingSemaphore.post();
-		gameplayMutex2.lock_shared();
-		groundBattles();
-		spaceBattles();
-		threadingSemaphore.post();
-		gameplayMutex2.unlock_shared();
-
-		// Closes the thread if the exitFlag is raised.
-		if (exitFlag) return;
+		case 1:
+			planetProduction();
+			groundBattles();
+			spaceBattles();
+			break;
 
 		// Performs government action on 2 turns.
-		gameplayMutex1.lock_shared();
-		governmentAction();
-		gameplayMutex1.unlock_shared();
-		threadingSemaphore.post();
-		gameplayMutex2.lock_shared();
-		groundBattles();
-		spaceBattles();
-		threadingSemaphore.post();
-		gameplayMutex2.unlock_shared();
+		case 2:
+			governmentAction();
+			groundBattles();
+			spaceBattles();
+			break;
 
-		// Closes the thread if the exitFlag is raised.
-		if (exitFlag) return;
+		}
+
+		// Frees the scratch space used during this turn.
+		ProfileScope cleanup(CLEANUP_ZONE);
+		resetScratch();
 
 	}
+
+	// Collects the time spent in each phase by each thread.
+	collectProfile(currTurn);
+
 }
 
 /*
-Manages the system of locks to ensure that the threads in gameTurn execute
-correctly.
+Performs the current turn, then moves on to the next turn.
 */
 inline void beginGameTurn() {
 
-	// Prevents child threads from continuing to the second cycle before the
-	// first cycle is over.
-	gameplayMutex2.lock();
-
-	// Prevents child threads from entering the second phase of spaceBattles
-	// while in the second cycle.
-	spaceBattleMutex.lock();
-
-	// Allows child threads to begin the first cycle.
-	gameplayMutex1.unlock();
-
-	// Waits until the current turn has been completed.
-	threadingSemaphore.wait();
-
-	// Unlocks all habitable pages.
-	// TODO create switch containing cleanup behaviours.
-	releaseAllHabitablePages();
-	releaseAllGovernmentPages();
-	releaseAllColonyPages();
-	releaseAllClosurePages();
-	releaseAllGalaxies();
-	resetInt();
-	emptyRemovedSquadrons();
-
-	// Prevents worker threads from moving to the first cycle before the second
-	// one is completed.
-	gameplayMutex1.lock();
-
-	// Allows worker threads to move to the next cycle start.
-	gameplayMutex2.unlock();
-
-	// Waits until the first phase of spaceBattles is complete, then allows
-	// child threads to continue.
-	spaceBattleSemaphore.wait();
-	resetInt();
-	spaceBattleMutex.unlock();
-
-	// Waits until all threads are ready for the next cycle to continue.
-	threadingSemaphore.wait();
-
-	// Unlocks all habitable pages.
-	// TODO create switch containing cleanup behaviours.
-	releaseAllHabitablePages();
-	releaseAllGovernmentPages();
-	releaseAllColonyPages();
-	releaseAllClosurePages();
-	releaseAllGalaxies();
-	resetInt();
-	emptyRemovedSquadrons();
+	// Performs the actions for this turn.
+	gameTurn();
 
 	// Moves on to the next turn.
 	++currTurn;
@@ -132,139 +97,156 @@ inline void beginGameTurn() {
 }
 
 /*
-Main loop for the game.
+Sets the speed of the game and wakes the gameLoop so that it may reschedule.
 */
-void gameLoop() {
-	using::std::chrono::milliseconds;
-	using::std::chrono::duration_cast;
-
-	// Waits for the interface to be ready before beginning.
-	threadingSemaphore.wait();
-
-	// Initializes the current turn to 0.
-	currTurn = 0;
+void setGameSpeed(int speed) {
+	{
+		const std::lock_guard<std::mutex> lock(gameLoopMutex);
+		gameSpeed = speed;
 
-	// Initializes locks.
-	threadingSemaphore.crit = numThreads;
-	threadingSemaphore.count = 0;
-	spaceBattleSemaphore.crit = numThreads;
-	spaceBattleSemaphore.count = 0;
-	gameplayMutex1.lock();
-
-	// Time when the current turn started.
-	auto turnStart = std::chrono::system_clock::now();
-
-	// Current time.
-	auto currTime = std::chrono::system_clock::now();
-
-	// Creates several threads for the gameTurn loop.
-	for (int i = 0; i < numThreads; ++i) threads[demandThread()] = new std::thread(gameTurn);
+	}
+	gameLoopCV.notify_all();
 
-	// Loops until the game is exited.
-	while (true) {
-		while (!highSpeedMode && !exitFlag &&
-			(duration_cast<milliseconds>(currTime.time_since_epoch()).count() - duration_cast<milliseconds>(turnStart.time_since_epoch()).count()) * gameSpeed < TURN_TIME) {
+}
 
-			// Adjusts the time.
-			currTime = std::chrono::system_clock::now();
-			std::this_thread::yield();
+/*
+Pauses or resumes the game and wakes the gameLoop so that it may reschedule.
+*/
+void setGamePaused(bool paused) {
+	{
+		const std::lock_guard<std::mutex> lock(gameLoopMutex);
+		gamePaused = paused;
 
-		}
+	}
+	gameLoopCV.notify_all();
 
-		// TODO DEBUG REMOVE
-		// Prints the time since the last turn started.
-		printf("time : %16lu\n", duration_cast<milliseconds>(currTime.time_since_epoch()).count() - duration_cast<milliseconds>(turnStart.time_since_epoch()).count());
+}
 
-		// Updates the turnStart time.
-		turnStart = std::chrono::system_clock::now();
+/*
+Raises or lowers highSpeedMode and wakes the gameLoop so that it may reschedule.
+*/
+void setHighSpeedMode(bool mode) {
+	{
+		const std::lock_guard<std::mutex> lock(gameLoopMutex);
+		highSpeedMode = mode;
 
-		// Performs the action for this turn.
-		beginGameTurn();
+	}
+	gameLoopCV.notify_all();
 
-		// Closes the thread if the exitFlag is raised.
-		if (exitFlag) return;
+}
 
-		// Creates a new event to order a new frame to be rendered.
-		SDL_Event event = {};
-		event.type = SDL_USEREVENT;
-		SDL_PushEvent(&event);
+/*
+Wakes the gameLoop so that it may check the exitFlag.
+*/
+void wakeGameLoop() {
+	{
+		const std::lock_guard<std::mutex> lock(gameLoopMutex);
 
 	}
+	gameLoopCV.notify_all();
+
 }
 
 /*
-Main loop for the game when performing speed testing.
+Main loop for the game.
+
+Turns are performed on a fixed timestep of TURN_TIME / gameSpeed milliseconds. The
+gameLoop thread parks on gameLoopCV between turns instead of spinning, and is woken
+when the next turn is due or when the game's speed, pause state or exitFlag changes.
+
+Turns which overrun their slot are caught up by performing the following turns back
+to back, up to MAX_CATCH_UP_TURNS or TURN_BUDGET milliseconds behind schedule. Past
+that, the schedule is reset to the current time and missed turns are dropped.
 */
-void speedTestGameLoop(int numTurns) {
-	using::std::chrono::milliseconds;
-	using::std::chrono::duration_cast;
-	long long int duration = 0;
-	long long int med;
+void gameLoop() {
+	using std::chrono::steady_clock;
+	using std::chrono::milliseconds;
+	using std::chrono::microseconds;
+	using std::chrono::duration_cast;
+	steady_clock::time_point nextTurn;
+	steady_clock::time_point turnStart;
+	steady_clock::time_point turnEnd;
+	int scheduledSpeed = 0;
+	int catchUpTurns = 0;
 
 	// Waits for the interface to be ready before beginning.
 	threadingSemaphore.wait();
 
 	// Initializes the current turn to 0.
 	currTurn = 0;
+	overrunTurns = 0;
+	droppedSchedules = 0;
+	resetProfile();
 
-	// Initializes locks.
-	threadingSemaphore.crit = numThreads;
-	threadingSemaphore.count = 0;
-	spaceBattleSemaphore.crit = numThreads;
-	spaceBattleSemaphore.count = 0;
-	gameplayMutex1.lock();
+	// Time when the previous turn started.
+	turnStart = steady_clock::now();
 
-	// Time when the game started.
-	auto gameStart = std::chrono::system_clock::now();
+	// Loops until the game is exited.
+	while (true) {
 
-	// Creates several threads for the gameTurn loop.
-	for (int i = 0; i < numThreads; ++i) threads[demandThread()] = new std::thread(gameTurn);
+		// Parks until the next turn is due.
+		{
+			std::unique_lock<std::mutex> lock(gameLoopMutex);
+			while (!exitFlag && !highSpeedMode) {
 
-	// Loops until the test is over;
-	while (currTurn < numTurns) {
+				// Parks indefinitely while paused. The schedule restarts upon resuming.
+				if (gamePaused || gameSpeed <= 0) {
+					scheduledSpeed = 0;
+					gameLoopCV.wait(lock);
+					continue;
 
-		// Performs the action for this turn.
-		beginGameTurn();
+				}
 
-		// Closes the thread if the exitFlag is raised.
-		if (exitFlag) return;
+				// Schedules the next turn from the previous turn's start if the speed has changed.
+				if (scheduledSpeed != gameSpeed) {
+					nextTurn = turnStart + microseconds(TURN_TIME * 1000 / gameSpeed);
+					if (!scheduledSpeed && nextTurn < steady_clock::now()) nextTurn = steady_clock::now();
+					scheduledSpeed = gameSpeed;
+					catchUpTurns = 0;
 
-		// Creates a new event to order a new frame to be rendered.
-		SDL_Event event = {};
-		event.type = SDL_USEREVENT;
-		SDL_PushEvent(&event);
+				}
 
-	}
+				// Performs the turn if it is due, otherwise parks until it is.
+				if (steady_clock::now() >= nextTurn) break;
+				gameLoopCV.wait_until(lock, nextTurn);
 
-	// Calculates the duration of the game's running.
-	auto currTime = std::chrono::system_clock::now();
-	duration = duration_cast<milliseconds>(currTime.time_since_epoch()).count() - duration_cast<milliseconds>(gameStart.time_since_epoch()).count();
+			}
+		}
+
+		// Closes the thread if the exitFlag is raised.
+		if (exitFlag) return;
 
-	// Prints the number of turns taken during the test.
-	printf("numTurns :%12d\n", numTurns);
+		// Performs the action for this turn.
+		turnStart = steady_clock::now();
+		beginGameTurn();
+		turnEnd = steady_clock::now();
 
-	// Prints hours taken for the test.
-	med = duration / 3600000;
-	printf("%013lu:", med);
+		// Closes the thread if the exitFlag is raised.
+		if (exitFlag) return;
 
-	// Prints the minutes taken for the test.
-	med = duration % 3600000;
-	med /= 60000;
-	printf("%02lu:", med);
+		// Schedules the next turn. High speed mode always restarts the schedule.
+		if (highSpeedMode || !scheduledSpeed) scheduledSpeed = 0;
+		else {
+			nextTurn += microseconds(TURN_TIME * 1000 / scheduledSpeed);
 
-	// Prints the seconds taken for the test.
-	med = duration % 60000;
-	med /= 1000;
-	printf("%02lu", med);
+			// Catches up if the turn overran, unless the gameLoop is too far behind.
+			if (turnEnd > nextTurn) {
+				++overrunTurns;
+				if (++catchUpTurns > MAX_CATCH_UP_TURNS || turnEnd - nextTurn > milliseconds(TURN_BUDGET)) {
+					nextTurn = turnEnd;
+					catchUpTurns = 0;
+					++droppedSchedules;
 
-	// Prints the milliseconds taken for the test.
-	med = duration % 1000;
-	printf(".%03lu\n", med);
+				}
+			}
+			else catchUpTurns = 0;
 
-	// Prints the total duration of the test in milliseconds.
-	printf("time : %14ldms\n", duration);
+		}
 
-	// Prints the time taken per turn of the test in turns/millisecond..
-	printf("rate : %13ft/s\n", (double)numTurns / (((double)duration) / 1000.0));
+		// Creates a new event to order a new frame to be rendered.
+		SDL_Event event = {};
+		event.type = SDL_USEREVENT;
+		SDL_PushEvent(&event);
 
+	}
 }
\ No newline at end of file
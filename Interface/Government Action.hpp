@@ -1,30 +1,32 @@
 #pragma once
 
+// Tells the compiler about the current turn.
+extern int currTurn;
+
 /*
-Performs the government actions for all governments.
+Performs the government actions for all governments on a page.
+Each page has its own random stream for each turn.
 */
-void governmentBehaviours() {
-	int page = requestGovernmentPage();
-
-	// Returns if there is no available page.
-	if (page < 0) return;
+void governmentBehaviours(int page) {
 
-	// Performs each behaviour for each government.
-	for (int i = 0; i < governmentPages[page]->arrCurrGovernment; ++i) {
-		for (int index = 0; index < NUM_GOVERNMENT_BEHAVIOURS && governmentPages[page]->governments[i].behaviours[index]; ++index)
-			governmentPages[page]->governments[i].behaviours[index](&governmentPages[page]->governments[i]);
+	// Seeds this page's random stream.
+	seedRandomStream(randomStream(GOVERNMENT_STREAM, currTurn, page));
 
-	}
-
-	// Continues until there are no remaining GovernmentPages.
-	governmentBehaviours();
+	// Performs each behaviour for each live government.
+	governmentPool.forEachInPage(page, [](Government* government) {
+		for (int index = 0; index < NUM_GOVERNMENT_BEHAVIOURS && government->behaviours[index]; ++index)
+			government->behaviours[index](government);
 
+	});
 }
 
 /*
-Manages government action for all active governments.
+Manages government action for all active governments. Pages of the governmentPool are spread over all threads.
 */
 void governmentAction() {
-	governmentBehaviours();
+	ProfileScope scope(GOVERNMENT_ZONE);
+	parallelFor(0, governmentPool.numPages, 1, [](int beg, int end) {
+		for (int page = beg; page < end; ++page) governmentBehaviours(page);
 
-}
\ No newline at end of file
+	});
+}
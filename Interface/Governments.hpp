@@ -12,13 +12,6 @@ extern void (*buildingFuncs[])(HabitablePlanet* planet, Market* market, int owne
 // Planetary expansion algorithm for an Orcish government.
 void OrcGroundExpand(Government* tribe);
 
-// Number of elements in a GovernmentPage. Should be around 1MB.
-#define GOVERNMENT_PAGE_SIZE ((1048576 - 8) / sizeof(Government))
-
-// Default number of government pages. This is also the number used when expanding the roster of
-// government pages.
-#define NUM_GOVERNMENT_PAGES 256
-
 // Stores codes corresponding to each government action.
 // Used for Save and Load.
 enum GovernmentBehaviours {
@@ -29,42 +22,15 @@ enum GovernmentBehaviours {
 
 };
 
-// Page of governments.
-struct GovernmentPage {
-	Government governments[GOVERNMENT_PAGE_SIZE];
-	uint16_t arrCurrGovernment;
-	uint16_t numOpen;
-	bool active;
-
-	// 3 bytes of padding?
-
-};
-
-// Contains all GovernmentsPages. Minimizes memory use from allocations.
-int numGovernmentPages;
-GovernmentPage** governmentPages;
+// Contains all Governments. Minimizes memory use from allocations.
+PagedPool<Government> governmentPool;
 
 /*
-Creates a paging table of Governments. Initialized with capacity for numGovernments.
+Creates governmentPool. Initialized with capacity for numGovernments.
 It is expected that this function will be called exactly once per universe and in a single-threaded manner.
 */
 void initGovernments(int numGovernments) {
-
-	// Frees governmentPages for reuse.
-	if (numGovernmentPages) {
-		for (int i = 0; i < numGovernmentPages; ++i) {
-			if (governmentPages[i]) delete governmentPages[i];
-			governmentPages[i] = nullptr;
-
-		}
-		delete[] governmentPages;
-
-	}
-
-	// Initializes governmentPages.
-	numGovernmentPages = numGovernments / GOVERNMENT_PAGE_SIZE + 1;
-	governmentPages = (GovernmentPage**)calloc(numGovernmentPages + NUM_GOVERNMENT_PAGES - (numGovernmentPages % NUM_GOVERNMENT_PAGES), sizeof(GovernmentPage*));
-	for (int i = 0; i < numGovernmentPages; ++i) governmentPages[i] = (GovernmentPage*)calloc(1, sizeof(GovernmentPage));
+	governmentPool.init(numGovernments);
 
 }
 
@@ -72,108 +38,7 @@ void initGovernments(int numGovernments) {
 Places a Government.
 */
 Government* placeGovernment() {
-	static std::shared_mutex placeGovernmentMutex;
-
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex> lock(placeGovernmentMutex);
-
-	// Attempts to place the government within one of the current pages.
-	Government* government = nullptr;
-	for (int page = 0; page < numGovernmentPages; ++page) {
-		if (governmentPages[page]->arrCurrGovernment < GOVERNMENT_PAGE_SIZE) {
-			government = &governmentPages[page]->governments[governmentPages[page]->arrCurrGovernment];
-			++governmentPages[page]->arrCurrGovernment;
-			break;
-
-		}
-	}
-
-	// If placement failed, creates a new page and places the government there.
-	// Will only place when all threads are at this function or returned.
-	if (government == nullptr) {
-
-		// If the page table is not large enough, reallocates it.
-		if (!(numGovernmentPages + 1 % NUM_GOVERNMENT_PAGES))
-			governmentPages = (GovernmentPage**)realloc(governmentPages, (numGovernmentPages + NUM_GOVERNMENT_PAGES) * sizeof(GovernmentPage*));
-
-		// Creates a new GovernmentPage.
-		governmentPages[numGovernmentPages] = (GovernmentPage*)calloc(1, sizeof(GovernmentPage));
-
-		// Places the government in the first index of the new page.
-		government = &(governmentPages[numGovernmentPages]->governments[0]);
-		++governmentPages[numGovernmentPages]->arrCurrGovernment;
-
-		// Moves on to the next page.
-		++numGovernmentPages;
-
-	}
-
-	// Returns a pointer to the government.
-	return government;
-
-}
-
-/*
-Requests a GovernmentPage. Returns the index of the next available page in governmentPages, otherwise -1.
-TODO if infrastructure permits it, use a static global to increment through government pages.
-*/
-int requestGovernmentPage() {
-	static std::shared_mutex requestGovernmentPageMutex;
-
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex> lock(requestGovernmentPageMutex);
-
-	// Parses through each Government and returns the next available one.
-	for (int i = 0; i < numGovernmentPages; ++i) {
-		if (!governmentPages[i]->active) {
-			governmentPages[i]->active = true;
-			return i;
-
-		}
-	}
-
-	// Returns -1 if no GovernmentPage was found.
-	return -1;
-
-}
-
-/*
-Returns a GovernmentPage.
-*/
-void releaseGovernmentPage(int index) {
-	governmentPages[index]->active = false;
-
-}
-
-// Returns all GovernmentPages.
-void releaseAllGovernmentPages() {
-	for (int i = 0; i < numGovernmentPages; ++i) governmentPages[i]->active = false;
-
-}
-
-/*
-Finds the page of a given Government within the paging table.
-*/
-inline void findGovernmentPage(int& page, Government* government) {
-
-	// Finds the page.
-	for (page = 0; page < numGovernmentPages; ++page) {
-
-		// Returns the value if the Government is within bounds.
-		if ((char*)government >= (char*)governmentPages[page] &&
-			(char*)government < (char*)governmentPages[page] + sizeof(GovernmentPage)) {
-			return;
-
-		}
-	}
-}
-
-/*
-Finds the location of a given Government within the paging table.
-*/
-inline void findGovernmentIndex(int& page, int& index, Government* government) {
-	findGovernmentPage(page, government);
-	index = ((char*)government - (char*)governmentPages[page]) / sizeof(Government);
+	return governmentPool.allocate();
 
 }
 
@@ -181,19 +46,14 @@ inline void findGovernmentIndex(int& page, int& index, Government* government) {
 Marks a Government as being available for reuse.
 */
 inline void freeGovernment(Government* government) {
-	int page;
-
-	// Marks that there is a free Government in the page.
-	findGovernmentPage(page, government);
-	++governmentPages[page]->numOpen;
 
-	// Clears the Colony.
+	// Clears the Government.
 	government->~Government();
 
-}
+	// Returns the Government to the pool.
+	governmentPool.free(government);
 
-// Undefines constants which are used only for initializing Governments.
-#undef NUM_GOVERNMENT_PAGES
+}
 
 /*
 Default constructor for a Government. This will not be called when array allocated governments are used.
@@ -293,9 +153,10 @@ Assumes that the closure is currently within closures.
 */
 void Government::removeClosure(uint_least16_t closure) {
 
-	// Finds the closure.
+	// Finds the closure. Does nothing if it is not found.
 	int clos = 0;
-	for (; closures[clos] != closure && clos < numClosures; ++clos);
+	for (; clos < numClosures && closures[clos] != closure; ++clos);
+	if (clos == numClosures) return;
 
 	// Removes the closure.
 	--numClosures;
@@ -313,7 +174,6 @@ TODO expand separately for different closures?
 */
 void Government::findSpace() {
 	int indices[NUM_TARGETS];
-	std::vector<Coordinate> coordQueue;
 	Coordinate coord;
 	int currIndex = 0;
 	int xPos, yPos;
@@ -322,11 +182,14 @@ void Government::findSpace() {
 	// Resets spaceTarget.
 	spaceTarget = 0;
 
-	// Acquires a dummy to hold explored tiles.
-	uint_least8_t* explored = requestDummy();
+	// Acquires a map to hold explored tiles.
+	ExploredMap* explored = requestExploredMap(universeWidth * universeHeight);
 
-	// Acquires a dummy to hold expansions.
-	Coordinate* expansions = (Coordinate*)requestLargeDummy();
+	// Allocates scratch space for the queue and the expansions. Tiles may be placed in expansions
+	// several times, so neither has a fixed size.
+	ScratchScope scratch;
+	ScratchVector<Coordinate> coordQueue;
+	ScratchVector<Coordinate> expansions;
 
 	// Finds space for expansion in every SpaceClosure.
 	for (int c = 0; c < numClosures; ++c) {
@@ -342,7 +205,7 @@ void Government::findSpace() {
 		coordQueue.push_back({ xPos, yPos });
 
 		// Empties explored.
-		memset(explored, 0, universeWidth * universeHeight * sizeof(explored[0]));
+		explored->clear();
 
 		// Pathdinds out from the start of the closure looking for available tiles.
 		while (!coordQueue.empty()) {
@@ -351,15 +214,17 @@ void Government::findSpace() {
 			coord = coordQueue.back();
 			coordQueue.pop_back();
 
-			// Does nothing if the tile has already been explored.
-			if (explored[index(coord.x, coord.y, universeWidth)]) continue;
+			// Does nothing if the tile is out of bounds or has already been explored.
+			if (!universeInBounds(coord.x, coord.y)) continue;
+			if (explored->visited(index(coord.x, coord.y, universeWidth))) continue;
 
 			// Does nothing if the tile is a ThinSpaceTile.
-			if (uIndex(coord.x, coord.y).tileID == THIN_SPACE_TILE) continue;
+			if (uTileID(coord.x, coord.y) == THIN_SPACE_TILE) continue;
 
 			// Adds the tile to expansions if it is unowned.
 			if (!uController(coord.x, coord.y)) {
-				expansions[currIndex++] = { coord.x, coord.y };
+				expansions.push_back({ coord.x, coord.y });
+				++currIndex;
 				continue;
 
 			}
@@ -367,7 +232,7 @@ void Government::findSpace() {
 			// Marks the current tile as explored. This is placed here to allow
 			// tiles with multiple adjacent owned tiles to be placed in expansions
 			// multiple times, therefore increasing their weight.
-			explored[index(coord.x, coord.y, universeWidth)] = 1;
+			explored->visit(index(coord.x, coord.y, universeWidth));
 
 			// Does nothing if the tile is owned by another Government.
 			if (uController(coord.x, coord.y) != this) continue;
@@ -420,9 +285,8 @@ void Government::findSpace() {
 		}
 	}
 
-	// Releases the dummies.
-	releaseDummy(explored);
-	releaseLargeDummy((uint_least8_t*)expansions);
+	// Releases the ExploredMap.
+	releaseExploredMap(explored);
 
 }
 
@@ -860,7 +724,6 @@ void OrcShipbuilding(Government* tribe) {
 	Colony* colony;
 	Squadron* squadron;
 	HabitablePlanet* planet;
-	GalaxyTile* tile = nullptr;
 	std::shared_mutex* mutex;
 	CoordU loc;
 
@@ -879,17 +742,17 @@ void OrcShipbuilding(Government* tribe) {
 
 		// Places ships in the tile if it is owned by the tribe.
 		if (uController(loc.x, loc.y) == tribe) {
-			tile = &uIndex(loc.x, loc.y);
 
 			// Places a Ship in an existing owned Squadron if one exists.
 			if (squadron = universeContainsOwnedSquadron(loc.x, loc.y, tribe)) {
 				squadron->addShip(&tribe->shipTable[0], 1);
 
 			}
-			// Places a Ship in a new Squadron if no Squadron exists.
+			// Places a Ship in a new Squadron if no Squadron exists. No Ship is built if the
+			// SquadronStore is full.
 			else {
-				Squadron* squadron = new Squadron(tribe, squadronGuard, planet->loc);
-				squadron->addShip(&tribe->shipTable[0], 1);
+				Squadron* squadron = squadronStore.create(tribe, squadronGuard, planet->loc);
+				if (squadron) squadron->addShip(&tribe->shipTable[0], 1);
 
 			}
 		}
@@ -15,10 +15,25 @@
 // Note that this is not checked/binding and only informs memset/arr sizes.
 #define MAX_GROUND_FRONTS 512
 
+// Number of flow fields kept for each owner in a Battle. Indexed by GroundMovementTypes.
+#define NUM_FLOW_FIELDS 4
+
+// Planets at least this wide diffuse their units in bands of rows which are processed in parallel.
+#define PARALLEL_BATTLE_WIDTH 128
+
+// Approximate number of rows in each band of a parallel diffusion. Must be at least 2.
+#define BATTLE_BAND_ROWS 16
+
+// Flow field distance of a tile from which no front can be reached.
+#define FLOW_UNREACHABLE UINT_LEAST16_MAX
+
+// Define BIGSPACE_VERIFY_FRONTS to check the maintained front strengths, enemy strengths and tile sets
+// against the battlefield after every battle tick.
+
 // TODO DEBUG REMOVE
 extern HabitablePlanet* activeHabitable;
 extern void changeActiveHabitable(HabitablePlanet*);
-extern int gameSpeed;
+extern void setGamePaused(bool paused);
 
 // Enum signifying types of damage that a unit can deliver.
 enum GroundDamageTypes {
@@ -146,6 +161,67 @@ struct GroundBattleTile {
 	// 1 byte of padding.
 
 };
+
+/*
+Set of tiles on a battlefield, stored as one bit per tile.
+Tiles are visited in index order, the same order as a loop over x and then y.
+*/
+struct TileSet {
+
+	// Bits of the set, 64 tiles per word.
+	uint64_t* words;
+
+	// Number of words in the set.
+	int numWords;
+
+	// Allocates an empty set able to hold the inputed number of tiles.
+	inline void init(int numTiles) {
+		numWords = (numTiles + 63) / 64;
+		words = new uint64_t[numWords]();
+
+	}
+
+	// Deallocates the set.
+	inline void clear() { delete[] words; }
+
+	// Checks whether a tile is in the set.
+	inline bool has(int tile) { return (words[tile / 64] >> (tile % 64)) & 1; }
+
+	// Adds (in = true) or removes (in = false) a tile.
+	inline void assign(int tile, bool in) {
+		if (in) words[tile / 64] |= 1ULL << (tile % 64);
+		else words[tile / 64] &= ~(1ULL << (tile % 64));
+
+	}
+
+	// Calls visit(int tile) for every tile in the set. Tiles added or removed by visit are seen
+	// when the iteration reaches them, so visit may change the set.
+	template<class Visit>
+	inline void forEach(Visit&& visit) { forEachIn(0, numWords * 64, visit); }
+
+	// Calls visit(int tile) for every tile in the set within [beg, end), as forEach does.
+	template<class Visit>
+	inline void forEachIn(int beg, int end, Visit&& visit) {
+		uint64_t word, mask;
+		int bit;
+
+		for (int w = beg / 64; w * 64 < end; ++w) {
+
+			// Masks out the tiles of the word which are outside of the range.
+			mask = ~0ULL;
+			if (beg > w * 64) mask &= ~0ULL << (beg - w * 64);
+			if (end < w * 64 + 64) mask &= (1ULL << (end - w * 64)) - 1;
+
+			for (word = words[w] & mask; word; word = words[w] & mask & (~1ULL << bit)) {
+				bit = lowestSetBit(word);
+				visit(w * 64 + bit);
+
+			}
+		}
+	}
+
+};
+
 /*
 Determines the casualties of a Ground battle between two inputed units.
 Note: The new quantities are returned via attackers and defenders.
@@ -197,7 +273,7 @@ inline void groundUnitTemplateStrength(GroundUnitTemplate* unit) {
 /*
 Stores a Battle on  a planet.
 
-This class uses 64 bytes.
+This class uses 80 bytes.
 */
 class Battle {
 public:
@@ -226,12 +302,28 @@ public:
 	// Stores the planet associated with this Battle.
 	HabitablePlanet* planet;
 
+	// Distances from each tile to the nearest front able to accept units, indexed by
+	// owner * NUM_FLOW_FIELDS + movementType. Fields are allocated when first used.
+	uint_least16_t** flowFields;
+
+	// Whether each flow field is up to date. Cleared for an owner whenever its tiles change hands or fronts.
+	bool* flowFieldsValid;
+
+	// Tiles which belong to a front. Diffusion only happens on these tiles.
+	TileSet frontTiles;
+
+	// Tiles which are adjacent to a tile at war with their owner. Attacks only happen from these tiles.
+	TileSet borderTiles;
+
 	// TODO include generals and commanders as necessary.
 
 	// Standard constructor for a Battle.
 	// Note: the inputed planet is assigned this Battle in the constructor.
 	Battle(HabitablePlanet* planet);
 
+	// Rebuilds the parts of a Battle which are not saved. Used after the Battle is loaded.
+	void rebuild();
+
 	// Deconstructor for a Battle.
 	~Battle();
 
@@ -308,6 +400,18 @@ private:
 	// Creates paths to move units to nearby fronts.
 	void moveToFronts();
 
+	// Returns an up to date flow field for the inputed owner and movement type.
+	uint_least16_t* flowField(int owner, int movementType);
+
+	// Calculates a flow field with a breadth first search from every front tile of the inputed owner.
+	void calcFlowField(uint_least16_t* field, int owner, int movementType);
+
+	// Creates a movement order for a unit by descending a flow field.
+	bool followFlowField(uint_least16_t* field, int x, int y, uint_least8_t unit, uint_least8_t quantity);
+
+	// Marks every flow field as out of date.
+	inline void invalidateFlowFields(int owner);
+
 	// Creates paths to move units between fronts.
 	void moveBetweenFronts();
 
@@ -317,15 +421,66 @@ private:
 	// Diffuses units on fronts.
 	void diffuseUnits();
 
+	// Diffuses units from the front tiles within rows [begRow, endRow), other than those on the poles.
+	void diffuseBand(int begRow, int endRow, uint_least8_t* received, int* changes);
+
+	// Diffuses units from the front tiles on both poles.
+	void diffusePoles(uint_least8_t* received, int* changes);
+
+	// Diffuses units from a tile into its adjacent tiles. Strength changes are counted into changes.
+	inline void diffuseTile(int x, int y, uint_least8_t* received, int* changes);
+
 	// Causes enemy units to attack each other.
 	void attackUnits();
 
 	// Plans naval invasions.
 	void navalInvade();
 
-	// Calculates and assigns front strength.
+	// Recounts and assigns the strength and enemy strength of every front.
 	void calcFrontStrength();
 
+	// Counts the strength of every front from scratch into the inputed fronts.
+	void measureFrontStrength(GroundFront* measured);
+
+	// Compares every front's maintained strength and enemy strength against a full recount, then assigns the recount.
+	// Returns true if there was a discrepancy.
+	bool verifyFrontStrength();
+
+	// Adds strength to the front of a tile, and to the enemy strength of each enemy front
+	// adjacent to the tile.
+	inline void countTileStrength(int x, int y, int strength, GroundFront* target);
+
+	// Finds the distinct fronts at war with a tile which are adjacent to it. Returns the number found.
+	inline int findEnemyFronts(int x, int y, uint_least16_t* enemyFronts);
+
+	// Adds a tile's strength, measured as strength, to each enemy front adjacent to it.
+	inline void countEnemyStrength(int x, int y, int strength);
+
+	// Adds sign times the strength of a tile and of the tiles it is adjacent to towards their enemy fronts, skipping
+	// those which the change to or from otherOwner and otherFront does not affect. Used to take tiles out of enemy
+	// strengths before a tile's owner or front changes, and to put them back after.
+	inline void countEnemyStrengthAround(int x, int y, int otherOwner, uint_least16_t otherFront, int sign);
+
+	// Assigns the owner and front of a tile, adjusting front strengths and tile sets.
+	inline void reassignTile(int x, int y, int owner, uint_least16_t front);
+
+	// Builds frontTiles and borderTiles from the battlefield.
+	void initTileSets();
+
+	// Checks whether a tile belongs in borderTiles and assigns it accordingly.
+	inline void updateBorderTile(int x, int y);
+
+	// Compares frontTiles and borderTiles against the battlefield. Returns true if there was a discrepancy.
+	bool verifyTileSets();
+
+	// Counts the change in a tile's strength since it was measured as before.
+	// Used after units in a tile are changed.
+	inline void settleTileStrength(int x, int y, int before);
+
+	// Counts the change in a tile's strength since it was measured as before into changes. Strength changes
+	// are indexed by front, followed by enemy strength changes. Used where several threads change units at once.
+	inline void countStrengthChange(int x, int y, int before, int* changes);
+
 	// Checks to see if the inputed owner is in any of the 8 adjacent tiles.
 	int checkOwnerAdjacency(int x, int y, int owner);
 
@@ -339,13 +494,6 @@ private:
 	// Attempts to find an adjacent enemy. Returns owner if no enemy is found.
 	int findAdjacentEnemy(int x, int y, int owner);
 
-	// Calculates the strength of all adjacent enemies.
-	// Assumes that the inputed tile has not yet been taken by the inputed owner.
-	int findAdjacentEnemyStrength(int x, int y, int front);
-
-	// Changes the enemyStrenghts of all adjacent enemy fronts by strength.
-	void adjustAdjacentEnemyStrengths(int x, int y, int strength);
-
 	// Extends a planet's fronts around the inputed tile.
 	void extendFronts(int x, int y, int owner);
 
@@ -374,11 +522,13 @@ will only ever return 1 once.
 bool Battle::checkFronts() {
 	static int ret = 0;
 	int tot1 = 0, tot2 = 0;
-	int xPos, yPos;
+	PlanetGrid* grid = planet->grid();
+	int padded;
 	uint_least32_t strengths[MAX_GROUND_FRONTS];
 	uint_least32_t enemyStrengths[MAX_GROUND_FRONTS];
 	uint_least32_t numTiles[MAX_GROUND_FRONTS];
 	uint_least8_t* dummy;
+	ScratchScope scratch;
 	memset(strengths, 0, sizeof(int) * MAX_GROUND_FRONTS);
 	memset(enemyStrengths, 0, sizeof(int) * MAX_GROUND_FRONTS);
 	memset(numTiles, 0, sizeof(numTiles[0]) * MAX_GROUND_FRONTS);
@@ -386,7 +536,7 @@ bool Battle::checkFronts() {
 	if (ret) return 0;
 
 	// Get dummy.
-	dummy = requestDummy();
+	dummy = scratch.array<uint_least8_t>(planet->size * planet->size);
 
 	// Find strengths and numTiles.
 	for (int i = 0; i < planet->size * planet->size; ++i) {
@@ -407,19 +557,15 @@ bool Battle::checkFronts() {
 
 				// Gets enemy strength.
 				if (gbIndex(i, j, planet).front == currFront) {
-					for (int x = -1; x < 2; ++x) {
-						for (int y = -1; y < 2; ++y) {
-							if (!x && !y) continue;
-							xPos = i + x;
-							yPos = j + y;
-							wrapAroundPlanet(planet->size, &xPos, &yPos);
-
-							// If at war, not moving, and not already counted, adds value. 
-							if (comp.comp(gbIndex(i, j, planet).owner, gbIndex(xPos, yPos, planet).owner) && !dummy[index(xPos, yPos, planet->size)]) {
-								enemyStrengths[currFront] += groundUnitTileStrength(gbIndex(xPos, yPos, planet));
-								dummy[index(xPos, yPos, planet->size)] = 1;
-
-							}
+					padded = grid->pad(i, j);
+					for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+						const PlanetCell& cell = grid->cell(padded, grid->adjacent[d]);
+
+						// If at war, not moving, and not already counted, adds value. 
+						if (comp.comp(gbIndex(i, j, planet).owner, battlefield[cell.tile].owner) && !dummy[cell.tile]) {
+							enemyStrengths[currFront] += groundUnitTileStrength(battlefield[cell.tile]);
+							dummy[cell.tile] = 1;
+
 						}
 					}
 				}
@@ -427,9 +573,6 @@ bool Battle::checkFronts() {
 		}
 	}
 
-	// Release the dummy.
-	releaseDummy(dummy);
-
 	// Compare strengths and enemyStrengths. Return 1 if there is a discrepency.
 	for (int i = 1; i < comp.short1; ++i) {
 		if ((uint_least32_t)strengths[i] != (uint_least32_t)fronts[i].strength) { ret = 1;  return 1; }
@@ -459,8 +602,8 @@ Checks that all paths have units at their associated positions and all units are
 bool Battle::checkPaths() {
 	int ret = false;
 	LinkedListNode<Coord>* currNode = movements.root;
-	uint_least8_t* dummy = requestDummy();
-	memset(dummy, 0, sizeof(uint_least8_t) * planet->size * planet->size);
+	ScratchScope scratch;
+	uint_least8_t* dummy = scratch.zeroed<uint_least8_t>(planet->size * planet->size);
 
 	// Reviews every path.
 	while (currNode != nullptr) {
@@ -501,15 +644,12 @@ bool Battle::checkPaths() {
 			int x;
 			int y;
 			deIndex(x, y, i, planet->size);
-			printf("%p : discrepency at tile [%d, %d], dummy : %d, moving : %d\n", planet, x, y, dummy[i], battlefield[i].units[1].quantity && battlefield[i].units[1].moving);
+			fprintf(stderr, "%p : discrepency at tile [%d, %d], dummy : %d, moving : %d\n", planet, x, y, dummy[i], battlefield[i].units[1].quantity && battlefield[i].units[1].moving);
 			ret = true;
 
 		}
 	}
 
-	// Releases the dummy.
-	releaseDummy(dummy);
-
 	// Returns false if all goes well.
 	return ret;
 
@@ -521,17 +661,19 @@ verifies that fronts have proper values
 */
 void Battle::verifyFronts() {
 	int tot1 = 0, tot2 = 0;
-	int xPos, yPos;
+	PlanetGrid* grid = planet->grid();
+	int padded;
 	uint_least32_t strengths[MAX_GROUND_FRONTS];
 	uint_least32_t enemyStrengths[MAX_GROUND_FRONTS];
 	uint_least32_t numTiles[MAX_GROUND_FRONTS];
 	uint_least8_t* dummy;
+	ScratchScope scratch;
 	memset(strengths, 0, sizeof(strengths[0]) * MAX_GROUND_FRONTS);
 	memset(enemyStrengths, 0, sizeof(enemyStrengths[0]) * MAX_GROUND_FRONTS);
 	memset(numTiles, 0, sizeof(numTiles[0]) * MAX_GROUND_FRONTS);
 
 	// Get dummy.
-	dummy = requestDummy();
+	dummy = scratch.array<uint_least8_t>(planet->size * planet->size);
 
 	// Find strengths and numTiles.
 	for (int i = 0; i < planet->size * planet->size; ++i) {
@@ -554,19 +696,15 @@ void Battle::verifyFronts() {
 
 				// Gets enemy strength.
 				if (gbIndex(i, j, planet).front == currFront) {
-					for (int x = -1; x < 2; ++x) {
-						for (int y = -1; y < 2; ++y) {
-							if (!x && !y) continue;
-							xPos = i + x;
-							yPos = j + y;
-							wrapAroundPlanet(planet->size, &xPos, &yPos);
-
-							// If at war and not already counted, adds value. 
-							if (comp.comp(gbIndex(i, j, planet).owner, gbIndex(xPos, yPos, planet).owner) && !dummy[index(xPos, yPos, planet->size)]) {
-								enemyStrengths[currFront] += groundUnitTileStrength(gbIndex(xPos, yPos, planet));
-								dummy[index(xPos, yPos, planet->size)] = 1;
-
-							}
+					padded = grid->pad(i, j);
+					for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+						const PlanetCell& cell = grid->cell(padded, grid->adjacent[d]);
+
+						// If at war and not already counted, adds value. 
+						if (comp.comp(gbIndex(i, j, planet).owner, battlefield[cell.tile].owner) && !dummy[cell.tile]) {
+							enemyStrengths[currFront] += groundUnitTileStrength(battlefield[cell.tile]);
+							dummy[cell.tile] = 1;
+
 						}
 					}
 				}
@@ -574,14 +712,11 @@ void Battle::verifyFronts() {
 		}
 	}
 
-	// Release the dummy.
-	releaseDummy(dummy);
-
 	// Compare strengths, enemyStrengths and numTiles.
 	for (int i = 1; i < comp.short1; ++i) {
-		if ((uint_least32_t)strengths[i] != (uint_least32_t)fronts[i].strength) printf("front[%d] (stren) : measured %u, front %d\n", i, (uint_least32_t)strengths[i], fronts[i].strength);
-		if ((uint_least32_t)enemyStrengths[i] != (uint_least32_t)fronts[i].enemyStrength) printf("front[%d] (enemy) : measured %u, front %d\n", i, (uint_least32_t)enemyStrengths[i], fronts[i].enemyStrength);
-		if (numTiles[i] != fronts[i].numTiles) printf("front[%d] (numtl) : measured : %u, front : %u\n", i, numTiles[i], fronts[i].numTiles);
+		if ((uint_least32_t)strengths[i] != (uint_least32_t)fronts[i].strength) fprintf(stderr, "front[%d] (stren) : measured %u, front %d\n", i, (uint_least32_t)strengths[i], fronts[i].strength);
+		if ((uint_least32_t)enemyStrengths[i] != (uint_least32_t)fronts[i].enemyStrength) fprintf(stderr, "front[%d] (enemy) : measured %u, front %d\n", i, (uint_least32_t)enemyStrengths[i], fronts[i].enemyStrength);
+		if (numTiles[i] != fronts[i].numTiles) fprintf(stderr, "front[%d] (numtl) : measured : %u, front : %u\n", i, numTiles[i], fronts[i].numTiles);
 
 	}
 
@@ -590,7 +725,7 @@ void Battle::verifyFronts() {
 		tot1 += strengths[i];
 		tot2 += fronts[i].strength;
 	}
-	printf("totals: measured %d, front %d, difference %d\n", tot1, tot2, (int)(abs(tot1 - tot2)));
+	fprintf(stderr, "totals: measured %d, front %d, difference %d\n", tot1, tot2, (int)(abs(tot1 - tot2)));
 
 	// Finds the total strength of all enemyStrengths.
 	tot2 = 0;
@@ -604,10 +739,10 @@ void Battle::verifyFronts() {
 	// Finds the total strength on the planet.
 	int tot4 = 0;
 	for (int i = 0; i < planet->size * planet->size; ++i) tot4 += battlefield[i].units[0].quantity;
-	printf("total units / total front units / measured enemyStrengths / enemyStrengths : %d, %d, %d, %d\n", tot4, tot1, tot3, tot2);
+	fprintf(stderr, "total units / total front units / measured enemyStrengths / enemyStrengths : %d, %d, %d, %d\n", tot4, tot1, tot3, tot2);
 
 	// Prints comp.short1
-	printf("numFronts : %d\n", (int)comp.short1);
+	fprintf(stderr, "numFronts : %d\n", (int)comp.short1);
 
 }
 
@@ -637,6 +772,7 @@ Battle::Battle(HabitablePlanet* planet) {
 	// Makes the HabitablePlanet and Battle reference one another.
 	this->planet = planet;
 	planet->battle = this;
+	planet->updateActivity();
 
 	// Initializes owners. The first owner symbolizes unowned land and is empty.
 	comp.byte1 = 1;
@@ -651,12 +787,35 @@ Battle::Battle(HabitablePlanet* planet) {
 	// comp is also initialized here.
 	initOwners();
 
+	// Initializes the flow fields. They are calculated when first used, and drawing fronts invalidates them.
+	flowFields = new uint_least16_t*[comp.byte1 * NUM_FLOW_FIELDS]();
+	flowFieldsValid = new bool[comp.byte1 * NUM_FLOW_FIELDS]();
+
+	// Initializes the tile sets. Fronts are added to them as they are drawn.
+	initTileSets();
+
 	// Initializes the fronts for the Battle.
 	initFronts();
 
 	// Assigns movement orders to units without fronts.
 	moveToFronts();
 
+	// Counts the initial front strengths. They are maintained from here on.
+	calcFrontStrength();
+
+}
+
+/*
+Rebuilds the parts of a Battle which are derived from the battlefield and are not saved.
+Flow fields are recalculated when next used. Front strengths are recounted, since they are
+maintained from here on.
+*/
+void Battle::rebuild() {
+	flowFields = new uint_least16_t*[comp.byte1 * NUM_FLOW_FIELDS]();
+	flowFieldsValid = new bool[comp.byte1 * NUM_FLOW_FIELDS]();
+	initTileSets();
+	calcFrontStrength();
+
 }
 
 /*
@@ -667,11 +826,17 @@ Battle::~Battle() {
 
 	// Dissociates the Battle from the planet.
 	planet->battle = nullptr;
+	planet->updateActivity();
 
 	// Deletes arrays.
 	delete owners;
 	delete fronts;
 	delete battlefield;
+	for (int i = 0; i < comp.byte1 * NUM_FLOW_FIELDS; ++i) delete[] flowFields[i];
+	delete[] flowFields;
+	delete[] flowFieldsValid;
+	frontTiles.clear();
+	borderTiles.clear();
 
 	// Empties movements.
 	movements.clear();
@@ -693,7 +858,7 @@ void Battle::battle() {
 	// Moves units along their designated paths.
 	moveUnits();
 
-	if (checkPaths()) { printf("Path Discrepency\n"); gameSpeed = 0; changeActiveHabitable(planet); };
+	if (checkPaths()) { printf("Path Discrepency\n"); setGamePaused(true); changeActiveHabitable(planet); };
 
 	// Assigns movement orders between fronts.
 	//moveBetweenFronts();
@@ -707,12 +872,15 @@ void Battle::battle() {
 	// Causes units to attack one another.
 	attackUnits();
 
-	// Calculates the strength values for each front.
-	calcFrontStrength();
+	// Front strengths are maintained by the steps above. Checks them against a full recount.
+#ifdef BIGSPACE_VERIFY_FRONTS
+	if (verifyFrontStrength()) fprintf(stderr, "Front Strength Discrepency\n");
+	if (verifyTileSets()) fprintf(stderr, "Tile Set Discrepency\n");
+#endif
 
 	// TODO DEBUG REMOVE
 	// REMOVE extern changeActiveHabitable
-	//if (checkFronts()) { printf("Front Discrepency\n"); verifyFronts(); gameSpeed = 0; changeActiveHabitable(planet); }
+	//if (checkFronts()) { printf("Front Discrepency\n"); verifyFronts(); gamePaused = true; changeActiveHabitable(planet); }
 
 }
 
@@ -870,28 +1038,25 @@ and is adjacent to a sea tile.
 */
 int Battle::findAdjacentEnemy(int x, int y, int owner) {
 	int tempOwner = owner;
-	int xPos, yPos;
+	PlanetGrid* grid = planet->grid();
+	int padded = grid->pad(x, y);
 
 	// Attempts to find any adjacent owner that is not equal to the inputed owner.
-	for (int i = -1; i < 2; ++i) {
-		for (int j = -1; j < 2; ++j) {
-			xPos = x + i;
-			yPos = y + j;
-			wrapAroundPlanet(planet->size, &xPos, &yPos);
+	for (int d = 0; d < PLANET_NEIGHBOURS + 1; ++d) {
+		const PlanetCell& cell = grid->cell(padded, grid->around[d]);
 
-			// Returns the first adjacent owner that is found.
-			if (gbIndex(xPos, yPos, planet).owner != owner) {
+		// Returns the first adjacent owner that is found.
+		if (battlefield[cell.tile].owner != owner) {
 
-				// Returns if the owner is non null.
-				if (gbIndex(xPos, yPos, planet).owner) return gbIndex(xPos, yPos, planet).owner;
-				// If the owner is null, prepares to return it if no other owner is found.
-				else tempOwner = gbIndex(xPos, yPos, planet).owner;
-
-			}
-			// Stores 0 if the inputed tile contains a landFront adjacent to sea.
-			else if (pIsLand(x, y, planet) && !pIsLand(xPos, yPos, planet)) tempOwner = 0;
+			// Returns if the owner is non null.
+			if (battlefield[cell.tile].owner) return battlefield[cell.tile].owner;
+			// If the owner is null, prepares to return it if no other owner is found.
+			else tempOwner = battlefield[cell.tile].owner;
 
 		}
+		// Stores 0 if the inputed tile contains a landFront adjacent to sea.
+		else if (pIsLand(x, y, planet) && !pIsLand(cell.x, cell.y, planet)) tempOwner = 0;
+
 	}
 
 	// If there is no adjacent owner, returns either the inputed owner or 0,
@@ -900,93 +1065,20 @@ int Battle::findAdjacentEnemy(int x, int y, int owner) {
 
 }
 
-/*
-Calculates the strength of all adjacent enemies. This is meant to be used to update a front's
-enemyStrength before a new tile is taken. Only the strength of enemy tiles which are not currently
-adjacent to tiles belonging to front will be counted.
-
-TODO use all indices
-TODO make sure that only unmoving units are counted
-*/
-int Battle::findAdjacentEnemyStrength(int x, int y, int front) {
-	int xPos, yPos;
-	int enemyStrength = 0;
-
-	// Sums the strength of all adjacent enemy tiles which are not adjacent to the inputed front.
-	for (int i = -1; i < 2; ++i) {
-		for (int j = -1; j < 2; ++j) {
-			if (!i && !j) continue;
-			xPos = x + i;
-			yPos = y + j;
-			wrapAroundPlanet(planet->size, &xPos, &yPos);
-
-			// If there is an adjacent enemy tile which is not already adjacent to any
-			// tile belonging to the inputed front, increases enemyStrength.
-			if (comp.comp(fronts[front].owner, gbIndex(xPos, yPos, planet).owner) && !checkFrontAdjacency(xPos, yPos, front) && !gbIndex(xPos, yPos, planet).units[0].moving)
-				enemyStrength += groundUnitTileStrength(gbIndex(xPos, yPos, planet));
-
-		}
-	}
-
-	// Returns the calculated strength.
-	return enemyStrength;
-
-}
-
-/*
-Changes the enemyStrength of all adjacent enemy fronts by the inputed strength value.
-This is used to enemy strength when units are added or removed from a front.
-*/
-void Battle::adjustAdjacentEnemyStrengths(int x, int y, int strength) {
-	int xPos, yPos;
-	int currEdit = 0;
-	uint_least16_t edited[8];
-
-	// Changes strength for each adjacent enemy front.
-	for (int i = -1; i < 2; ++i) {
-		for (int j = -1; j < 2; ++j) {
-			if (!i && !j) continue;
-			xPos = x + i;
-			yPos = y + j;
-			wrapAroundPlanet(planet->size, &xPos, &yPos);
-
-			// If the adjacent enemy front has already been adjusted, does not change it further.
-			for (int curr = 0; curr < currEdit; ++curr) if (edited[curr] == gbIndex(xPos, yPos, planet).front) goto skip;
-
-			// If an adjacent front is at war with the current front and has not already been adjusted,
-			// adjusts the enemyStrength of the front.
-			if (comp.comp(gbIndex(x, y, planet).owner, gbIndex(xPos, yPos, planet).owner)) {
-				edited[currEdit] = gbIndex(xPos, yPos, planet).front;
-				++currEdit;
-				fronts[gbIndex(xPos, yPos, planet).front].enemyStrength += strength;
-
-			}
-
-		// Will not adjust strength if the front has been edited.
-		skip:;
-
-		}
-	}
-}
-
 /*
 Checks to see if a tile on a planet is adjacent to a tile belonging to the inputed owner.
 */
 int Battle::checkOwnerAdjacency(int x, int y, int owner) {
-	int xPos, yPos;
+	PlanetGrid* grid = planet->grid();
+	int padded = grid->pad(x, y);
 
 	// Checks to see if any adjacent owner is equal to the inputed owner.
-	for (int i = -1; i < 2; ++i) {
-		for (int j = -1; j < 2; ++j) {
-			if (!i && !j) continue;
-			xPos = x + i;
-			yPos = y + j;
-			wrapAroundPlanet(planet->size, &xPos, &yPos);
+	for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+		const PlanetCell& cell = grid->cell(padded, grid->adjacent[d]);
 
-			// Returns true if an adjacent tile with the inputed owner is found.
-			if (gbIndex(xPos, yPos, planet).owner == owner) return true;
+		// Returns true if an adjacent tile with the inputed owner is found.
+		if (battlefield[cell.tile].owner == owner) return true;
 
-		}
 	}
 	
 	// If an adjacent tile with the inputed owner is not found, returns false.
@@ -1007,26 +1099,22 @@ Note: It would be optimal to avoid checking for adjacent sea tiles when sea fron
 */
 int Battle::checkEnemyAdjacency(int x, int y, GroundFront* front) {
 	int special = 0;
-	int xPos, yPos;
+	PlanetGrid* grid = planet->grid();
+	int padded = grid->pad(x, y);
 
 	// Checks to see if any adjacent owner is equal to the inputed owner.
-	for (int i = -1; i < 2; ++i) {
-		for (int j = -1; j < 2; ++j) {
-			if (!i && !j) continue;
-			xPos = x + i;
-			yPos = y + j;
-			wrapAroundPlanet(planet->size, &xPos, &yPos);
-
-			// Checks to see if an adjacent tile with the inputed enemy is found.
-			if (front->enemy && gbIndex(xPos, yPos, planet).owner == front->enemy) return true;
-			// If the inputed enemy is unowned and there is an adjacent owned tile, returns false.
-			else if (!front->enemy && gbIndex(xPos, yPos, planet).owner && gbIndex(xPos, yPos, planet).owner != front->owner) return false;
-			// If the front's enemy is unowned and an unowned tile is found, marks that down.
-			else if (!front->enemy && !gbIndex(xPos, yPos, planet).owner) special = 1;
-			// If the front is a land front and its enemy is unowned, marks adjacent sea tiles.
-			else if (!front->enemy && front->isLand && !pIsLand(xPos, yPos, planet)) special = 1;
+	for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+		const PlanetCell& cell = grid->cell(padded, grid->adjacent[d]);
+
+		// Checks to see if an adjacent tile with the inputed enemy is found.
+		if (front->enemy && battlefield[cell.tile].owner == front->enemy) return true;
+		// If the inputed enemy is unowned and there is an adjacent owned tile, returns false.
+		else if (!front->enemy && battlefield[cell.tile].owner && battlefield[cell.tile].owner != front->owner) return false;
+		// If the front's enemy is unowned and an unowned tile is found, marks that down.
+		else if (!front->enemy && !battlefield[cell.tile].owner) special = 1;
+		// If the front is a land front and its enemy is unowned, marks adjacent sea tiles.
+		else if (!front->enemy && front->isLand && !pIsLand(cell.x, cell.y, planet)) special = 1;
 
-		}
 	}
 
 	// If an adjacent tile with the inputed owner is not found, returns false.
@@ -1044,20 +1132,16 @@ int Battle::checkEnemyAdjacency(int x, int y, GroundFront* front) {
 Checks to see if the inputed tile is adjacent to any tile containing the inputed front.
 */
 int Battle::checkFrontAdjacency(int x, int y, int front) {
-	int xPos, yPos;
+	PlanetGrid* grid = planet->grid();
+	int padded = grid->pad(x, y);
 
 	// Checks to see if any adjacent owner is equal to the inputed front.
-	for (int i = -1; i < 2; ++i) {
-		for (int j = -1; j < 2; ++j) {
-			if (!i && !j) continue;
-			xPos = x + i;
-			yPos = y + j;
-			wrapAroundPlanet(planet->size, &xPos, &yPos);
+	for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+		const PlanetCell& cell = grid->cell(padded, grid->adjacent[d]);
 
-			// Returns 1 if a tile containing the inputed front is found.
-			if (gbIndex(xPos, yPos, planet).front == front) return 1;
+		// Returns 1 if a tile containing the inputed front is found.
+		if (battlefield[cell.tile].front == front) return 1;
 
-		}
 	}
 
 	// Returns 0 if no adjacent tile containing the inputed front is found.
@@ -1083,7 +1167,8 @@ Extends the front to tiles which
 	- Do not belong to this front.
 */
 void Battle::extendLandFront(int currX, int currY, int front) {
-	int xPos, yPos;
+	PlanetGrid* grid = planet->grid();
+	int padded = grid->pad(currX, currY);
 
 	// Returns if the current tile belongs to this front.
 	if (gbIndex(currX, currY, planet).front == front) return;
@@ -1102,19 +1187,14 @@ void Battle::extendLandFront(int currX, int currY, int front) {
 	++fronts[front].numTiles;
 	--fronts[gbIndex(currX, currY, planet).front].numTiles;
 
-	// Changes the tile's front.
-	gbIndex(currX, currY, planet).front = front;
+	// Changes the tile's front, moving its strength to the new front.
+	reassignTile(currX, currY, gbIndex(currX, currY, planet).owner, front);
 
 	// Attempts to continue to draw the front in each direction.
-	for (int i = -1; i < 2; ++i) {
-		for (int j = -1; j < 2; ++j) {
-			if (!i && !j) continue;
-			xPos = currX + i;
-			yPos = currY + j;
-			wrapAroundPlanet(planet->size, &xPos, &yPos);
-			extendLandFront(xPos, yPos, front);
+	for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+		const PlanetCell& cell = grid->cell(padded, grid->adjacent[d]);
+		extendLandFront(cell.x, cell.y, front);
 
-		}
 	}
 }
 
@@ -1126,7 +1206,8 @@ Extends the front to tiles which
 	- Do not belong to this front.
 */
 void Battle::extendSeaFront(int currX, int currY, int front) {
-	int xPos, yPos;
+	PlanetGrid* grid = planet->grid();
+	int padded = grid->pad(currX, currY);
 
 	// Returns if the current tile belongs to this front.
 	if (gbIndex(currX, currY, planet).front == front) return;
@@ -1145,19 +1226,14 @@ void Battle::extendSeaFront(int currX, int currY, int front) {
 	++fronts[front].numTiles;
 	--fronts[gbIndex(currX, currY, planet).front].numTiles;
 
-	// Changes the tile's front.
-	gbIndex(currX, currY, planet).front = front;
+	// Changes the tile's front, moving its strength to the new front.
+	reassignTile(currX, currY, gbIndex(currX, currY, planet).owner, front);
 
 	// Attempts to continue to draw the front in each direction.
-	for (int i = -1; i < 2; ++i) {
-		for (int j = -1; j < 2; ++j) {
-			if (!i && !j) continue;
-			xPos = currX + i;
-			yPos = currY + j;
-			wrapAroundPlanet(planet->size, &xPos, &yPos);
-			extendSeaFront(xPos, yPos, front);
+	for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+		const PlanetCell& cell = grid->cell(padded, grid->adjacent[d]);
+		extendSeaFront(cell.x, cell.y, front);
 
-		}
 	}
 }
 
@@ -1169,10 +1245,11 @@ void Battle::extendFrontsHelper(int x, int y, int owner) {
 	int front;
 	int enemy;
 	int isLand;
-	int xPos, yPos;
+	PlanetGrid* grid = planet->grid();
+	int padded = grid->pad(x, y);
 
-	// Assigns the owner of this tile.
-	gbIndex(x, y, planet).owner = owner;
+	// Assigns the owner of this tile, adjusting front strengths.
+	if (gbIndex(x, y, planet).owner != owner) reassignTile(x, y, owner, gbIndex(x, y, planet).front);
 
 	// If this tile belongs to a valid front, does nothing.
 	if (fronts[gbIndex(x, y, planet).front].owner == owner && fronts[gbIndex(x, y, planet).front].enemy &&
@@ -1183,23 +1260,18 @@ void Battle::extendFrontsHelper(int x, int y, int owner) {
 	isLand = pIsLand(x, y, planet);
 
 	// Finds any adjacent fronts belonging to the inputed owner.
-	for (int i = -1; i < 2; ++i) {
-		for (int j = -1; j < 2; ++j) {
-			if (!i && !j) continue;
-			xPos = x + i;
-			yPos = y + j;
-			wrapAroundPlanet(planet->size, &xPos, &yPos);
-
-			// In order to extend a front, there must be a nearby front belonging to the inputed
-			// owner which is associated with an adjacent enemy. The front must be on the same
-			// terrain type as the tile.
-			front = gbIndex(xPos, yPos, planet).front;
-			if (front && isLand == pIsLand(xPos, yPos, planet) && gbIndex(xPos, yPos, planet).owner == owner &&
-				checkEnemyAdjacency(x, y, &fronts[front])) {
-				extendFront(x, y, front);
-				return;
+	for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+		const PlanetCell& cell = grid->cell(padded, grid->adjacent[d]);
+
+		// In order to extend a front, there must be a nearby front belonging to the inputed
+		// owner which is associated with an adjacent enemy. The front must be on the same
+		// terrain type as the tile.
+		front = battlefield[cell.tile].front;
+		if (front && isLand == pIsLand(cell.x, cell.y, planet) && battlefield[cell.tile].owner == owner &&
+			checkEnemyAdjacency(x, y, &fronts[front])) {
+			extendFront(x, y, front);
+			return;
 
-			}
 		}
 	}
 
@@ -1219,20 +1291,17 @@ Will also extend fronts and perform front cleanup in the surrounding area.
 */
 void Battle::extendFronts(int x, int y, int owner) {
 	int xPos, yPos;
+	PlanetGrid* grid = planet->grid();
+	int padded = grid->pad(x, y);
 
 	// Extends the fronts for this tile.
 	extendFrontsHelper(x, y, owner);
 
 	// Extends fronts for every surrounding tile.
-	for (int i = -1; i < 2; ++i) {
-		for (int j = -1; j < 2; ++j) {
-			if (!i && !j) continue;
-			xPos = x + i;
-			yPos = y + j;
-			wrapAroundPlanet(planet->size, &xPos, &yPos);
-			if (gbIndex(xPos, yPos, planet).owner) extendFrontsHelper(xPos, yPos, gbIndex(xPos, yPos, planet).owner);
+	for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+		const PlanetCell& cell = grid->cell(padded, grid->adjacent[d]);
+		if (battlefield[cell.tile].owner) extendFrontsHelper(cell.x, cell.y, battlefield[cell.tile].owner);
 
-		}
 	}
 
 	// Cleans up nearby unused front tiles.
@@ -1248,7 +1317,7 @@ void Battle::extendFronts(int x, int y, int owner) {
 				// TODO DEBUG REMOVE keeps front if it is land and has adjacent sea
 				//if (checkEnemyAdjacency(xPos, yPos, &fronts[gbIndex(xPos, yPos, planet).front])) continue;
 				--fronts[gbIndex(xPos, yPos, planet).front].numTiles;
-				gbIndex(xPos, yPos, planet).front = 0;
+				if (gbIndex(xPos, yPos, planet).front) reassignTile(xPos, yPos, gbIndex(xPos, yPos, planet).owner, 0);
 
 			}
 		}
@@ -1366,6 +1435,7 @@ If this is used to shuffle units inwards, the units being moved should be made 0
 */
 inline void Battle::placeUnits(int x, int y, uint_least8_t quantity, uint_least8_t unit) {
 	uint_least8_t transferQuantity;
+	int before = groundUnitTileStrength(gbIndex(x, y, planet));
 
 	// Attempts to place all units in the tile, starting from units[0].
 	for (int i = 0; quantity && i < NUM_TILE_UNITS; ++i) {
@@ -1382,6 +1452,10 @@ inline void Battle::placeUnits(int x, int y, uint_least8_t quantity, uint_least8
 
 		}
 	}
+
+	// Adjusts front strengths.
+	settleTileStrength(x, y, before);
+
 }
 
 /*
@@ -1394,6 +1468,7 @@ TODO when more units than the tile contains are removed, nothing happens. It is
 */
 inline void Battle::removeUnits(int x, int y, uint_least8_t quantity, uint_least8_t unit) {
 	uint_least8_t transferQuantity;
+	int before = groundUnitTileStrength(gbIndex(x, y, planet));
 
 	// Attempts to remove quantity of the inputed unit from the tile, starting from the highest index.
 	for (int i = NUM_TILE_UNITS; i >= 0; --i) {
@@ -1410,6 +1485,10 @@ inline void Battle::removeUnits(int x, int y, uint_least8_t quantity, uint_least
 
 		}
 	}
+
+	// Adjusts front strengths.
+	settleTileStrength(x, y, before);
+
 }
 
 
@@ -1517,9 +1596,12 @@ void Battle::initFronts() {
 }
 
 /*
-Establishes paths for idle units to move to their nearest fronts. The paths will avoid unmoving
-units and enemy territory completely. The destination of each path will be the nearest allied front
-which can accept the idle unit.
+Establishes paths for idle units to move to their nearest fronts. The paths will avoid enemy
+territory and terrain which the unit cannot occupy. The destination of each path will be the
+nearest allied front which is not full.
+
+Paths are found by descending the flow field of the unit's owner and movement type, so each
+field is searched at most once however many units are idle.
 
 coords[0].x stores the length of the path, coords[0].y stores the current index in the path.
 coords[1] stores {unit, quantity}.
@@ -1527,10 +1609,11 @@ coords[1] stores {unit, quantity}.
 TODO fix use of indices (should count down).
 */
 void Battle::moveToFronts() {
-	bool pathFound;
 	uint_least8_t unit;
 	uint_least8_t quantity;
 	uint_least8_t owner;
+	int before;
+	uint_least16_t* field;
 
 	// Creates movement orders to carry every unit to the nearest front.
 	for (int x = 0; x < planet->size; ++x) {
@@ -1546,75 +1629,163 @@ void Battle::moveToFronts() {
 					owner = gbIndex(x, y, planet).owner;
 
 					// Creates a path for the unit.
-					pathFound = planet->planetPathfind(x, y, planet->size,
+					field = flowField(owner, owners[owner].unitTable[unit].movementType);
 
-						// endCondition lambda. Ends when an unnocupied tile with a front is found or
-						// when an occupied tile containing less than 255 of the given unit is found.
-						[unit, quantity, owner](HabitablePlanet* planet, LinkedListNode<PathCoordinate>* currPos)->bool {
-							GroundBattleTile tile = pBattleIndex(currPos->value->coord.x, currPos->value->coord.y, planet);
-							return tile.front && tile.owner == owner && // front of correct owner.
-								(!tile.units[0].quantity || // empty.
-								(tile.units[0].unit == unit && tile.units[0].quantity < 255)); // same unit with valid quantity.
+					// Marks the unit as moving if pathdinfing was successful.
+					// Moving units do not count towards front strength.
+					// TODO make sure that 2 is not overwritten
+					if (followFlowField(field, x, y, unit, quantity)) {
+						before = groundUnitTileStrength(gbIndex(x, y, planet));
+						gbIndex(x, y, planet).units[NUM_TILE_UNITS - 1] = gbIndex(x, y, planet).units[i];
+						gbIndex(x, y, planet).units[i] = { 0, 0, 0 };
+						gbIndex(x, y, planet).units[NUM_TILE_UNITS - 1].moving = 1;
+						settleTileStrength(x, y, before);
 
-						},
+					}
+				}
+			}
+		}
+	}
+}
 
-						// action lambda. Creates a path.
-						[this, unit, quantity](HabitablePlanet* planet, LinkedListNode<PathCoordinate>* currPos) {
-							LinkedListNode<PathCoordinate>* counter = currPos;
+/*
+Returns the flow field for the inputed owner and movement type, recalculating it if fronts have
+changed since it was last used. Limb and Track movement share a field since they occupy the same terrain.
+*/
+uint_least16_t* Battle::flowField(int owner, int movementType) {
+	if (movementType == TrackMovement) movementType = LimbMovement;
+	int f = owner * NUM_FLOW_FIELDS + movementType;
 
-							// Does nothing if the gValue is invalid.
-							if (currPos->value->gValue <= 0) return;
+	// Recalculates the field if it is out of date.
+	if (!flowFieldsValid[f]) {
+		if (!flowFields[f]) flowFields[f] = new uint_least16_t[planet->size * planet->size];
+		calcFlowField(flowFields[f], owner, movementType);
+		flowFieldsValid[f] = true;
 
-							// Creates a list of Coords corresponding to the movement.
-							// coords[0].x stores the length of the path + 2, coords[0].y stores the current index in the path.
-							Coord* coords = new Coord[(int)currPos->value->gValue + 3]();
-							coords[0].x = (uint_least8_t)currPos->value->gValue + 2; // Adds 2 for more convenient comparisons with y later.
-							coords[0].y = 2; // Starts at 2 since the first 2 indices are used for metadata.
+	}
 
-							// Marks down the number of units and the unit type.
-							coords[1] = {unit, quantity};
+	return flowFields[f];
 
-							// Writes down the list of coordinates to be travelled.
-							for (; currPos != nullptr; currPos = currPos->previous) {
-								coords[(int)currPos->value->gValue + 2].x = currPos->value->coord.x;
-								coords[(int)currPos->value->gValue + 2].y = currPos->value->coord.y;
+}
 
-							}
+/*
+Calculates a flow field for the inputed owner and movement type. Each tile is assigned its distance
+to the nearest of the owner's front tiles which can accept units of the movement type, found by a
+single breadth first search seeded from every such front tile. Tiles which are not owned by the
+owner or cannot be occupied are never entered and are left FLOW_UNREACHABLE.
+*/
+void Battle::calcFlowField(uint_least16_t* field, int owner, int movementType) {
+	int area = planet->size * planet->size;
+	int head = 0, tail = 0;
+	int x, y;
+	PlanetGrid* grid = planet->grid();
+	int padded;
+	int next;
+	GroundUnitTemplate unit = {};
+	unit.movementType = movementType;
+
+	// Planets are at most MAX_PLANET_WIDTH wide, so tile indices fit in 16 bits.
+	ScratchScope scratch;
+	uint_least16_t* queue = scratch.array<uint_least16_t>(area);
+
+	// Seeds the search with every front tile which is not full.
+	for (int i = 0; i < area; ++i) {
+		x = i / planet->size;
+		y = i % planet->size;
+		if (battlefield[i].owner == owner && battlefield[i].front && battlefield[i].units[0].quantity < 255 &&
+			canOccupyTerrain(x, y, unit)) {
+			field[i] = 0;
+			queue[tail++] = i;
 
-							// Adds the Coords to the LinkedList.
-							movements.add(coords);
+		}
+		else field[i] = FLOW_UNREACHABLE;
 
-						},
+	}
 
-						// calcG lambda. gValue change is always one for each tile, unless there are other factors.
-						[this, unit, quantity, owner](HabitablePlanet* planet, int xBeg, int yBeg, int xDest, int yDest)->int {
-							return 256 * (pBattleIndex(xDest, yDest, planet).owner != owner || // Tile not owned by the unit's owner.
-								!canOccupyTerrain(xDest, yDest, owners[owner].unitTable[unit]) || // Tile incompatible with current unit.
-								(pBattleIndex(xDest, yDest, planet).units[NUM_TILE_UNITS - 1].quantity && !pBattleIndex(xDest, yDest, planet).units[NUM_TILE_UNITS - 1].moving && // Unit in way.
-								!(pBattleIndex(xDest, yDest, planet).units[0].unit == unit && pBattleIndex(xDest, yDest, planet).front && pBattleIndex(xDest, yDest, planet).units[0].quantity < 255))) // Does not match endCondition.
-								+ 1;
+	// Expands outwards from the fronts, one ring of tiles at a time.
+	while (head < tail) {
+		x = queue[head] / planet->size;
+		y = queue[head] % planet->size;
+		padded = grid->pad(x, y);
+		for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+			const PlanetCell& cell = grid->cell(padded, grid->adjacent[d]);
+			next = cell.tile;
 
-						},
+			// Enters unexplored tiles which the owner's units can pass through.
+			if (field[next] == FLOW_UNREACHABLE && battlefield[next].owner == owner && canOccupyTerrain(cell.x, cell.y, unit)) {
+				field[next] = field[queue[head]] + 1;
+				queue[tail++] = next;
 
-						// calcH lambda. hValue is always zero as this is a breadth first search.
-						[](HabitablePlanet* planet, LinkedListNode<PathCoordinate>* currPos)->double {
-							return 0;
+			}
+		}
+		++head;
 
-						}
-						);
+	}
+}
 
-					// Marks the unit as moving if pathdinfing was successful.
-					// TODO make sure that 2 is not overwritten
-					if (pathFound) {
-						gbIndex(x, y, planet).units[NUM_TILE_UNITS - 1] = gbIndex(x, y, planet).units[i];
-						gbIndex(x, y, planet).units[i] = { 0, 0, 0 };
-						gbIndex(x, y, planet).units[NUM_TILE_UNITS - 1].moving = 1;
+/*
+Creates a movement order for a unit by repeatedly stepping to an adjacent tile one closer to a front.
+Returns false if no front can be reached from the inputed tile.
+
+coords[0].x stores the length of the path + 2, coords[0].y stores the current index in the path.
+coords[1] stores {unit, quantity}.
+*/
+bool Battle::followFlowField(uint_least16_t* field, int x, int y, uint_least8_t unit, uint_least8_t quantity) {
+	int distance = field[index(x, y, planet->size)];
+	int xPos, yPos;
+	PlanetGrid* grid = planet->grid();
+	int padded;
+	bool stepped;
+
+	// Does nothing if no front is reachable, or if the path would not fit within a Coord.
+	if (!distance || distance + 2 > UINT_LEAST8_MAX) return false;
+
+	// Creates a list of Coords corresponding to the movement.
+	Coord* coords = new Coord[distance + 3]();
+	coords[0].x = distance + 2; // Adds 2 for more convenient comparisons with y later.
+	coords[0].y = 2; // Starts at 2 since the first 2 indices are used for metadata.
+	coords[1] = {unit, quantity};
+	coords[2] = {(uint_least8_t)x, (uint_least8_t)y};
+
+	// Writes down the list of coordinates to be travelled.
+	for (int step = 1; step <= distance; ++step) {
+		stepped = false;
+		padded = grid->pad(x, y);
+		for (int d = 0; d < PLANET_NEIGHBOURS && !stepped; ++d) {
+			const PlanetCell& cell = grid->cell(padded, grid->adjacent[d]);
+			xPos = cell.x;
+			yPos = cell.y;
+			stepped = field[cell.tile] == distance - step;
+
+		}
+
+		// Wrapping over the poles is not perfectly symmetric, so the descent may rarely fail.
+		if (!stepped) {
+			delete[] coords;
+			return false;
 
-					}
-				}
-			}
 		}
+
+		// Takes the step.
+		x = xPos;
+		y = yPos;
+		coords[step + 2] = {(uint_least8_t)x, (uint_least8_t)y};
+
 	}
+
+	// Adds the Coords to the LinkedList.
+	movements.add(coords);
+	return true;
+
+}
+
+/*
+Marks every flow field of the inputed owner as out of date. They are recalculated when next used.
+Fields only depend on the owner's own tiles, so other owners' fields are left alone.
+*/
+inline void Battle::invalidateFlowFields(int owner) {
+	memset(flowFieldsValid + owner * NUM_FLOW_FIELDS, 0, sizeof(bool) * NUM_FLOW_FIELDS);
+
 }
 
 /*
@@ -1644,6 +1815,7 @@ coords[1] stores {unit, quantity}.
 void Battle::moveUnits() {
 	uint_least8_t quantity;
 	uint_least8_t unit;
+	int currStrength, nextStrength;
 	Coord currCoord;
 	Coord nextCoord;
 	LinkedListNode<Coord>* currNode = movements.root;
@@ -1667,8 +1839,12 @@ void Battle::moveUnits() {
 			placeUnits(nextCoord.x, nextCoord.y, gbIndex(currCoord.x, currCoord.y, planet).units[NUM_TILE_UNITS - 1].quantity, gbIndex(currCoord.x, currCoord.y, planet).units[NUM_TILE_UNITS - 1].unit);
 
 			// Removes the units from the previous tile.
+			currStrength = groundUnitTileStrength(gbIndex(currCoord.x, currCoord.y, planet));
+			nextStrength = groundUnitTileStrength(gbIndex(nextCoord.x, nextCoord.y, planet));
 			gbIndex(currCoord.x, currCoord.y, planet).units[NUM_TILE_UNITS - 1] = { 0, 0, 0 };
 			gbIndex(nextCoord.x, nextCoord.y, planet).units[0].moving = 0;
+			settleTileStrength(currCoord.x, currCoord.y, currStrength);
+			settleTileStrength(nextCoord.x, nextCoord.y, nextStrength);
 
 			// Stops pathfinding.
 			goto cleanup;
@@ -1679,6 +1855,8 @@ void Battle::moveUnits() {
 			gbIndex(nextCoord.x, nextCoord.y, planet).units[0].unit == gbIndex(currCoord.x, currCoord.y, planet).units[NUM_TILE_UNITS - 1].unit) {
 
 			// Moves as many troops as possible to the target.
+			currStrength = groundUnitTileStrength(gbIndex(currCoord.x, currCoord.y, planet));
+			nextStrength = groundUnitTileStrength(gbIndex(nextCoord.x, nextCoord.y, planet));
 			quantity = 255 - gbIndex(nextCoord.x, nextCoord.y, planet).units[0].quantity;
 			quantity = quantity > gbIndex(currCoord.x, currCoord.y, planet).units[NUM_TILE_UNITS - 1].quantity ? gbIndex(currCoord.x, currCoord.y, planet).units[NUM_TILE_UNITS - 1].quantity : quantity;
 			gbIndex(nextCoord.x, nextCoord.y, planet).units[0].quantity += quantity;
@@ -1687,6 +1865,8 @@ void Battle::moveUnits() {
 			// Ends pathfinding for the unit.
 			if (!gbIndex(currCoord.x, currCoord.y, planet).units[NUM_TILE_UNITS - 1].quantity) gbIndex(currCoord.x, currCoord.y, planet).units[NUM_TILE_UNITS - 1] = { 0, 0, 0 };
 			else gbIndex(currCoord.x, currCoord.y, planet).units[NUM_TILE_UNITS - 1].moving = 0;
+			settleTileStrength(currCoord.x, currCoord.y, currStrength);
+			settleTileStrength(nextCoord.x, nextCoord.y, nextStrength);
 
 			// Stops pathfinding. Will fold this unit into a front if it is currently on one.
 			// Note that accurate front strengths require goto stop (this is not an appropriate place to check during debugging).
@@ -1707,8 +1887,12 @@ void Battle::moveUnits() {
 		else {
 
 			// Moves the unit.
+			currStrength = groundUnitTileStrength(gbIndex(currCoord.x, currCoord.y, planet));
+			nextStrength = groundUnitTileStrength(gbIndex(nextCoord.x, nextCoord.y, planet));
 			gbIndex(nextCoord.x, nextCoord.y, planet).units[NUM_TILE_UNITS - 1] = gbIndex(currCoord.x, currCoord.y, planet).units[NUM_TILE_UNITS - 1];
 			gbIndex(currCoord.x, currCoord.y, planet).units[NUM_TILE_UNITS - 1] = { 0, 0, 0 };
+			settleTileStrength(currCoord.x, currCoord.y, currStrength);
+			settleTileStrength(nextCoord.x, nextCoord.y, nextStrength);
 
 			// Moves on to the next node.
 			currNode = currNode->child;
@@ -1721,10 +1905,18 @@ void Battle::moveUnits() {
 	// Stops pathfinding and moves the current unit inward.
 	stop:
 
+		// A full destination is no longer a target, so the owner's flow fields are out of date.
+		// Orders blocked along the way or by a different unit leave the fields as they are.
+		if (currNode->value->y >= currNode->value->x && gbIndex(nextCoord.x, nextCoord.y, planet).units[0].quantity == 255 &&
+			gbIndex(nextCoord.x, nextCoord.y, planet).owner == gbIndex(currCoord.x, currCoord.y, planet).owner)
+			invalidateFlowFields(gbIndex(currCoord.x, currCoord.y, planet).owner);
+
 		// Moves units inwards when pathfinding fails and there are still surplus units available.
 		quantity = gbIndex(currCoord.x, currCoord.y, planet).units[NUM_TILE_UNITS - 1].quantity;
 		unit = gbIndex(currCoord.x, currCoord.y, planet).units[NUM_TILE_UNITS - 1].unit;
+		currStrength = groundUnitTileStrength(gbIndex(currCoord.x, currCoord.y, planet));
 		gbIndex(currCoord.x, currCoord.y, planet).units[NUM_TILE_UNITS - 1] = { 0, 0, 0 };
+		settleTileStrength(currCoord.x, currCoord.y, currStrength);
 		placeUnits(currCoord.x, currCoord.y, quantity, unit);
 
 	// Stops pathfinding and cleans up resources.
@@ -1746,63 +1938,130 @@ Diffuses units across fronts. Will attempt to keep the number of units of each t
 similar to the number of units on adjacent tiles. Will only transfer units from one front to another if the
 receiving front is in need of reinforcement.
 
+Large planets are split into bands of rows. Units only move between adjacent tiles, so bands which are not
+adjacent never touch the same tiles: even bands are diffused in parallel, followed by odd bands, followed by
+the poles. The result does not depend on the number of threads.
+
 TODO currently transfers to any adjacent available front. Should instead tranfer to only
 the current front unless the adjacent front is higher priority
 TODO currently only transfers unit[0]. Should transfer all units.
 */
 void Battle::diffuseUnits() {
-	uint_least8_t numTransferred;
-	int maxTransfer;
-	int xPos, yPos;
-	uint_least8_t* received = requestDummy();
-	memset(received, 0, planet->size * planet->size * sizeof(uint_least8_t));
+	int numBands = 1;
+	int* changes;
+	ScratchScope scratch;
+	uint_least8_t* received = scratch.zeroed<uint_least8_t>(planet->size * planet->size);
+
+	// Splits large planets into an even number of bands, so that the first and last bands are never
+	// diffused at the same time.
+	if (planet->size >= PARALLEL_BATTLE_WIDTH) numBands = (planet->size / BATTLE_BAND_ROWS) & ~1;
+	changes = scratch.zeroed<int>(numBands * 2 * comp.short1);
+
+	// Diffuses every front tile in order on small planets.
+	if (numBands == 1) {
+		frontTiles.forEach([&](int tile) {
+			int x, y;
+			deIndex(x, y, tile, planet->size);
+			diffuseTile(x, y, received, changes);
+
+		});
+	}
 
-	// Searches every tile on the planet for an available unit to split.
-	for (int x = 0; x < planet->size; ++x) {
-		for (int y = 0; y < planet->size; ++y) {
+	// Diffuses every band, then the poles.
+	else {
+		for (int parity = 0; parity < 2; ++parity) {
+			parallelFor(0, numBands / 2, 1, [this, parity, numBands, received, changes](int beg, int end) {
+				for (int band = beg * 2 + parity; band < end * 2; band += 2)
+					diffuseBand(band * planet->size / numBands, (band + 1) * planet->size / numBands, received, &changes[band * 2 * comp.short1]);
 
-			// If a tile with a front and a unit is found, attempts to diffuse units from the tile.
-			if (gbIndex(x, y, planet).front && gbIndex(x, y, planet).units[0].quantity) {
-				for (int i = -1; i < 2; ++i) {
-					for (int j = -1; j < 2; ++j) {
-						if (!i && !j) continue;
-						xPos = x + i;
-						yPos = y + j;
-						wrapAroundPlanet(planet->size, &xPos, &yPos);
-
-						// Transfers half of the difference between the two tile's unit counts if an adjacent tile has the same unit type
-						// and has less units than the current tile. Tiles cannot supply units that they have just received.
-						// Tiles can also supply to empty tiles which have a viable terrain type for the transfering unit.
-						if (gbIndex(xPos, yPos, planet).owner == gbIndex(x, y, planet).owner && gbIndex(xPos, yPos, planet).front && // Same owner and front exists.
-							!gbIndex(x, y, planet).units[0].moving && !gbIndex(xPos, yPos, planet).units[0].moving && // Neither units are moving
-							(gbIndex(xPos, yPos, planet).units[0].unit == gbIndex(x, y, planet).units[0].unit || // Same unit.
-								(!gbIndex(xPos, yPos, planet).units[0].unit && canOccupyTerrain(xPos, yPos, gbUnitTemplate(x, y, 0, planet)))) && // Or empty with correct type
-							gbIndex(xPos, yPos, planet).units[0].quantity < gbIndex(x, y, planet).units[0].quantity) { // Destination has lower quantity.
-
-							// Maximum number of units which this tile can transfer.
-							maxTransfer = gbIndex(x, y, planet).units[0].quantity - received[index(x, y, planet->size)];
-							if (maxTransfer <= 0) continue;
-
-							// Transfers units between the fronts.
-							numTransferred = (gbIndex(x, y, planet).units[0].quantity - gbIndex(xPos, yPos, planet).units[0].quantity) / 2;
-							if (numTransferred > maxTransfer) numTransferred = maxTransfer;
-							gbIndex(x, y, planet).units[0].quantity -= numTransferred;
-							gbIndex(xPos, yPos, planet).units[0].quantity += numTransferred;
-							gbIndex(xPos, yPos, planet).units[0].unit = gbIndex(x, y, planet).units[0].unit;
-
-							// Tracks the number of units this tile has received.
-							received[index(xPos, yPos, planet->size)] += numTransferred;
+			});
+		}
+		diffusePoles(received, changes);
+
+	}
+
+	// Adds the strength and enemy strength changes of every band to the fronts.
+	for (int band = 0; band < numBands; ++band) {
+		for (int front = 0; front < comp.short1; ++front) {
+			fronts[front].strength += changes[band * 2 * comp.short1 + front];
+			fronts[front].enemyStrength += changes[(band * 2 + 1) * comp.short1 + front];
 
-						}
-					}
-				}
-			}
 		}
 	}
+}
+
+/*
+Diffuses units from the front tiles within rows [begRow, endRow). Units may be diffused into the rows
+adjacent to the band. Tiles on the poles are skipped, since they are adjacent to tiles half way around
+the planet; diffusePoles handles them once every band is done.
+*/
+void Battle::diffuseBand(int begRow, int endRow, uint_least8_t* received, int* changes) {
+	frontTiles.forEachIn(begRow * planet->size, endRow * planet->size, [&](int tile) {
+		int x, y;
+		deIndex(x, y, tile, planet->size);
+		if (y != 0 && y != planet->size - 1) diffuseTile(x, y, received, changes);
+
+	});
+}
+
+/*
+Diffuses units from the front tiles on both poles.
+*/
+void Battle::diffusePoles(uint_least8_t* received, int* changes) {
+	for (int x = 0; x < planet->size; ++x) {
+		if (frontTiles.has(index(x, 0, planet->size))) diffuseTile(x, 0, received, changes);
+		if (frontTiles.has(index(x, planet->size - 1, planet->size))) diffuseTile(x, planet->size - 1, received, changes);
+
+	}
+}
 
-	// Releases the received dummy.
-	releaseDummy(received);
+/*
+Diffuses units from a tile into its adjacent tiles. Strength and enemy strength changes are counted
+into changes rather than into fronts.
+*/
+inline void Battle::diffuseTile(int x, int y, uint_least8_t* received, int* changes) {
+	uint_least8_t numTransferred;
+	int maxTransfer;
+	PlanetGrid* grid = planet->grid();
+	int padded;
+	int sourceStrength, destStrength;
+
+	// If a tile with a front and a unit is found, attempts to diffuse units from the tile.
+	if (gbIndex(x, y, planet).front && gbIndex(x, y, planet).units[0].quantity) {
+		padded = grid->pad(x, y);
+		for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+			const PlanetCell& cell = grid->cell(padded, grid->adjacent[d]);
+
+			// Transfers half of the difference between the two tile's unit counts if an adjacent tile has the same unit type
+			// and has less units than the current tile. Tiles cannot supply units that they have just received.
+			// Tiles can also supply to empty tiles which have a viable terrain type for the transfering unit.
+			if (battlefield[cell.tile].owner == gbIndex(x, y, planet).owner && battlefield[cell.tile].front && // Same owner and front exists.
+				!gbIndex(x, y, planet).units[0].moving && !battlefield[cell.tile].units[0].moving && // Neither units are moving
+				(battlefield[cell.tile].units[0].unit == gbIndex(x, y, planet).units[0].unit || // Same unit.
+					(!battlefield[cell.tile].units[0].unit && canOccupyTerrain(cell.x, cell.y, gbUnitTemplate(x, y, 0, planet)))) && // Or empty with correct type
+				battlefield[cell.tile].units[0].quantity < gbIndex(x, y, planet).units[0].quantity) { // Destination has lower quantity.
+
+				// Maximum number of units which this tile can transfer.
+				maxTransfer = gbIndex(x, y, planet).units[0].quantity - received[index(x, y, planet->size)];
+				if (maxTransfer <= 0) continue;
+
+				// Transfers units between the fronts.
+				numTransferred = (gbIndex(x, y, planet).units[0].quantity - battlefield[cell.tile].units[0].quantity) / 2;
+				if (numTransferred > maxTransfer) numTransferred = maxTransfer;
+				sourceStrength = groundUnitTileStrength(gbIndex(x, y, planet));
+				destStrength = groundUnitTileStrength(battlefield[cell.tile]);
+				gbIndex(x, y, planet).units[0].quantity -= numTransferred;
+				battlefield[cell.tile].units[0].quantity += numTransferred;
+				battlefield[cell.tile].units[0].unit = gbIndex(x, y, planet).units[0].unit;
+				countStrengthChange(x, y, sourceStrength, changes);
+				countStrengthChange(cell.x, cell.y, destStrength, changes);
+
+				// Tracks the number of units this tile has received.
+				received[cell.tile] += numTransferred;
 
+			}
+		}
+	}
 }
 
 /*
@@ -1811,92 +2070,88 @@ If there is no adjacent enemy to attack, attempts to conquer an adjacent tile.
 */
 void Battle::attackUnits() {
 	uint_least8_t attackerQuantity, defenderQuantity;
+	int attackerStrength, defenderStrength;
 	uint_least16_t tempFront;
-	int xPos, yPos;
+	PlanetGrid* grid = planet->grid();
+	int padded;
 	uint_least8_t* conquered;
+	ScratchScope scratch;
 
 	// Uses a dummy to track which tiles have been conquered this far.
-	conquered = requestDummy();
-	memset(conquered, 0, planet->size * planet->size * sizeof(uint_least8_t));
+	conquered = scratch.zeroed<uint_least8_t>(planet->size * planet->size);
 
-	// Checks every tile on the planet for a unit.
-	for (int x = 0; x < planet->size; ++x) {
-		for (int y = 0; y < planet->size; ++y) {
+	// Checks every border tile for a unit. Other tiles have no enemy to attack or conquer.
+	borderTiles.forEach([&](int tile) {
+		int x, y;
+		deIndex(x, y, tile, planet->size);
 
-			// Will only attack when there is a unit to attack with.
-			if (gbIndex(x, y, planet).units[0].unit && !gbIndex(x, y, planet).units[0].moving) {
+		// Will only attack when there is a unit to attack with.
+		if (gbIndex(x, y, planet).units[0].unit && !gbIndex(x, y, planet).units[0].moving) {
 
-				// Attempts to find a unit to launch an attack against.
-				for (int i = -1; i < 2; ++i) {
-					for (int j = -1; j < 2; ++j) {
-						if (!i && !j) continue;
-						xPos = x + i;
-						yPos = y + j;
-						wrapAroundPlanet(planet->size, &xPos, &yPos);
+			// Attempts to find a unit to launch an attack against.
+			padded = grid->pad(x, y);
+			for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+				const PlanetCell& cell = grid->cell(padded, grid->adjacent[d]);
 
-						// When an adjacent enemy tile is found, performs a battle.
-						if (comp.comp(gbIndex(x, y, planet).owner, gbIndex(xPos, yPos, planet).owner) && gbIndex(xPos, yPos, planet).units[0].quantity) {
-							attackerQuantity = gbIndex(x, y, planet).units[0].quantity;
-							defenderQuantity = gbIndex(xPos, yPos, planet).units[0].quantity;
+				// When an adjacent enemy tile is found, performs a battle.
+				if (comp.comp(gbIndex(x, y, planet).owner, battlefield[cell.tile].owner) && battlefield[cell.tile].units[0].quantity) {
+					attackerQuantity = gbIndex(x, y, planet).units[0].quantity;
+					defenderQuantity = battlefield[cell.tile].units[0].quantity;
+					attackerStrength = groundUnitTileStrength(gbIndex(x, y, planet));
+					defenderStrength = groundUnitTileStrength(battlefield[cell.tile]);
 
-							// Calculates the casualties of the attackers and defenders.
-							determineGroundCasualties(owners[gbIndex(x, y, planet).owner].unitTable[gbIndex(x, y, planet).units[0].unit],
-								owners[gbIndex(xPos, yPos, planet).owner].unitTable[gbIndex(xPos, yPos, planet).units[0].unit],
-								&gbIndex(x, y, planet).units[0].quantity, &gbIndex(xPos, yPos, planet).units[0].quantity);
+					// Calculates the casualties of the attackers and defenders.
+					determineGroundCasualties(owners[gbIndex(x, y, planet).owner].unitTable[gbIndex(x, y, planet).units[0].unit],
+						owners[battlefield[cell.tile].owner].unitTable[battlefield[cell.tile].units[0].unit],
+						&gbIndex(x, y, planet).units[0].quantity, &battlefield[cell.tile].units[0].quantity);
 
-							// Clears depleted units.
-							if (!gbIndex(x, y, planet).units[0].quantity) moveUnitsInwards(0, gbIndex(x, y, planet));
-							if (!gbIndex(xPos, yPos, planet).units[0].quantity) moveUnitsInwards(0, gbIndex(xPos, yPos, planet));
+					// Clears depleted units.
+					if (!gbIndex(x, y, planet).units[0].quantity) moveUnitsInwards(0, gbIndex(x, y, planet));
+					if (!battlefield[cell.tile].units[0].quantity) moveUnitsInwards(0, battlefield[cell.tile]);
 
-							// Will not attempt to launch more attacks from this tile.
-							goto exit;
+					// Adjusts front strengths.
+					settleTileStrength(x, y, attackerStrength);
+					settleTileStrength(cell.x, cell.y, defenderStrength);
+
+					// Will not attempt to launch more attacks from this tile.
+					goto exit;
 
-						}
-					}
 				}
+			}
 
-			// Exit point after an attack is performed.
-			exit:;
+		// Exit point after an attack is performed.
+		exit:;
 
-				// Will perform this action if and only if a unit remains.
-				if (gbIndex(x, y, planet).units[0].unit) {
+			// Will perform this action if and only if a unit remains.
+			if (gbIndex(x, y, planet).units[0].unit) {
 
-					// Conquers nearby empty enemy tiles which have not already been conquered this turn.
-					for (int i = -1; i < 2; ++i) {
-						for (int j = -1; j < 2; ++j) {
-							if (!i && !j) continue;
-							xPos = x + i;
-							yPos = y + j;
-							wrapAroundPlanet(planet->size, &xPos, &yPos);
+				// Conquers nearby empty enemy tiles which have not already been conquered this turn.
+				for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+					const PlanetCell& cell = grid->cell(padded, grid->adjacent[d]);
 
-							// Conquers nearby unoccupied enemy tiles which the conquering unit can occupy.
-							// Note: It is assumed that units[0].unit will be 0 if and only if all enemy units in the tile
-							// have been destroyed.
-							if (!conquered[index(xPos, yPos, planet->size)] && !gbIndex(xPos, yPos, planet).units[0].unit &&
-								/*canOccupyTerrain(xPos, yPos, gbUnitTemplate(x, y, 0, planet)) &&*/
-								comp.comp(gbIndex(x, y, planet).owner, gbIndex(xPos, yPos, planet).owner)) {
+					// Conquers nearby unoccupied enemy tiles which the conquering unit can occupy.
+					// Note: It is assumed that units[0].unit will be 0 if and only if all enemy units in the tile
+					// have been destroyed.
+					if (!conquered[cell.tile] && !battlefield[cell.tile].units[0].unit &&
+						/*canOccupyTerrain(cell.x, cell.y, gbUnitTemplate(x, y, 0, planet)) &&*/
+						comp.comp(gbIndex(x, y, planet).owner, battlefield[cell.tile].owner)) {
 
-								// Marks the tile as conquered so it will not flutter.
-								conquered[index(xPos, yPos, planet->size)] = 1;
+						// Marks the tile as conquered so it will not flutter.
+						conquered[cell.tile] = 1;
 
-								// Removes control of the tile from its current owner.
-								tempFront = gbIndex(xPos, yPos, planet).front;
-								--fronts[tempFront].numTiles;
-								gbIndex(xPos, yPos, planet).front = 0; // Needs to be done for findAdjacentEnemyStrength and extendFronts to work.
+						// Removes control of the tile from its current owner.
+						tempFront = battlefield[cell.tile].front;
+						--fronts[tempFront].numTiles;
+						reassignTile(cell.x, cell.y, battlefield[cell.tile].owner, 0); // Needs to be done for extendFronts to work.
 
-								// Places the tile under control of the attacker.
-								extendFronts(xPos, yPos, gbIndex(x, y, planet).owner);
+						// Places the tile under control of the attacker.
+						extendFronts(cell.x, cell.y, gbIndex(x, y, planet).owner);
 
-							}
-						}
 					}
 				}
 			}
 		}
-	}
-
-	// Returns conquered.
-	releaseDummy(conquered);
+	});
 
 }
 
@@ -1909,6 +2164,7 @@ void Battle::navalInvade() {
 	uint_least8_t unit;
 	uint_least8_t quantity;
 	uint_least8_t owner;
+	int before;
 
 	// Finds harbours which contain more than 200 units.
 	for (int x = 0; x < planet->size; ++x) {
@@ -1922,9 +2178,11 @@ void Battle::navalInvade() {
 				// Pathfinds to the nearest unowned harbour.
 				// Marks the unit as moving.
 				// TODO make sure that 2 is not overwritten
+				before = groundUnitTileStrength(gbIndex(x, y, planet));
 				gbIndex(x, y, planet).units[NUM_TILE_UNITS - 1] = gbIndex(x, y, planet).units[x];
 				gbIndex(x, y, planet).units[x] = { 0, 0, 0 };
 				gbIndex(x, y, planet).units[NUM_TILE_UNITS - 1].moving = 1;
+				settleTileStrength(x, y, before);
 				unit = gbIndex(x, y, planet).units[NUM_TILE_UNITS - 1].unit;
 				quantity = gbIndex(x, y, planet).units[NUM_TILE_UNITS - 1].quantity;
 				owner = gbIndex(x, y, planet).owner;
@@ -1990,57 +2248,291 @@ void Battle::navalInvade() {
 }
 
 /*
-Calculates and assigns front strength.
+Recounts and assigns the strength and enemy strength of every front. Both are otherwise
+maintained as units and tiles change, so this is only needed when a Battle is created or loaded.
 */
 void Battle::calcFrontStrength() {
-	int xPos, yPos;
-	uint_least32_t strengths[MAX_GROUND_FRONTS];
-	uint_least32_t enemyStrengths[MAX_GROUND_FRONTS];
-	memset(strengths, 0, sizeof(strengths[0]) * MAX_GROUND_FRONTS);
-	memset(enemyStrengths, 0, sizeof(enemyStrengths[0]) * MAX_GROUND_FRONTS);
-	uint_least8_t* dummy;
+	ScratchScope scratch;
+	GroundFront* measured = scratch.array<GroundFront>(comp.short1);
 
-	// Gets dummy, an array of bitarrays used to track adjacency for fronts.
-	dummy = requestLargeDummy();
-	memset(dummy, 0, planet->size * planet->size * 64);
+	// Counts and assigns the strengths.
+	measureFrontStrength(measured);
+	for (int i = 0; i < comp.short1; ++i) {
+		fronts[i].strength = measured[i].strength;
+		fronts[i].enemyStrength = measured[i].enemyStrength;
 
-	// Finds strengths.
-	for (int i = 0; i < planet->size * planet->size; ++i) if (battlefield[i].owner) strengths[battlefield[i].front] += groundUnitTileStrength(battlefield[i]);
+	}
 
-	// Checks every tile.
-	for (int i = 0; i < planet->size; ++i) {
-		for (int j = 0; j < planet->size; ++j) {
+}
 
-			// Gets enemy strengths.
-			if (gbIndex(i, j, planet).front) {
-				for (int x = -1; x < 2; ++x) {
-					for (int y = -1; y < 2; ++y) {
-						if (!x && !y) continue;
-						xPos = i + x;
-						yPos = j + y;
-						wrapAroundPlanet(planet->size, &xPos, &yPos);
+/*
+Counts the strength of every front from scratch into the inputed fronts. Only strength and
+enemyStrength are written.
+*/
+void Battle::measureFrontStrength(GroundFront* measured) {
+	int strength;
 
-						// If at war and not already counted, adds enemyStrength.
-						if (comp.comp(gbIndex(i, j, planet).owner, gbIndex(xPos, yPos, planet).owner) && !readArrBit(&dummy[index(xPos, yPos, planet->size) * 64], gbIndex(i, j, planet).front)) {
-							enemyStrengths[gbIndex(i, j, planet).front] += groundUnitTileStrength(gbIndex(xPos, yPos, planet));
-							writeArrBit(&dummy[index(xPos, yPos, planet->size) * 64], gbIndex(i, j, planet).front, 1);
+	// Zeros the strengths.
+	for (int i = 0; i < comp.short1; ++i) {
+		measured[i].strength = 0;
+		measured[i].enemyStrength = 0;
+
+	}
+
+	// Counts every tile which contains units.
+	for (int x = 0; x < planet->size; ++x) {
+		for (int y = 0; y < planet->size; ++y) {
+			if (strength = groundUnitTileStrength(gbIndex(x, y, planet))) countTileStrength(x, y, strength, measured);
 
-						}
-					}
-				}
-			}
 		}
 	}
+}
 
-	// Release the dummy.
-	releaseLargeDummy(dummy);
+/*
+Compares every front's maintained strength and enemy strength against a full recount and prints
+any discrepancy. The recount is then assigned so that one discrepancy is not reported every tick.
+*/
+bool Battle::verifyFrontStrength() {
+	bool discrepancy = false;
+	ScratchScope scratch;
+	GroundFront* measured = scratch.array<GroundFront>(comp.short1);
 
-	// Assigns the strengths.
+	// Compares the maintained strengths with the recount.
+	measureFrontStrength(measured);
 	for (int i = 0; i < comp.short1; ++i) {
-		fronts[i].strength = strengths[i];
-		fronts[i].enemyStrength = enemyStrengths[i];
+		if (fronts[i].strength != measured[i].strength) {
+			fprintf(stderr, "front[%d] : strength %u measured %u\n", i, fronts[i].strength, measured[i].strength);
+			fronts[i].strength = measured[i].strength;
+			discrepancy = true;
+
+		}
+		if (fronts[i].enemyStrength != measured[i].enemyStrength) {
+			fprintf(stderr, "front[%d] : enemy strength %u measured %u\n", i, fronts[i].enemyStrength, measured[i].enemyStrength);
+			fronts[i].enemyStrength = measured[i].enemyStrength;
+			discrepancy = true;
+
+		}
+	}
+
+	return discrepancy;
+
+}
+
+/*
+Adds strength to the front of the inputed tile, and to the enemy strength of every front at war
+with the tile that has a tile adjacent to it. Each enemy front is only counted once.
+*/
+inline void Battle::countTileStrength(int x, int y, int strength, GroundFront* target) {
+	uint_least16_t enemyFronts[PLANET_NEIGHBOURS];
+	int numEnemyFronts = findEnemyFronts(x, y, enemyFronts);
+	GroundBattleTile& tile = gbIndex(x, y, planet);
+
+	// Counts the strength towards the tile's front.
+	if (tile.owner) target[tile.front].strength += strength;
+
+	// Counts the strength towards each adjacent enemy front.
+	for (int i = 0; i < numEnemyFronts; ++i) target[enemyFronts[i]].enemyStrength += strength;
+
+}
+
+/*
+Finds the fronts at war with the inputed tile which have a tile adjacent to it. Each front is only
+listed once. Returns the number of fronts found.
+*/
+inline int Battle::findEnemyFronts(int x, int y, uint_least16_t* enemyFronts) {
+	PlanetGrid* grid = planet->grid();
+	int padded = grid->pad(x, y);
+	int numFronts = 0;
+	int counted;
+	uint_least16_t front;
+	GroundBattleTile& tile = gbIndex(x, y, planet);
+
+	for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+		const PlanetCell& cell = grid->cell(padded, grid->adjacent[d]);
+		front = battlefield[cell.tile].front;
+		if (!front || !comp.comp(battlefield[cell.tile].owner, tile.owner)) continue;
+
+		// Skips fronts which have already been found.
+		for (counted = 0; counted < numFronts && enemyFronts[counted] != front; ++counted);
+		if (counted == numFronts) enemyFronts[numFronts++] = front;
 
 	}
+
+	return numFronts;
+
+}
+
+/*
+Adds the inputed strength, measured from the inputed tile, to each enemy front adjacent to the tile.
+*/
+inline void Battle::countEnemyStrength(int x, int y, int strength) {
+	uint_least16_t enemyFronts[PLANET_NEIGHBOURS];
+	int numEnemyFronts = findEnemyFronts(x, y, enemyFronts);
+
+	for (int i = 0; i < numEnemyFronts; ++i) fronts[enemyFronts[i]].enemyStrength += strength;
+
+}
+
+/*
+Adds sign times the strength of the inputed tile, and of the tiles to which it is adjacent, to their enemy
+fronts. Only these tiles have enemy fronts which depend on the owner and front of the inputed tile. Called
+with sign -1 before the tile changes and with sign 1 after, passing the owner and front which the tile is
+changing to or from. Tiles without units, and tiles whose enemy fronts are the same either way, are skipped.
+*/
+inline void Battle::countEnemyStrengthAround(int x, int y, int otherOwner, uint_least16_t otherFront, int sign) {
+	PlanetGrid* grid = planet->grid();
+	const PlanetCell* incoming = &grid->incoming[index(x, y, planet->size) * PLANET_NEIGHBOURS];
+	GroundBattleTile& tile = gbIndex(x, y, planet);
+	bool counted, otherCounted;
+	int strength;
+
+	// Counts the tile itself. Its enemy fronts only depend on its owner.
+	if (tile.owner != otherOwner && (strength = groundUnitTileStrength(tile))) countEnemyStrength(x, y, sign * strength);
+
+	// Counts each tile to which the tile is adjacent if the tile's front counts towards it differently.
+	for (int d = 0; d < PLANET_NEIGHBOURS; ++d) {
+		GroundBattleTile& adjacent = battlefield[incoming[d].tile];
+		if (!(strength = groundUnitTileStrength(adjacent))) continue;
+		counted = tile.front && comp.comp(tile.owner, adjacent.owner);
+		otherCounted = otherFront && comp.comp(otherOwner, adjacent.owner);
+		if (counted == otherCounted && (!counted || tile.front == otherFront)) continue;
+		countEnemyStrength(incoming[d].x, incoming[d].y, sign * strength);
+
+	}
+}
+
+/*
+Assigns the owner and front of a tile, moving its strength from its old front to its new front.
+Enemy strengths are taken out for the tile and the tiles around it, then counted again once
+the tile has changed.
+*/
+inline void Battle::reassignTile(int x, int y, int owner, uint_least16_t front) {
+	GroundBattleTile& tile = gbIndex(x, y, planet);
+	int strength = groundUnitTileStrength(tile);
+	bool ownerChanged = tile.owner != owner;
+
+	// Flow fields are seeded from front tiles and spread through owned tiles, so the fields of the old
+	// and new owners are out of date if the tile changes hands or joins or leaves a front.
+	if (ownerChanged || !tile.front != !front) {
+		if (tile.owner) invalidateFlowFields(tile.owner);
+		if (owner) invalidateFlowFields(owner);
+
+	}
+
+	// Does nothing more if the tile is unchanged.
+	if (!ownerChanged && tile.front == front) return;
+
+	int oldOwner = tile.owner;
+	uint_least16_t oldFront = tile.front;
+	countEnemyStrengthAround(x, y, owner, front, -1);
+	if (tile.owner) fronts[tile.front].strength -= strength;
+	tile.owner = owner;
+	tile.front = front;
+	if (tile.owner) fronts[tile.front].strength += strength;
+
+	// Updates the tile sets. A change of owner can change whether the tile, or any tile it is adjacent to,
+	// is a border.
+	frontTiles.assign(index(x, y, planet->size), front);
+	if (ownerChanged) {
+		PlanetGrid* grid = planet->grid();
+		const PlanetCell* incoming = &grid->incoming[index(x, y, planet->size) * PLANET_NEIGHBOURS];
+		updateBorderTile(x, y);
+		for (int d = 0; d < PLANET_NEIGHBOURS; ++d) updateBorderTile(incoming[d].x, incoming[d].y);
+
+	}
+
+	countEnemyStrengthAround(x, y, oldOwner, oldFront, 1);
+
+}
+
+/*
+Builds frontTiles and borderTiles from the battlefield.
+*/
+void Battle::initTileSets() {
+	frontTiles.init(planet->size * planet->size);
+	borderTiles.init(planet->size * planet->size);
+
+	for (int x = 0; x < planet->size; ++x) {
+		for (int y = 0; y < planet->size; ++y) {
+			frontTiles.assign(index(x, y, planet->size), gbIndex(x, y, planet).front);
+			updateBorderTile(x, y);
+
+		}
+	}
+}
+
+/*
+Checks whether a tile is adjacent to a tile at war with its owner, and adds it to or removes it
+from borderTiles accordingly.
+*/
+inline void Battle::updateBorderTile(int x, int y) {
+	PlanetGrid* grid = planet->grid();
+	int padded = grid->pad(x, y);
+	bool border = false;
+
+	for (int d = 0; d < PLANET_NEIGHBOURS && !border; ++d) border = comp.comp(gbIndex(x, y, planet).owner, battlefield[grid->cell(padded, grid->adjacent[d]).tile].owner);
+	borderTiles.assign(index(x, y, planet->size), border);
+
+}
+
+/*
+Compares frontTiles and borderTiles against the battlefield and prints any discrepancy.
+*/
+bool Battle::verifyTileSets() {
+	PlanetGrid* grid = planet->grid();
+	int padded;
+	bool border;
+	bool discrepancy = false;
+
+	for (int x = 0; x < planet->size; ++x) {
+		for (int y = 0; y < planet->size; ++y) {
+			padded = grid->pad(x, y);
+			border = false;
+			for (int d = 0; d < PLANET_NEIGHBOURS; ++d) border |= comp.comp(gbIndex(x, y, planet).owner, battlefield[grid->cell(padded, grid->adjacent[d]).tile].owner);
+
+			// Prints tiles which are misplaced in either set.
+			if (frontTiles.has(index(x, y, planet->size)) != (bool)gbIndex(x, y, planet).front || borderTiles.has(index(x, y, planet->size)) != border) {
+				fprintf(stderr, "tile (%d, %d) : front %d in set %d, border %d in set %d\n", x, y, (int)gbIndex(x, y, planet).front,
+					(int)frontTiles.has(index(x, y, planet->size)), (int)border, (int)borderTiles.has(index(x, y, planet->size)));
+				discrepancy = true;
+
+			}
+		}
+	}
+
+	return discrepancy;
+
+}
+
+/*
+Counts the change in a tile's strength since it was measured as before, towards its front and
+its adjacent enemy fronts.
+*/
+inline void Battle::settleTileStrength(int x, int y, int before) {
+	GroundBattleTile& tile = gbIndex(x, y, planet);
+	int change = groundUnitTileStrength(tile) - before;
+
+	if (!change) return;
+	if (tile.owner) fronts[tile.front].strength += change;
+	countEnemyStrength(x, y, change);
+
+}
+
+/*
+Counts the change in a tile's strength since it was measured as before into changes. The first
+comp.short1 changes are strengths and the next comp.short1 are enemy strengths, indexed by front.
+*/
+inline void Battle::countStrengthChange(int x, int y, int before, int* changes) {
+	GroundBattleTile& tile = gbIndex(x, y, planet);
+	int change = groundUnitTileStrength(tile) - before;
+	uint_least16_t enemyFronts[PLANET_NEIGHBOURS];
+	int numEnemyFronts;
+
+	if (!change) return;
+	if (tile.owner) changes[tile.front] += change;
+	numEnemyFronts = findEnemyFronts(x, y, enemyFronts);
+	for (int i = 0; i < numEnemyFronts; ++i) changes[comp.short1 + enemyFronts[i]] += change;
+
 }
 
 // gbIndex and gbUnitTemplate are not useful outside of Battles.
@@ -1,25 +1,23 @@
 #pragma once
 
 /*
-Manages battles for a page of planets.
+Manages battles for a range of the warPlanets.
 */
-void planetBattle() {
-	int page;
+void planetBattle(int beg, int end) {
 
-	// Performs planetary battles for each HabitablePage.
-	while ((page = requestHabitablePage()) >= 0) {
+	// Performs planetary battles for each HabitablePlanet in the range.
+	for (int i = beg; i < end; ++i) warPlanets.planets[i]->battle->battle();
 
-		// Performs planetary battles for all HabitablePlanets on a page.
-		for (int i = 0; i < habitablePages[page]->arrCurrPlanet; ++i)
-			if (habitablePages[page]->planets[i].battle) habitablePages[page]->planets[i].battle->battle();
-
-	}
 }
 
 /*
-Performs Battles on every planet containing a Battle.
+Performs Battles on every planet containing a Battle. Only the warPlanets are visited, one planet per
+task, since Battles differ greatly in cost.
 */
 void groundBattles() {
-	planetBattle();
+	ProfileScope scope(GROUND_BATTLES_ZONE);
+	parallelFor(0, warPlanets.numPlanets, 1, [](int beg, int end) {
+		planetBattle(beg, end);
 
-}
\ No newline at end of file
+	});
+}
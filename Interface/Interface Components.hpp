@@ -132,15 +132,14 @@ public:
 };
 
 /*
-Default constructor for Button.
+Default constructor for Button. The Button has no text until it is reinitialized. Creates no texture,
+since default Buttons are constructed statically, before SDL is initialized.
 */
 Button::Button() {
 	Button::buttonColour = {0, 0, 0, 0};
 	Button::area = { 0, 0, 0, 0 };
 	textArea = {0, 0, 0, 0};
-	SDL_Surface* textSurface = TTF_RenderText_Blended(defaultFont, "", {0, 0, 0, 0xFF});
-	Button::buttonText = SDL_CreateTextureFromSurface(renderer, textSurface);
-	SDL_FreeSurface(textSurface);
+	Button::buttonText = NULL;
 
 }
 
@@ -162,7 +161,7 @@ Button::Button(int x, int y, int w, int h, Uint8 r, Uint8 g, Uint8 b, std::strin
 Deconstructor for Button. Deletes buttonText and buttonColour.
 */
 Button::~Button() {
-	SDL_DestroyTexture(buttonText);
+	if (buttonText) SDL_DestroyTexture(buttonText);
 	buttonText = NULL;
 
 }
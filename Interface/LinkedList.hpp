@@ -15,9 +15,8 @@ struct LinkedListNode {
 Simple class representing a singly linked list.
 Since it is used for pathfinding, there are certain pathfinding specific methods.
 	i.e. addcAsc.
-To save cycles, there are several global lists of PathCoordinates corresponding to the amount of
-threads available to the computer. These lists can be requested via the requestcoordlist function,
-and reduce redundancy by reducing creation/destruction of LinkedListNodes.
+To save cycles, pathfinding functions reuse LinkedListNodes through a CoordList (see
+Pathfinding.hpp), which reduces redundancy by reducing creation/destruction of LinkedListNodes.
 Methods which are useful for getting coords generally contain a c. i.e. addcAsc, popc, etc.
 
 This class takes 16 bytes.
@@ -3,81 +3,45 @@
 // Number of threads that the program will have access to.
 int numThreads;
 
-// Array containing threads for this program.
+// Array containing the scheduler's worker threads for this program. threads[0] is
+// unused, since index 0 belongs to whichever thread is submitting tasks.
 std::thread** threads;
 
-// Main thread for the gameLoop, this thread will manage semaphores and other
-// threading tasks between turns in the gameLoop.
+// Main thread for the gameLoop, this thread will submit the tasks for each turn.
 std::thread* gameLoopThread;
 
-// Available threads. 1 encodes availability.
-bool* currThreads;
-
-// Threads to clean. 1 encodes attention needed.
-bool* cleanThreads;
+// Index of the calling thread within the scheduler. Worker threads take indices
+// 1 to numThreads - 1. All other threads (main, gameLoop) share index 0.
+thread_local int workerIndex = 0;
 
 // Array containing shared_mutexes for every possible yPos in the Universe.
 // Used to make sure that multithreading Squadrons is effective.
 std::shared_mutex* universeMutexes;
 
-// Stores dummies for use when parsing planets, galaxies, or the universe.
-// Availability is at the -1st index of each dummy.
-// Dummy size is at the -1st index of threadDummies. It is size (in bytes) + 1.
-// threadDummies starts on the -1st index of the first dummy.
-uint_least8_t* threadDummies;
-
-// Stores larger dummies for parsing over planets.
-// Same as above.
-uint_least8_t* threadLargeDummies;
-
 // Informs worker threads that the process is exiting gameplay.
 bool exitFlag;
 
-// Special verison of rand_s that returns an int and ignores errors.
-int randS();
-
-// Initializes all data needed for threading.
-void initThreading();
-
-// Returns the next available thread's index in threads.
-int demandThread();
+// Seeds every random stream. Streams are derived from this seed.
+void seedRandom(uint64_t seed);
 
-// Waits for all threads to finish execution. Joins and deletes all of them.
-void joinAllThreads();
+// Seeds the calling thread's generator with a stream derived from the seed.
+void seedRandomStream(uint64_t stream);
 
-// Joins threads which have finished execution and cleans up their memory.
-void joinComplete();
-
-// Creates numThreads dummies of size size. They are either the size of the universe or
-// the largest possible planet, whichever's larger.
-void initDummies(int size);
-uint_least8_t* requestDummy();
-void releaseDummy(uint_least8_t* dummy);
-
-// Similar to the above, creates large dummies whose indices have enough space
-// to store a bitarray containing 256 elements.
-// Should be equal to the size of the largest planet, as it is used only in
-// Ground Armies Battle->calcFrontStrength.
-void initLargeDummies(int size);
-uint_least8_t* requestLargeDummy();
-void releaseLargeDummy(uint_least8_t* dummy);
+// Returns a random non-negative int.
+int randS();
 
-// Reads and writes bits in bitarrays.
-inline bool readArrBit(uint_least8_t* arr, int bit);
-inline void writeArrBit(uint_least8_t* arr, int bit, bool write);
+// Initializes all data needed for threading. Uses every hardware thread if threadCount is 0.
+void initThreading(int threadCount = 0);
 
-// Requests an integer.
-int requestInt();
+// Stops and joins the scheduler's worker threads.
+void shutdownThreading();
 
-// Resets the integer counter.
-void resetInt();
+// Loop run by each worker thread of the scheduler.
+void workerLoop(int index);
 
 // Requests a galaxy.
 int requestGalaxy();
 
-// Returns a galaxy.
-void releaseGalaxy(int index);
-
 // Returns all galaxies.
 void releaseAllGalaxies();
 
@@ -117,400 +81,546 @@ public:
 	}
 };
 
-// Global semaphore used to manage threads.
+// Global semaphore used to hand control between the interface and the gameLoop thread.
 Semaphore threadingSemaphore(0, 0);
 
 /*
-Special verison of rand_s that returns an int and ignores errors.
+Hands out the indices 0 to end - 1, each exactly once, to any number of threads. A claim is a
+single fetch_add, so threads never wait on one another. Indices are not returned individually;
+the whole range is returned at once by reset, which starts a new round of dispatch.
 */
-inline int randS() {
-	unsigned int temp;
-	rand_s(&temp);
-	return temp & 2147483647;
+class DispatchCursor {
+public:
+	std::atomic<int> next;
+	int end;
 
-}
+	// Constructor. Starts out exhausted.
+	DispatchCursor() : next(0), end(0) { }
 
-/*
-Special version of rand_s that returns an unsigned int and ignores errors.
-*/
-inline unsigned int randU() {
-	unsigned int temp;
-	rand_s(&temp);
-	return temp;
+	// Starts a new round of dispatch over [0, newEnd). Must not be called while threads are claiming.
+	inline void reset(int newEnd) {
+		end = newEnd;
+		next.store(0, std::memory_order_release);
 
-}
+	}
+
+	// Claims the next index. Returns -1 once every index has been claimed.
+	inline int claim() {
+		int i = next.fetch_add(1, std::memory_order_acq_rel);
+		return i < end ? i : -1;
+
+	}
+};
 
 /*
-Special version of rand_s that returns a handful of bits.
-Note that randB can at most return 32 bits.
+Tracks which of a fixed number of reusable items are in use. Pools hold one item per thread, so
+a claim starts at the calling thread's own slot and almost always succeeds on its first exchange.
 */
-inline unsigned int randB(int n) {
-	thread_local static unsigned int input = 0;
-	unsigned int output;
+class SlotPool {
+public:
+	std::atomic<bool>* inUse;
+	int numSlots;
 
-	// Reassigns temp if it has run out of bits.
-	if (!(input & ~((1 << n) - 1))) rand_s(&input);
+	// Constructor. The pool is unusable until init is called.
+	SlotPool() : inUse(nullptr), numSlots(0) { }
 
-	// Assigns the output variable.
-	output = input % (1 << n);
+	// Creates numSlots free slots.
+	void init(int slots) {
+		inUse = new std::atomic<bool>[slots];
+		for (int i = 0; i < slots; ++i) inUse[i].store(false, std::memory_order_relaxed);
+		numSlots = slots;
 
-	// Moves on to the next n bits.
-	input >>= n;
+	}
 
-	// Returns the output.
-	return output;
+	// Claims a free slot and returns its index. Spins if every slot is in use.
+	inline int claim() {
+		for (int i = workerIndex % numSlots;; i = i + 1 < numSlots ? i + 1 : 0)
+			if (!inUse[i].load(std::memory_order_relaxed) && !inUse[i].exchange(true, std::memory_order_acquire)) return i;
 
-}
+	}
 
-/*
-Special version of randB that returns a random number no greater than the inputed
-maximum value (non inclusive).
-*/
-inline unsigned int randM(int max) {
-	int n = 0;
+	// Frees a claimed slot.
+	inline void release(int slot) {
+		inUse[slot].store(false, std::memory_order_release);
 
-	// Finds the highest bit in the bit string.
-	for (; n < sizeof(max) * 8; ++n) if (!(max >> n)) break;
+	}
+};
 
-	// Returns an appropriate random number.
-	return randB(n) % max;
+// Dispatches galaxies to the threads generating empires.
+DispatchCursor galaxyCursor;
 
-}
+class TaskGroup;
 
 /*
-Initializes all data needed for threading.
+A unit of work for the scheduler. Tasks belong to a TaskGroup, which is
+informed when the Task has been completed. zone is the ProfileZone the Task's
+time is attributed to.
 */
-void initThreading() {
+struct Task {
+	std::function<void()> func;
+	TaskGroup* group;
+	int zone;
 
-	// Initializes the thread count and threads.
-	numThreads = std::thread::hardware_concurrency();
-	if (numThreads <= 1) numThreads = 1;
+};
 
-	// TODO DEBUG REMOVE
-	//numThreads = 1;
+/*
+Double ended queue of Tasks belonging to a single thread index. The owning thread
+pushes and pops from the back, while idle threads steal from the front. Stealing
+from the front takes the oldest (and usually largest) Tasks.
+*/
+struct TaskDeque {
+	std::mutex mtx;
+	std::deque<Task> tasks;
 
-	// Initializes threads.
-	threads = new std::thread*[numThreads];
+};
 
-	// Initializes the array for tracking threads.
-	currThreads = new bool[numThreads];
-	for (int i = 0; i < numThreads; ++i)
-		currThreads[i] = true;
+// One TaskDeque per thread index.
+TaskDeque* taskDeques;
 
-	// Initializes the array for tracking thread cleanup.
-	cleanThreads = new bool[numThreads];
-	for (int i = 0; i < numThreads; ++i) cleanThreads[i] = false;
+// Number of Tasks currently waiting in any TaskDeque.
+std::atomic<int> numQueuedTasks(0);
 
-}
+// Used to park worker threads while there are no Tasks.
+std::mutex schedulerMutex;
+std::condition_variable schedulerCV;
+
+// Tells parked worker threads to return. Guarded by schedulerMutex.
+bool schedulerStopping;
 
 /*
-Returns the next available thread's index in threads. Cleans any threads used.
-This should be accessed only by the main thread.
+A group of Tasks which can be waited on. Tasks run in a TaskGroup may themselves
+run more Tasks in the same (or a different) TaskGroup.
+
+The thread that waits on a TaskGroup will execute Tasks until the group is
+complete, so waiting never leaves a thread idle while there is work to do.
 */
-int demandThread() {
+class TaskGroup {
+public:
 
-	// Parses through the array of threads until an available thread is found.
-	while (true) {
-		for (int i = 0; i < numThreads; ++i) {
-			if (currThreads[i]) {
-				currThreads[i] = false;
+	// Number of Tasks run in this group which have not yet been completed.
+	std::atomic<int> pending;
 
-				// Cleans thread if cleanup is needed.
-				if (cleanThreads[i]) {
-					threads[i]->join();
-					delete threads[i];
+	// Constructor.
+	TaskGroup() : pending(0) { }
 
-				}
+	// Queues a Task in this group.
+	void run(std::function<void()> func);
 
-				// Returns the index of the available thread.
-				return i;
+	// Executes Tasks until every Task in this group has been completed.
+	void wait();
 
-			}
-		}
-	}
-}
+};
 
 /*
-Returns the neaxt available thread's index in threads, or -1 if no thread is avaialable. Cleans any threads used.
-This may be accessed by any thread.
+Takes a Task from the calling thread's TaskDeque, or steals one from another
+thread's TaskDeque. Returns true if a Task was found.
 */
-int getThread() {
-	static std::shared_mutex getThreadMutex;
+bool findTask(Task& task) {
+	TaskDeque* deque;
+
+	// Does nothing if there are no Tasks anywhere.
+	if (!numQueuedTasks.load(std::memory_order_acquire)) return false;
+
+	// Takes the newest Task from this thread's own TaskDeque.
+	deque = &taskDeques[workerIndex];
+	{
+		const std::lock_guard<std::mutex> lock(deque->mtx);
+		if (!deque->tasks.empty()) {
+			task = std::move(deque->tasks.back());
+			deque->tasks.pop_back();
+			--numQueuedTasks;
+			return true;
 
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex> lock(getThreadMutex);
+		}
+	}
 
-	// Finds an available thread.
-	for (int i = 0; i < numThreads; ++i) {
-		if (currThreads[i]) {
-			currThreads[i] = false;
+	// Steals the oldest Task from the other TaskDeques, starting at the next thread index.
+	for (int i = 1; i < numThreads; ++i) {
+		deque = &taskDeques[(workerIndex + i) % numThreads];
+		const std::lock_guard<std::mutex> lock(deque->mtx);
+		if (!deque->tasks.empty()) {
+			task = std::move(deque->tasks.front());
+			deque->tasks.pop_front();
+			--numQueuedTasks;
+			return true;
 
-			// Cleans thread if cleanup is needed.
-			if (cleanThreads[i]) {
-				threads[i]->join();
-				delete threads[i];
+		}
+	}
 
-			}
+	// Returns false if every TaskDeque was empty.
+	return false;
 
-			// Returns the index of the available thread.
-			return i;
+}
+
+/*
+Executes a Task and informs its TaskGroup.
+*/
+inline void executeTask(Task& task) {
+
+	// Performs the Task. Its time is recorded before the TaskGroup is informed.
+	{
+		ProfileTask timer(task.zone);
+		task.func();
 
-		}
 	}
+	task.group->pending.fetch_sub(1, std::memory_order_release);
+
 }
 
 /*
-Waits for all threads to finish execution. Joins and deletes all of them.
+Queues a Task in this group. The Task is placed on the calling thread's TaskDeque
+and an idle worker is woken to steal it.
 */
-void joinAllThreads() {
+void TaskGroup::run(std::function<void()> func) {
+	TaskDeque* deque = &taskDeques[workerIndex];
+	pending.fetch_add(1, std::memory_order_relaxed);
 
-	// Joins each thread.
-	for (int i = 0; i < numThreads; ++i) {
-		if (!currThreads[i]) {
-			threads[i]->join();
-			delete threads[i];
-			cleanThreads[i] = false;
-			currThreads[i] = true;
+	// Places the Task on this thread's TaskDeque.
+	{
+		const std::lock_guard<std::mutex> lock(deque->mtx);
+		deque->tasks.push_back({ std::move(func), this, profileZone });
+		++numQueuedTasks;
 
-		}
 	}
 
-	// Cleans all remaining threads.
-	joinComplete();
+	// Wakes a worker. The lock prevents the wakeup from being lost between a
+	// worker checking numQueuedTasks and parking.
+	{
+		const std::lock_guard<std::mutex> lock(schedulerMutex);
+
+	}
+	schedulerCV.notify_one();
 
 }
 
 /*
-Joins threads which have finished execution and cleans up their memory.
+Executes Tasks until every Task in this group has been completed. Tasks from other
+groups may be executed while waiting.
 */
-void joinComplete() {
-	for (int i = 0; i < numThreads; ++i) {
-		if (cleanThreads[i]) {
-			threads[i]->join();
-			delete threads[i];
-			cleanThreads[i] = false;
+void TaskGroup::wait() {
+	ProfileWait timer;
+	Task task;
+
+	// Helps with queued Tasks until the last Task of this group finishes.
+	// Time spent without a Task is recorded as barrier idle time.
+	while (pending.load(std::memory_order_acquire)) {
+		if (findTask(task)) {
+			timer.working();
+			executeTask(task);
+
+		}
+		else {
+			timer.idling();
+			std::this_thread::yield();
 
 		}
 	}
 }
 
 /*
-Returns the number of unused threads.
+Loop run by each worker thread of the scheduler. Executes Tasks while there are
+any, and parks otherwise. Workers run until shutdownThreading is called.
 */
-int unusedThreads() {
-	int numUnused = 0;
-	for (int i = 0; i < numThreads; ++i) numUnused += currThreads[i];
-	return numUnused;
+void workerLoop(int index) {
+	Task task;
+	workerIndex = index;
+
+	// Executes Tasks until the scheduler is stopped.
+	while (true) {
+		if (findTask(task)) {
+			executeTask(task);
+			continue;
+
+		}
+
+		// Parks until a Task is queued or the scheduler is stopped.
+		std::unique_lock<std::mutex> lock(schedulerMutex);
+		schedulerCV.wait(lock, [] { return schedulerStopping || numQueuedTasks.load(std::memory_order_acquire) > 0; });
+		if (schedulerStopping) return;
 
+	}
 }
 
 /*
-Initializes numThreads int dummies. They are either the size of the universe or
-the largest possible planet, whichever's larger. This should only be accessed in a
-single threaded mannerone one time per game session.
-Size is the total length of a dummy - all calculations for size should be done earlier.
-
-This is called in beginGenerateSystems in Universe Generator.hpp
+Recursive helper for parallelFor. Splits [beg, end) in half until it is no
+larger than grain, queueing the upper halves so that idle threads may steal them.
 */
-void initDummies(int size) {
-	int numDummies = numThreads;
-	int* sizeDummy;
+void parallelForSplit(TaskGroup& group, int beg, int end, int grain, const std::function<void(int, int)>& func) {
+	int mid;
 
-	// Creates threadDummies. Includes space to store dummy size and availability.
-	threadDummies = new uint_least8_t[numDummies * (size * sizeof(uint_least8_t) + sizeof(uint_least8_t)) + sizeof(int)]();
+	// Queues the upper half of the range until the remaining range is small enough.
+	while (end - beg > grain) {
+		mid = beg + (end - beg) / 2;
+		group.run([&group, mid, end, grain, &func] { parallelForSplit(group, mid, end, grain, func); });
+		end = mid;
 
-	// The -4th index of threadDummies stores a 4 byte int containing size + 1.
-	sizeDummy = (int*)threadDummies;
-	sizeDummy[0] = size * sizeof(uint_least8_t) + sizeof(uint_least8_t);
-	threadDummies += sizeof(int);
+	}
+
+	// Performs the remaining range.
+	if (beg < end) func(beg, end);
 
 }
 
 /*
-Requests a dummy. Note that the dummy will not be cleared and must be
-initialized elsewhere.
+Performs func over [beg, end) using every thread. func is called with subranges
+of at most grain indices, i.e. func(beg, end) should loop from beg to end.
+Returns once the entire range has been completed, so this acts as a barrier.
 */
-uint_least8_t* requestDummy() {
-	static std::shared_mutex dummyMutex;
+void parallelFor(int beg, int end, int grain, const std::function<void(int, int)>& func) {
+	TaskGroup group;
 
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex> lock(dummyMutex);
+	// Splits the range into Tasks, then helps until they are complete.
+	if (grain < 1) grain = 1;
+	parallelForSplit(group, beg, end, grain, func);
+	group.wait();
 
-	// Increment to reach the next availability index.
-	int dist = *((int*)threadDummies - 1);
+}
 
-	// Bound for parsing.
-	uint_least8_t* end = threadDummies + (dist * numThreads);
+/*
+Kinds of random streams. Work spread over threads seeds a stream from its kind, turn and
+position before using random numbers, so that its results do not depend on which thread
+performed it.
+*/
+enum RandomStreamType {
+	THREAD_STREAM,
+	SYSTEM_STREAM,
+	EMPIRE_STREAM,
+	GOVERNMENT_STREAM
 
-	// threadDummies starts on the -1st index of the 1st array.
-	uint_least8_t* dummyPointer;
+};
 
-	// Continuously searches for an available dummy until one is found.
-	// Note: It is incredibly unlikely that this while loop will be necessarry,
-	// but it is included for safety.
-	while (true) {
-		dummyPointer = threadDummies;
-		for (; dummyPointer <= end - 1; dummyPointer += dist) {
-			if (!dummyPointer[0]) {
-				dummyPointer[0] = 1;
-				return dummyPointer + 1;
+// Seed from which every random stream is derived.
+uint64_t randomSeed;
 
-			}
-		}
-	}
-}
+// Incremented whenever randomSeed changes, so that threads know to reseed.
+std::atomic<unsigned int> randomEpoch(1);
 
 /*
-Marks a dummy as available.
+Step of the SplitMix64 generator. Used to expand seeds into generator states.
 */
-inline void releaseDummy(uint_least8_t* dummy) {
-	dummy[-1] = 0;
+inline uint64_t splitMix64(uint64_t& x) {
+	uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
 
 }
 
 /*
-Initializes numThreads bitarry dummies. They are the size of the largest possible planet.
-This should only be accessed in a single threaded manner one time per game session.
-Size is the total length of a dummy - all calculations for size should be done earlier.
+Combines a stream's kind and keys into a single stream.
+*/
+inline uint64_t randomStream(uint64_t type, uint64_t a, uint64_t b) {
+	uint64_t x = type;
+	x = splitMix64(x) ^ a;
+	x = splitMix64(x) ^ b;
+	return splitMix64(x);
 
-This is called in beginGenerateSystems in Universe Generator.hpp
+}
 
-64 is the number of bytes necessary to create a bitarray of size 512.
+/*
+xoshiro256** generator, along with a buffer of unused bits for randB.
+Each thread has its own RandomGenerator, so no locking is needed.
 */
-void initLargeDummies(int size) {
-	int numDummies = numThreads;
-	int* sizeDummy;
+class RandomGenerator {
+public:
+	uint64_t state[4];
+	uint64_t bits;
+	int numBits;
+	unsigned int epoch;
+
+	// Seeds the generator with a stream derived from seed.
+	void seed(uint64_t seed, uint64_t stream) {
+		uint64_t x = seed ^ splitMix64(stream);
+		for (int i = 0; i < 4; ++i) state[i] = splitMix64(x);
+		bits = 0;
+		numBits = 0;
+		epoch = randomEpoch.load(std::memory_order_relaxed);
 
-	// Creates threadLargeDummies. Includes space to store dummy size and availability.
-	threadLargeDummies = new uint_least8_t[numDummies * (size * 64 + sizeof(uint_least8_t)) + sizeof(int)]();
+	}
 
-	// The -4th index of threadLargeDummies stores a 4 byte int containing size + 1.
-	sizeDummy = (int*)threadLargeDummies;
-	sizeDummy[0] = size * 64 + sizeof(uint_least8_t);
+	// Returns the next 64 random bits.
+	inline uint64_t next() {
+		const uint64_t result = rotl(state[1] * 5, 7) * 9;
+		const uint64_t t = state[1] << 17;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= t;
+		state[3] = rotl(state[3], 45);
+		return result;
 
-	// TODO DEBUG REMOVE (don't know why that's written, seems to work)
-	threadLargeDummies += sizeof(int);
+	}
 
-}
+private:
 
-/*
-Requests a dummy. Note that the dummy will not be cleared and must be
-initialized elsewhere.
-*/
-uint_least8_t* requestLargeDummy() {
-	static std::shared_mutex dummyMutex;
+	// Rotates x left by k bits.
+	static inline uint64_t rotl(const uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
 
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex> lock(dummyMutex);
+};
 
-	// Increment to reach the next availability index.
-	int dist = *((int*)threadLargeDummies - 1);
+// The calling thread's RandomGenerator. Seeded upon first use.
+thread_local RandomGenerator threadRandom = {};
 
-	// Bound for parsing.
-	uint_least8_t* end = threadLargeDummies + (dist * numThreads);
+/*
+Returns the calling thread's RandomGenerator. Gives the thread the default stream of its workerIndex
+if it has not been seeded since the last call to seedRandom, so that each worker's stream is the same
+from run to run.
+*/
+inline RandomGenerator& getRandom() {
+	if (threadRandom.epoch != randomEpoch.load(std::memory_order_relaxed))
+		threadRandom.seed(randomSeed, randomStream(THREAD_STREAM, workerIndex, 0));
+	return threadRandom;
 
-	// threadLargeDummies starts on the -1st index of the 1st array.
-	uint_least8_t* dummyPointer;
+}
 
-	// Continuously searches for an available dummy until one is found.
-	// Note: It is incredibly unlikely that this while loop will be necessarry,
-	// but it is included for safety.
-	while (true) {
-		dummyPointer = threadLargeDummies;
-		for (; dummyPointer <= end - 1; dummyPointer += dist) {
-			if (!dummyPointer[0]) {
-				dummyPointer[0] = 1;
-				return dummyPointer + 1;
+/*
+Seeds every random stream. Threads will reseed their default streams upon their next use.
+The calling thread's generator is seeded immediately.
+*/
+void seedRandom(uint64_t seed) {
+	randomSeed = seed;
+	++randomEpoch;
+	getRandom();
 
-			}
-		}
-	}
 }
 
 /*
-Marks a dummy as available.
+Seeds the calling thread's generator with a stream derived from the seed. The stream's
+numbers are identical whichever thread uses it.
 */
-inline void releaseLargeDummy(uint_least8_t* dummy) {
-	((uint_least8_t*)dummy)[-1] = 0;
+inline void seedRandomStream(uint64_t stream) {
+	threadRandom.seed(randomSeed, stream);
 
 }
 
 /*
-Accesses a given bit in a bitarray. Used for threadLargeDummies.
+Returns a random int between 0 and INT_MAX.
 */
-inline bool readArrBit(uint_least8_t* arr, int bit) {
-	return (arr[bit / 8] >> (bit % 8)) & 1;
+inline int randS() {
+	return (int)(getRandom().next() >> 33);
 
 }
 
 /*
-Writes a given bit an a bitarray. Used for threadLargeDummies.
+Returns a random unsigned int.
 */
-inline void writeArrBit(uint_least8_t* arr, int bit, bool write) {
-	arr[bit / 8] ^= (-(uint_least8_t)write ^ arr[bit / 8]) & (1UL << (bit % 8));
+inline unsigned int randU() {
+	return (unsigned int)(getRandom().next() >> 32);
 
 }
 
-// Integer value used for multithreading.
-int threadInteger;
+/*
+Returns n random bits. Bits are taken from a buffer, which is refilled once it has fewer than n bits.
+Note that randB can at most return 32 bits.
+*/
+inline unsigned int randB(int n) {
+	RandomGenerator& random = getRandom();
+	unsigned int output;
+
+	// Refills the buffer if it has run out of bits.
+	if (random.numBits < n) {
+		random.bits = random.next();
+		random.numBits = 64;
+
+	}
+
+	// Assigns the output variable.
+	output = (unsigned int)(random.bits & ((1ULL << n) - 1));
+
+	// Moves on to the next n bits.
+	random.bits >>= n;
+	random.numBits -= n;
+
+	// Returns the output.
+	return output;
+
+}
 
 /*
-Requests an integer.
+Special version of randB that returns a random number no greater than the inputed
+maximum value (non inclusive).
 */
-inline int requestInt() {
-	static std::shared_mutex requestIntMutex;
+inline unsigned int randM(int max) {
+	int n = 0;
 
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex> lock(requestIntMutex);
+	// Finds the highest bit in the bit string.
+	for (; n < sizeof(max) * 8; ++n) if (!(max >> n)) break;
 
-	// Returns the integer then increments it.
-	int ret = threadInteger;
-	++threadInteger;
-	return ret;
+	// Returns an appropriate random number.
+	return randB(n) % max;
 
 }
 
 /*
-Resets the integer counter.
+Initializes all data needed for threading. The scheduler will use threadCount threads, or
+one thread per hardware thread if threadCount is 0.
 */
-void resetInt() {
-	threadInteger = 0;
+void initThreading(int threadCount) {
+
+	// Initializes the thread count and threads.
+	numThreads = threadCount > 0 ? threadCount : std::thread::hardware_concurrency();
+	if (numThreads <= 1) numThreads = 1;
+
+	// TODO DEBUG REMOVE
+	//numThreads = 1;
+
+	// Initializes a TaskDeque for each thread index.
+	taskDeques = new TaskDeque[numThreads];
+
+	// Starts the worker threads. The calling thread will take index 0.
+	threads = new std::thread*[numThreads];
+	threads[0] = nullptr;
+	for (int i = 1; i < numThreads; ++i) threads[i] = new std::thread(workerLoop, i);
 
 }
 
 /*
-Requests a galaxy. Returns the index of the next available galaxy in galaxies, otherwise -1.
+Stops the scheduler's worker threads, then joins and deletes them along with the TaskDeques.
+Must be called once no Tasks remain and before the program exits, since parked workers would
+otherwise still be waiting on schedulerCV while it is destroyed.
 */
-int requestGalaxy() {
-	static std::shared_mutex requestGalaxyMutex;
+void shutdownThreading() {
 
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex> lock(requestGalaxyMutex);
+	// Raises the stop flag and wakes every parked worker to see it.
+	{
+		const std::lock_guard<std::mutex> lock(schedulerMutex);
+		schedulerStopping = true;
 
-	// Parses through each galaxy and returns the next available one.
-	for (int i = 0; i < numGals; ++i) {
-		if (!galaxies[i].active) {
-			galaxies[i].active = true;
-			return i;
+	}
+	schedulerCV.notify_all();
+
+	// Joins and deletes the worker threads.
+	for (int i = 1; i < numThreads; ++i) {
+		threads[i]->join();
+		delete threads[i];
 
-		}
 	}
+	delete[] threads;
+	threads = nullptr;
+
+	// Frees the TaskDeques. No Tasks may be run until initThreading is called again.
+	delete[] taskDeques;
+	taskDeques = nullptr;
+	numThreads = 0;
 
-	// Returns -1 if no galaxy was found.
-	return -1;
+	// Lowers the stop flag so that the scheduler may be initialized again.
+	schedulerStopping = false;
 
 }
 
 /*
-Returns a galaxy.
+Requests a galaxy. Returns the index of the next unclaimed galaxy in galaxies, otherwise -1.
 */
-void releaseGalaxy(int index) {
-	galaxies[index].active = false;
+int requestGalaxy() {
+	return galaxyCursor.claim();
 
 }
 
-// Returns all galaxies.
+/*
+Returns all galaxies, allowing each to be requested once more.
+*/
 void releaseAllGalaxies() {
-	for (int i = 0; i < numGals; ++i) galaxies[i].active = false;
+	galaxyCursor.reset(numGals);
 
-}
\ No newline at end of file
+}
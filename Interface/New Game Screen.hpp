@@ -224,7 +224,7 @@ ButtonCode newGameStart() {
 
 				// Moves to the play loop if the universe has been initialized.
 				case (NEW_GAME_PLAY):
-					if (universe != nullptr) {
+					if (universe.blocks != nullptr) {
 						deallocateButtons(newGameButtons, NUM_NEW_GAME_BUTTONS);
 						return NEW_GAME_PLAY;
 
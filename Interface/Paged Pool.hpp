@@ -0,0 +1,480 @@
+#pragma once
+
+// Default size of a page within a PagedPool. Pages are aligned to their size, so the page of
+// any item can be found by masking the item's address.
+#define POOL_PAGE_BYTES 1048576
+
+// Number of items that each worker thread may keep in its cache for a PagedPool.
+#define POOL_CACHE_SIZE 32
+
+// Maximum number of pages in a PagedPool. The page table is allocated at this size and never moves,
+// so that at() may read it without the pool's mutex while another thread adds a page.
+#define POOL_MAX_PAGES 65536
+
+/*
+Object pool which stores items of type T in pages of PAGE_BYTES bytes. Replaces the page tables
+which were previously written out separately for each type (ColonyPage, GovernmentPage, etc.).
+
+Each page keeps a free list threaded through its freed items, so allocating and freeing are O(1).
+Pages are aligned to PAGE_BYTES, so an item's index is found from its address with a mask and a
+shift rather than by searching every page. Each page also keeps one bit per item marking whether
+the item is live, which lets the pool iterate over live items while skipping freed ones.
+
+Items are handed out zeroed, as they were by the old calloc'd pages, and are never constructed or
+destructed by the pool. Freed items are zeroed apart from their final four bytes, which store
+the next item of their page's free list.
+
+Worker threads keep a small cache of free items each, so that they rarely need the pool's mutex.
+Index 0 is shared by every non-worker thread, so those threads always go through the mutex.
+*/
+template<class T, int PAGE_BYTES = POOL_PAGE_BYTES>
+class PagedPool {
+public:
+
+	// Number of items in each page. Leaves room for the page's metadata and live bits.
+	static constexpr int PAGE_SIZE = (int)((PAGE_BYTES - 64) * 8 / (sizeof(T) * 8 + 1));
+
+	// Number of 64 bit words needed to hold a page's live bits.
+	static constexpr int LIVE_WORDS = (PAGE_SIZE + 63) / 64;
+
+	// Number of entries in the page table. Limited so that every index fits in an int.
+	static constexpr int MAX_PAGES = POOL_MAX_PAGES < INT_MAX / PAGE_SIZE ? POOL_MAX_PAGES : INT_MAX / PAGE_SIZE;
+
+	/*
+	Page of items. Items past highWater have never been handed out and are still zeroed.
+	*/
+	struct Page {
+
+		// Index of this page within the page table.
+		int index;
+
+		// Number of items which have been handed out from this page at least once.
+		int highWater;
+
+		// First item of this page's free list, or -1 if the list is empty.
+		int freeHead;
+
+		// Number of live items in this page.
+		std::atomic<int> numLive;
+
+		// Unused by the pool. Owners of a pool may use it to mark pages needing attention.
+		bool dirty;
+
+		// One bit per item, set while the item is live.
+		std::atomic<uint_least64_t> live[LIVE_WORDS];
+
+		// Storage for the items themselves.
+		alignas(T) unsigned char storage[PAGE_SIZE * sizeof(T)];
+
+		// Returns the items of this page.
+		inline T* items() { return (T*)storage; }
+
+	};
+
+	/*
+	Free items held by a single worker thread. Padded to avoid false sharing between threads.
+	*/
+	struct alignas(64) Cache {
+		T* items[POOL_CACHE_SIZE];
+		int count;
+
+	};
+
+	// Table of MAX_PAGES pages, and the number of pages in use.
+	Page** pages;
+	int numPages;
+
+	// Lowest page which may contain a free item.
+	int openPage;
+
+	// One Cache per thread index. Index 0 is unused.
+	Cache* caches;
+
+	// Guards the page table, free lists, and highWaters.
+	std::mutex mtx;
+
+	// Constructor. The pool has no pages until init is called.
+	PagedPool() : pages(nullptr), numPages(0), openPage(0), caches(nullptr) { }
+
+	// Frees every page, then creates enough pages to hold capacity items.
+	void init(int capacity);
+
+	// Returns a zeroed item.
+	T* allocate();
+
+	// Marks an item as free. The item must already have been destructed if necessary.
+	void free(T* item);
+
+	// Returns the index of an item.
+	inline int indexOf(const T* item);
+
+	// Returns the item at an index.
+	inline T* at(int index);
+
+	// Returns true if the item at an index is live.
+	inline bool isLive(int index);
+
+	// Calls func on every live item in a page.
+	template<class F>
+	void forEachInPage(int page, F func);
+
+	// Calls func on every live item.
+	template<class F>
+	void forEach(F func);
+
+	// Returns the first live item for which func returns true, otherwise nullptr.
+	template<class F>
+	T* search(F func);
+
+	// Restores a page's highWater and live bits. Used when loading.
+	void restorePage(int page, int highWater, const uint_least64_t* live);
+
+private:
+
+	// Returns the page containing an item.
+	inline Page* pageOf(const T* item);
+
+	// Creates a zeroed page at the end of the page table.
+	void addPage();
+
+	// Takes a free item from the pages. Must hold mtx.
+	T* take();
+
+	// Returns an item to its page's free list. Must hold mtx.
+	void give(T* item);
+
+	// Reads and writes the free list link stored in the final four bytes of a free item.
+	inline int readLink(T* item);
+	inline void writeLink(T* item, int link);
+
+};
+
+// Definitions for the above constants, needed when they are passed by reference.
+template<class T, int PAGE_BYTES>
+constexpr int PagedPool<T, PAGE_BYTES>::PAGE_SIZE;
+template<class T, int PAGE_BYTES>
+constexpr int PagedPool<T, PAGE_BYTES>::LIVE_WORDS;
+template<class T, int PAGE_BYTES>
+constexpr int PagedPool<T, PAGE_BYTES>::MAX_PAGES;
+
+/*
+Frees every page, then creates enough pages to hold capacity items.
+It is expected that this function will be called once per universe and in a single-threaded manner.
+Items which are still live are not destructed.
+*/
+template<class T, int PAGE_BYTES>
+void PagedPool<T, PAGE_BYTES>::init(int capacity) {
+	static_assert(sizeof(Page) <= PAGE_BYTES, "PagedPool page metadata does not fit in its page.");
+	static_assert(sizeof(T) >= sizeof(int), "PagedPool items must be able to hold a free list link.");
+
+	// Frees the current pages.
+	for (int i = 0; i < numPages; ++i) {
+#ifdef _MSC_VER
+		_aligned_free(pages[i]);
+#else
+		::free(pages[i]);
+#endif
+
+	}
+
+	// Empties the thread caches, creating them if necessary.
+	if (caches == nullptr) caches = new Cache[numThreads > 0 ? numThreads : 1];
+	for (int i = 0; i < numThreads; ++i) caches[i].count = 0;
+
+	// Creates the page table once, then the pages. The table is reused by later universes.
+	numPages = 0;
+	openPage = 0;
+	if (pages == nullptr) pages = (Page**)calloc(MAX_PAGES, sizeof(Page*));
+	for (int i = capacity / PAGE_SIZE + 1; i > 0; --i) addPage();
+
+}
+
+/*
+Creates a zeroed page at the end of the page table. The page table never grows, so the
+game exits if it is full.
+*/
+template<class T, int PAGE_BYTES>
+void PagedPool<T, PAGE_BYTES>::addPage() {
+
+	// Exits if the page table is full.
+	if (numPages == MAX_PAGES) {
+		printf("PagedPool is full\n");
+		exit(1);
+
+	}
+
+	// Creates the page. The page is aligned to its size so that pageOf may mask addresses.
+#ifdef _MSC_VER
+	Page* page = (Page*)_aligned_malloc(PAGE_BYTES, PAGE_BYTES);
+#else
+	Page* page = (Page*)aligned_alloc(PAGE_BYTES, PAGE_BYTES);
+#endif
+	memset((void*)page, 0, sizeof(Page));
+	page->index = numPages;
+	page->freeHead = -1;
+	pages[numPages++] = page;
+
+}
+
+/*
+Returns a zeroed item. Worker threads take items from their own cache, refilling it from
+the pages when it is empty.
+*/
+template<class T, int PAGE_BYTES>
+T* PagedPool<T, PAGE_BYTES>::allocate() {
+	T* item;
+
+	// Takes an item from the calling worker's cache.
+	if (workerIndex) {
+		Cache* cache = &caches[workerIndex];
+		if (!cache->count) {
+			const std::lock_guard<std::mutex> lock(mtx);
+			while (cache->count < POOL_CACHE_SIZE / 2) cache->items[cache->count++] = take();
+
+		}
+		item = cache->items[--cache->count];
+
+	}
+	// Takes an item directly from the pages.
+	else {
+		const std::lock_guard<std::mutex> lock(mtx);
+		item = take();
+
+	}
+
+	// Clears the free list link, leaving the item zeroed, and marks it as live.
+	Page* page = pageOf(item);
+	int slot = (int)(item - page->items());
+	writeLink(item, 0);
+	page->live[slot / 64].fetch_or((uint_least64_t)1 << (slot % 64), std::memory_order_relaxed);
+	page->numLive.fetch_add(1, std::memory_order_relaxed);
+	return item;
+
+}
+
+/*
+Marks an item as free and zeroes it. Worker threads keep freed items in their own cache,
+returning half of it to the pages when it is full.
+*/
+template<class T, int PAGE_BYTES>
+void PagedPool<T, PAGE_BYTES>::free(T* item) {
+	Page* page = pageOf(item);
+	int slot = (int)(item - page->items());
+
+	// Marks the item as dead and zeroes it.
+	page->live[slot / 64].fetch_and(~((uint_least64_t)1 << (slot % 64)), std::memory_order_relaxed);
+	page->numLive.fetch_sub(1, std::memory_order_relaxed);
+	memset((void*)item, 0, sizeof(T));
+
+	// Places the item in the calling worker's cache.
+	if (workerIndex) {
+		Cache* cache = &caches[workerIndex];
+		if (cache->count == POOL_CACHE_SIZE) {
+			const std::lock_guard<std::mutex> lock(mtx);
+			while (cache->count > POOL_CACHE_SIZE / 2) give(cache->items[--cache->count]);
+
+		}
+		cache->items[cache->count++] = item;
+		return;
+
+	}
+
+	// Returns the item directly to its page.
+	const std::lock_guard<std::mutex> lock(mtx);
+	give(item);
+
+}
+
+/*
+Takes a free item from the lowest page which has one. Reuses freed items before handing out
+new ones from a page. Adds a page if every page is full.
+*/
+template<class T, int PAGE_BYTES>
+T* PagedPool<T, PAGE_BYTES>::take() {
+	Page* page;
+	T* item;
+
+	// Finds the lowest page with a free item.
+	for (; openPage < numPages; ++openPage) {
+		page = pages[openPage];
+
+		// Pops the first item of the free list.
+		if (page->freeHead >= 0) {
+			item = &page->items()[page->freeHead];
+			page->freeHead = readLink(item);
+			return item;
+
+		}
+
+		// Hands out an item which has never been used.
+		if (page->highWater < PAGE_SIZE) return &page->items()[page->highWater++];
+
+	}
+
+	// Adds a page if every page is full.
+	addPage();
+	return &pages[openPage]->items()[pages[openPage]->highWater++];
+
+}
+
+/*
+Returns an item to its page's free list.
+*/
+template<class T, int PAGE_BYTES>
+void PagedPool<T, PAGE_BYTES>::give(T* item) {
+	Page* page = pageOf(item);
+	writeLink(item, page->freeHead);
+	page->freeHead = (int)(item - page->items());
+	if (page->index < openPage) openPage = page->index;
+
+}
+
+/*
+Returns the index of an item. Pages are aligned to their size, so the item's page is
+found by masking its address.
+*/
+template<class T, int PAGE_BYTES>
+inline int PagedPool<T, PAGE_BYTES>::indexOf(const T* item) {
+	Page* page = pageOf(item);
+	return page->index * PAGE_SIZE + (int)(item - page->items());
+
+}
+
+/*
+Returns the item at an index.
+*/
+template<class T, int PAGE_BYTES>
+inline T* PagedPool<T, PAGE_BYTES>::at(int index) {
+	return &pages[index / PAGE_SIZE]->items()[index % PAGE_SIZE];
+
+}
+
+/*
+Returns true if the item at an index is live.
+*/
+template<class T, int PAGE_BYTES>
+inline bool PagedPool<T, PAGE_BYTES>::isLive(int index) {
+	int slot = index % PAGE_SIZE;
+	return (pages[index / PAGE_SIZE]->live[slot / 64].load(std::memory_order_relaxed) >> (slot % 64)) & 1;
+
+}
+
+/*
+Calls func on every live item in a page, in order of index. Skips whole words of freed
+items at a time. func may free the item it is given.
+*/
+template<class T, int PAGE_BYTES>
+template<class F>
+void PagedPool<T, PAGE_BYTES>::forEachInPage(int page, F func) {
+	Page* currPage = pages[page];
+	uint_least64_t bits;
+
+	// Does nothing if the page has no live items.
+	if (!currPage->numLive.load(std::memory_order_relaxed)) return;
+
+	// Calls func on each item whose live bit is set.
+	for (int word = 0; word * 64 < currPage->highWater; ++word) {
+		bits = currPage->live[word].load(std::memory_order_relaxed);
+		for (int bit = 0; bits; ++bit, bits >>= 1)
+			if (bits & 1) func(&currPage->items()[word * 64 + bit]);
+
+	}
+}
+
+/*
+Calls func on every live item, in order of index.
+*/
+template<class T, int PAGE_BYTES>
+template<class F>
+void PagedPool<T, PAGE_BYTES>::forEach(F func) {
+	for (int page = 0; page < numPages; ++page) forEachInPage(page, func);
+
+}
+
+/*
+Returns the first live item for which func returns true, otherwise nullptr.
+*/
+template<class T, int PAGE_BYTES>
+template<class F>
+T* PagedPool<T, PAGE_BYTES>::search(F func) {
+	uint_least64_t bits;
+	T* item;
+
+	// Searches the live items of each page.
+	for (int page = 0; page < numPages; ++page) {
+		if (!pages[page]->numLive.load(std::memory_order_relaxed)) continue;
+		for (int word = 0; word * 64 < pages[page]->highWater; ++word) {
+			bits = pages[page]->live[word].load(std::memory_order_relaxed);
+			for (int bit = 0; bits; ++bit, bits >>= 1) {
+				item = &pages[page]->items()[word * 64 + bit];
+				if ((bits & 1) && func(item)) return item;
+
+			}
+		}
+	}
+
+	// Returns nullptr if no item was found.
+	return nullptr;
+
+}
+
+/*
+Restores a page's highWater and live bits, then rebuilds its free list from the items below
+highWater which are not live. The page's items must be loaded separately.
+Adds pages until the page exists.
+*/
+template<class T, int PAGE_BYTES>
+void PagedPool<T, PAGE_BYTES>::restorePage(int page, int highWater, const uint_least64_t* live) {
+	while (numPages <= page) addPage();
+	Page* currPage = pages[page];
+	int numLive = 0;
+
+	// Restores highWater and the live bits.
+	currPage->highWater = highWater;
+	for (int word = 0; word * 64 < highWater; ++word) {
+		currPage->live[word].store(live[word], std::memory_order_relaxed);
+		for (uint_least64_t bits = live[word]; bits; bits >>= 1) numLive += bits & 1;
+
+	}
+	currPage->numLive.store(numLive, std::memory_order_relaxed);
+
+	// Rebuilds the free list so that the lowest free item is handed out first.
+	currPage->freeHead = -1;
+	for (int slot = highWater - 1; slot >= 0; --slot) {
+		if ((live[slot / 64] >> (slot % 64)) & 1) continue;
+		writeLink(&currPage->items()[slot], currPage->freeHead);
+		currPage->freeHead = slot;
+
+	}
+	openPage = 0;
+
+}
+
+/*
+Returns the page containing an item.
+*/
+template<class T, int PAGE_BYTES>
+inline typename PagedPool<T, PAGE_BYTES>::Page* PagedPool<T, PAGE_BYTES>::pageOf(const T* item) {
+	return (Page*)((uintptr_t)item & ~((uintptr_t)PAGE_BYTES - 1));
+
+}
+
+/*
+Reads the free list link stored in the final four bytes of a free item.
+*/
+template<class T, int PAGE_BYTES>
+inline int PagedPool<T, PAGE_BYTES>::readLink(T* item) {
+	int link;
+	memcpy(&link, (char*)item + sizeof(T) - sizeof(int), sizeof(int));
+	return link;
+
+}
+
+/*
+Writes the free list link stored in the final four bytes of a free item.
+*/
+template<class T, int PAGE_BYTES>
+inline void PagedPool<T, PAGE_BYTES>::writeLink(T* item, int link) {
+	memcpy((char*)item + sizeof(T) - sizeof(int), &link, sizeof(int));
+
+}
@@ -0,0 +1,689 @@
+#pragma once
+
+/*
+This header contains the PathGraph, a hierarchical abstraction of the universe used for long
+Squadron paths.
+*/
+
+// Number of entrances along each side of a PathCluster. Entrances are spread evenly along the side.
+#define PATH_CLUSTER_ENTRANCES 2
+
+// Number of entrance nodes belonging to each PathCluster, over all four sides.
+#define PATH_CLUSTER_PORTS (4 * PATH_CLUSTER_ENTRANCES)
+
+// Largest width and height of the area searched tile by tile, and the number of tiles within it.
+// Paths whose ends are no further apart than UNIVERSE_CHUNK_SIZE are found directly within such an area.
+#define PATH_WINDOW_SIZE (2 * UNIVERSE_CHUNK_SIZE)
+#define PATH_WINDOW_TILES (PATH_WINDOW_SIZE * PATH_WINDOW_SIZE)
+
+// Cost between two nodes which cannot reach one another.
+#define PATH_UNREACHABLE 0x3FFFFFFF
+
+// Sides of a PathCluster. Each side's partner is the side of the same pair (WEST and EAST, etc.).
+enum PathSide {
+	PATH_WEST,
+	PATH_EAST,
+	PATH_NORTH,
+	PATH_SOUTH
+
+};
+
+/*
+Node of the PathGraph. Nodes are either entrances, which lie on the side of a PathCluster next to
+an entrance of the neighbouring cluster, or Systems.
+*/
+struct PathNode {
+
+	// Tile of the node.
+	CoordU loc;
+
+	// PathCluster containing the node, and the node's index within that cluster.
+	int cluster;
+	int local;
+
+	// Entrance of the neighbouring cluster next to this entrance, or -1 if there is none.
+	int partner;
+
+};
+
+/*
+Edge of the PathGraph following one of a System's tradeLanes.
+offset is the index of the lane within the System's tradeLanes.
+*/
+struct PathLane {
+	int to;
+	int cost;
+	int offset;
+
+};
+
+/*
+Cluster of the PathGraph. There is one cluster per universe chunk, and they share its index.
+
+costs holds the cost of the cheapest path between each pair of the cluster's nodes which stays
+within the cluster, or PATH_UNREACHABLE.
+*/
+struct PathCluster {
+
+	// Nodes of the cluster. Valid entrances come first, followed by Systems.
+	int* nodes;
+	int numNodes;
+
+	// numNodes by numNodes costs, indexed by [from * numNodes + to].
+	int* costs;
+
+	// Movement cost of every tile of the cluster, or 0 if its tiles' costs differ.
+	int uniformCost;
+
+	// True if the cluster must be rebuilt by updatePathGraph.
+	bool dirty;
+
+};
+
+/*
+Hierarchical abstraction of the universe (HPA*), used so that long paths do not search every tile
+between their ends.
+
+Each universe chunk is a PathCluster. Neighbouring clusters are joined by PATH_CLUSTER_ENTRANCES
+pairs of entrances along each shared side, and Systems are joined to the Systems at the other end
+of their tradeLanes. Costs within a cluster are precomputed, so a path is found by searching the
+nodes of the graph and then refining each step of the result within a single cluster.
+
+Entrance nodes are stored first, at cluster * PATH_CLUSTER_PORTS + side * PATH_CLUSTER_ENTRANCES
++ entrance, followed by one node per System in the order of allSystemSpace.
+*/
+struct PathGraph {
+
+	// Nodes of the graph, and the number of nodes.
+	PathNode* nodes;
+	int numNodes;
+
+	// Clusters of the graph, and the number of clusters.
+	PathCluster* clusters;
+	int numClusters;
+
+	// Trade lanes leaving each System node. The lanes of node n are lanes[firstLane[n - firstSystem]]
+	// up to lanes[firstLane[n - firstSystem + 1]].
+	PathLane* lanes;
+	int* firstLane;
+	int firstSystem;
+
+	// Lowest movement cost of any tile type. Used by the heuristics.
+	int minCost;
+
+	// True if any cluster is dirty.
+	bool dirty;
+
+};
+
+// Hierarchical graph used for long Squadron paths.
+PathGraph pathGraph;
+
+// Builds the PathGraph for the current universe.
+void initPathGraph();
+
+// Marks the cluster containing a tile for rebuilding. Must be called whenever the movement cost of a tile changes.
+inline void markPathTile(int xPos, int yPos);
+
+// Rebuilds every dirty cluster and recosts every trade lane.
+void updatePathGraph();
+
+// Finds the cheapest path between two tiles, placing every tile of the path (including both ends) in path.
+bool findUniversePath(CoordU start, CoordU dest, ScratchVector<CoordU>& path);
+
+/*
+Returns the distance between two tiles, where diagonal steps count as one tile.
+*/
+inline int calcChebyshevDistance(int x1, int y1, int x2, int y2) {
+	int xDist = abs(x2 - x1);
+	int yDist = abs(y2 - y1);
+	return xDist > yDist ? xDist : yDist;
+
+}
+
+/*
+Returns the offset of an entrance along a side of length length.
+*/
+inline int pathEntranceOffset(int entrance, int length) {
+	return (2 * entrance + 1) * length / (2 * PATH_CLUSTER_ENTRANCES);
+
+}
+
+/*
+Returns the tile of an entrance of the cluster at (cx, cy) in chunks. Returns false if the
+side has no neighbouring cluster.
+*/
+bool pathEntranceTile(int cx, int cy, int side, int entrance, CoordU* tile) {
+	int xBeg = cx << UNIVERSE_CHUNK_SHIFT;
+	int yBeg = cy << UNIVERSE_CHUNK_SHIFT;
+	int width = universeWidth - xBeg < UNIVERSE_CHUNK_SIZE ? universeWidth - xBeg : UNIVERSE_CHUNK_SIZE;
+	int height = universeHeight - yBeg < UNIVERSE_CHUNK_SIZE ? universeHeight - yBeg : UNIVERSE_CHUNK_SIZE;
+
+	// Finds the tile on the inputed side.
+	switch (side) {
+	case PATH_WEST:
+		if (!cx) return false;
+		*tile = { (uint_least16_t)xBeg, (uint_least16_t)(yBeg + pathEntranceOffset(entrance, height)) };
+		return true;
+	case PATH_EAST:
+		if (xBeg + UNIVERSE_CHUNK_SIZE >= universeWidth) return false;
+		*tile = { (uint_least16_t)(xBeg + UNIVERSE_CHUNK_SIZE - 1), (uint_least16_t)(yBeg + pathEntranceOffset(entrance, height)) };
+		return true;
+	case PATH_NORTH:
+		if (!cy) return false;
+		*tile = { (uint_least16_t)(xBeg + pathEntranceOffset(entrance, width)), (uint_least16_t)yBeg };
+		return true;
+	default:
+		if (yBeg + UNIVERSE_CHUNK_SIZE >= universeHeight) return false;
+		*tile = { (uint_least16_t)(xBeg + pathEntranceOffset(entrance, width)), (uint_least16_t)(yBeg + UNIVERSE_CHUNK_SIZE - 1) };
+		return true;
+
+	}
+}
+
+/*
+Entry of the open list used by PathGraph searches. Entries are never updated in place; a cheaper
+entry is pushed instead, and stale entries are skipped when popped.
+*/
+struct PathOpenEntry {
+	int fValue;
+	int gValue;
+	int node;
+
+};
+
+/*
+Orders PathOpenEntries so that std::push_heap and std::pop_heap give the lowest fValue first,
+with ties going to the entry with the larger gValue.
+*/
+inline bool operator<(const PathOpenEntry& a, const PathOpenEntry& b) {
+	return a.fValue > b.fValue || (a.fValue == b.fValue && a.gValue < b.gValue);
+
+}
+
+/*
+Rectangle of tiles searched by pathWindowSearch, from (xBeg, yBeg) up to but not including
+(xEnd, yEnd). Windows are at most PATH_WINDOW_SIZE tiles on each side.
+
+Tiles within a window are indexed by (x - xBeg) * PATH_WINDOW_SIZE + (y - yBeg).
+*/
+struct PathWindow {
+	int xBeg, yBeg;
+	int xEnd, yEnd;
+
+	// Returns the index of a tile within the window.
+	inline int tile(CoordU coord) { return (coord.x - xBeg) * PATH_WINDOW_SIZE + (coord.y - yBeg); }
+
+	// Returns the tile at an index within the window.
+	inline CoordU coord(int tile) { return { (uint_least16_t)(xBeg + tile / PATH_WINDOW_SIZE), (uint_least16_t)(yBeg + tile % PATH_WINDOW_SIZE) }; }
+
+};
+
+/*
+Returns the window covering a cluster.
+*/
+inline PathWindow pathClusterWindow(int cluster) {
+	int xBeg = (cluster / universe.chunksHigh) << UNIVERSE_CHUNK_SHIFT;
+	int yBeg = (cluster % universe.chunksHigh) << UNIVERSE_CHUNK_SHIFT;
+	return { xBeg, yBeg, xBeg + UNIVERSE_CHUNK_SIZE < universeWidth ? xBeg + UNIVERSE_CHUNK_SIZE : universeWidth,
+		yBeg + UNIVERSE_CHUNK_SIZE < universeHeight ? yBeg + UNIVERSE_CHUNK_SIZE : universeHeight };
+
+}
+
+/*
+Searches the tiles of a window from the tile from, moving in all eight directions. The cost of
+a step is the movement cost of the tile stepped onto.
+
+dist receives the cost of reaching each tile, and parent (if not nullptr) the tile it was
+reached from. Both must hold PATH_WINDOW_TILES ints. If target is not -1, the search is directed
+towards target and stops once it is reached, so only tiles on the way have their costs set.
+Returns the cost of reaching target, or PATH_UNREACHABLE.
+*/
+int pathWindowSearch(PathWindow window, CoordU from, int target, int* dist, int* parent) {
+	CoordU goal = window.coord(target < 0 ? 0 : target);
+	int start = window.tile(from);
+	int xPos, yPos, next, gValue, hValue;
+	PathOpenEntry entry;
+	CoordU curr;
+
+	// Creates the open list from scratch space.
+	ScratchScope scratch;
+	ScratchVector<PathOpenEntry> open;
+
+	// Marks every tile unreached, then opens the starting tile.
+	for (int x = 0; x < window.xEnd - window.xBeg; ++x)
+		for (int y = 0; y < window.yEnd - window.yBeg; ++y)
+			dist[x * PATH_WINDOW_SIZE + y] = PATH_UNREACHABLE;
+	dist[start] = 0;
+	if (parent) parent[start] = -1;
+	open.push_back({ 0, 0, start });
+
+	// Searches until the target is reached or every reachable tile has been closed.
+	while (!open.empty()) {
+		std::pop_heap(open.items, open.items + open.count);
+		entry = open.back();
+		open.pop_back();
+
+		// Skips stale entries, and stops at the target.
+		if (entry.gValue > dist[entry.node]) continue;
+		if (entry.node == target) return entry.gValue;
+		curr = window.coord(entry.node);
+
+		// Opens each adjacent tile within the window if it has been reached more cheaply.
+		for (int i = -1; i < 2; ++i) {
+			for (int j = -1; j < 2; ++j) {
+				xPos = curr.x + i;
+				yPos = curr.y + j;
+				if ((!i && !j) || xPos < window.xBeg || xPos >= window.xEnd || yPos < window.yBeg || yPos >= window.yEnd) continue;
+				next = (xPos - window.xBeg) * PATH_WINDOW_SIZE + (yPos - window.yBeg);
+				gValue = entry.gValue + uMovementCost(xPos, yPos);
+				if (gValue >= dist[next]) continue;
+				dist[next] = gValue;
+				if (parent) parent[next] = entry.node;
+				hValue = target < 0 ? 0 : calcChebyshevDistance(xPos, yPos, goal.x, goal.y) * pathGraph.minCost;
+				open.push_back({ gValue + hValue, gValue, next });
+				std::push_heap(open.items, open.items + open.count);
+
+			}
+		}
+	}
+
+	// Returns the cost of the target, which is PATH_UNREACHABLE if it was never reached.
+	return target < 0 ? PATH_UNREACHABLE : dist[target];
+
+}
+
+/*
+Appends the tiles of the cheapest path within a window from from to to, excluding from itself.
+dist and parent must each hold PATH_WINDOW_TILES ints. Returns false if to cannot be reached.
+*/
+bool refinePathStep(PathWindow window, CoordU from, CoordU to, int* dist, int* parent, ScratchVector<CoordU>& path) {
+	int target = window.tile(to);
+	int first = path.size();
+
+	// Searches for the target.
+	if (from == to) return true;
+	if (pathWindowSearch(window, from, target, dist, parent) == PATH_UNREACHABLE) return false;
+
+	// Places the path's tiles backwards, then reverses them.
+	for (int tile = target; parent[tile] >= 0; tile = parent[tile]) path.push_back(window.coord(tile));
+	std::reverse(path.items + first, path.items + path.count);
+	return true;
+
+}
+
+/*
+Appends the tiles of the cheapest path within a cluster from from to to, excluding from itself.
+Paths within uniform clusters step diagonally, then straight, without searching.
+dist and parent must each hold PATH_WINDOW_TILES ints. Returns false if to cannot be reached.
+*/
+bool refineClusterStep(int cluster, CoordU from, CoordU to, int* dist, int* parent, ScratchVector<CoordU>& path) {
+	if (!pathGraph.clusters[cluster].uniformCost) return refinePathStep(pathClusterWindow(cluster), from, to, dist, parent, path);
+
+	// Steps towards to along both axes until it is reached.
+	while (!(from == to)) {
+		from.x += (from.x < to.x) - (from.x > to.x);
+		from.y += (from.y < to.y) - (from.y > to.y);
+		path.push_back(from);
+
+	}
+	return true;
+
+}
+
+/*
+Computes the costs between every pair of a cluster's nodes.
+
+Clusters whose tiles all share a movement cost, such as empty space, are costed directly from
+the distance between nodes. Other clusters are searched from each of their nodes.
+*/
+void buildPathCluster(int cluster) {
+	PathCluster& curr = pathGraph.clusters[cluster];
+	PathWindow window = pathClusterWindow(cluster);
+	int cost = uMovementCost(window.xBeg, window.yBeg);
+	bool uniform = true;
+	curr.dirty = false;
+
+	// Checks whether every tile shares a movement cost.
+	for (int x = window.xBeg; x < window.xEnd && uniform; ++x)
+		for (int y = window.yBeg; y < window.yEnd && uniform; ++y)
+			uniform = uMovementCost(x, y) == cost;
+	curr.uniformCost = uniform ? cost : 0;
+
+	// Costs uniform clusters by distance alone.
+	if (uniform) {
+		for (int a = 0; a < curr.numNodes; ++a) {
+			CoordU from = pathGraph.nodes[curr.nodes[a]].loc;
+			for (int b = 0; b < curr.numNodes; ++b) {
+				CoordU to = pathGraph.nodes[curr.nodes[b]].loc;
+				curr.costs[a * curr.numNodes + b] = calcChebyshevDistance(from.x, from.y, to.x, to.y) * cost;
+
+			}
+		}
+		return;
+
+	}
+
+	// Searches from each node to find its cost to every other node.
+	ScratchScope scratch;
+	int* dist = scratch.array<int>(PATH_WINDOW_TILES);
+	for (int a = 0; a < curr.numNodes; ++a) {
+		pathWindowSearch(window, pathGraph.nodes[curr.nodes[a]].loc, -1, dist, nullptr);
+		for (int b = 0; b < curr.numNodes; ++b) curr.costs[a * curr.numNodes + b] = dist[window.tile(pathGraph.nodes[curr.nodes[b]].loc)];
+
+	}
+}
+
+/*
+Computes the cost of each trade lane, which is the sum of the movement costs of its tiles.
+*/
+void costPathLanes() {
+	for (int s = 0; s < pathGraph.numNodes - pathGraph.firstSystem; ++s) {
+		System* system = &allSystemSpace[s];
+		for (int l = pathGraph.firstLane[s]; l < pathGraph.firstLane[s + 1]; ++l) {
+			PathLane& lane = pathGraph.lanes[l];
+			lane.cost = 0;
+			for (int i = 1; i <= system->tradeLanes[lane.offset].x; ++i)
+				lane.cost += uMovementCost(system->loc.x + system->tradeLanes[lane.offset + i].x, system->loc.y + system->tradeLanes[lane.offset + i].y);
+
+		}
+	}
+}
+
+/*
+Frees the current PathGraph, then builds one for the current universe. Should be called once the
+universe's tiles and Systems (including their tradeLanes) have been placed.
+
+Systems loaded from a save have no tradeLanes, and are only joined through their clusters.
+*/
+void initPathGraph() {
+	int numSystems = 0;
+	int numLanes = 0;
+
+	// Frees the previous graph.
+	for (int c = 0; c < pathGraph.numClusters; ++c) {
+		free(pathGraph.clusters[c].nodes);
+		free(pathGraph.clusters[c].costs);
+
+	}
+	free(pathGraph.nodes);
+	free(pathGraph.clusters);
+	free(pathGraph.lanes);
+	free(pathGraph.firstLane);
+
+	// Finds the lowest movement cost for the heuristics.
+	pathGraph.minCost = universeMovementCost[0];
+	for (int cost : universeMovementCost) if (cost < pathGraph.minCost) pathGraph.minCost = cost;
+
+	// Allocates the nodes and clusters.
+	for (int c = 0; c < universe.chunksWide * universe.chunksHigh; ++c) numSystems += universe.chunks[c].numSystems;
+	pathGraph.numClusters = universe.chunksWide * universe.chunksHigh;
+	pathGraph.firstSystem = pathGraph.numClusters * PATH_CLUSTER_PORTS;
+	pathGraph.numNodes = pathGraph.firstSystem + numSystems;
+	pathGraph.nodes = (PathNode*)malloc(sizeof(PathNode) * pathGraph.numNodes);
+	pathGraph.clusters = (PathCluster*)calloc(pathGraph.numClusters, sizeof(PathCluster));
+
+	// Places the entrances of each cluster, along with the partner of each entrance.
+	for (int c = 0; c < pathGraph.numClusters; ++c) {
+		int cx = c / universe.chunksHigh;
+		int cy = c % universe.chunksHigh;
+		int neighbours[] = { c - universe.chunksHigh, c + universe.chunksHigh, c - 1, c + 1 };
+		PathCluster& curr = pathGraph.clusters[c];
+		curr.nodes = (int*)malloc(sizeof(int) * (PATH_CLUSTER_PORTS + universe.chunks[c].numSystems));
+		for (int side = 0; side < 4; ++side) {
+			for (int e = 0; e < PATH_CLUSTER_ENTRANCES; ++e) {
+				int node = c * PATH_CLUSTER_PORTS + side * PATH_CLUSTER_ENTRANCES + e;
+				PathNode& entrance = pathGraph.nodes[node];
+				entrance.cluster = c;
+				entrance.partner = -1;
+				entrance.local = -1;
+				if (!pathEntranceTile(cx, cy, side, e, &entrance.loc)) continue;
+				entrance.partner = neighbours[side] * PATH_CLUSTER_PORTS + (side ^ 1) * PATH_CLUSTER_ENTRANCES + e;
+				entrance.local = curr.numNodes;
+				curr.nodes[curr.numNodes++] = node;
+
+			}
+		}
+	}
+
+	// Places each System in its cluster, and counts the trade lanes.
+	for (int s = 0; s < numSystems; ++s) {
+		System* system = &allSystemSpace[s];
+		PathNode& node = pathGraph.nodes[pathGraph.firstSystem + s];
+		PathCluster& cluster = pathGraph.clusters[universe.chunkOf(system->loc.x, system->loc.y)];
+		node.loc = system->loc;
+		node.cluster = universe.chunkOf(system->loc.x, system->loc.y);
+		node.partner = -1;
+		node.local = cluster.numNodes;
+		cluster.nodes[cluster.numNodes++] = pathGraph.firstSystem + s;
+		for (int i = 0; system->tradeLanes && (system->tradeLanes[i].x || system->tradeLanes[i].y); i += system->tradeLanes[i].x + 1) ++numLanes;
+
+	}
+
+	// Places the trade lanes. Each lane ends in the System it leads to.
+	pathGraph.lanes = (PathLane*)malloc(sizeof(PathLane) * (numLanes + 1));
+	pathGraph.firstLane = (int*)malloc(sizeof(int) * (numSystems + 1));
+	numLanes = 0;
+	for (int s = 0; s < numSystems; ++s) {
+		System* system = &allSystemSpace[s];
+		pathGraph.firstLane[s] = numLanes;
+		for (int i = 0; system->tradeLanes && (system->tradeLanes[i].x || system->tradeLanes[i].y); i += system->tradeLanes[i].x + 1) {
+			CoordI end = system->tradeLanes[i + system->tradeLanes[i].x];
+			System* dest = uSystem(system->loc.x + end.x, system->loc.y + end.y);
+			pathGraph.lanes[numLanes++] = { pathGraph.firstSystem + (int)(dest - allSystemSpace), 0, i };
+
+		}
+	}
+	pathGraph.firstLane[numSystems] = numLanes;
+
+	// Costs every cluster and trade lane.
+	for (int c = 0; c < pathGraph.numClusters; ++c) {
+		PathCluster& curr = pathGraph.clusters[c];
+		curr.costs = (int*)malloc(sizeof(int) * curr.numNodes * curr.numNodes);
+		curr.dirty = true;
+
+	}
+	pathGraph.dirty = true;
+	updatePathGraph();
+
+}
+
+/*
+Marks the cluster containing a tile for rebuilding. Must be called whenever the movement cost of a
+tile changes. The cluster is rebuilt by the next call to updatePathGraph.
+*/
+inline void markPathTile(int xPos, int yPos) {
+	pathGraph.clusters[universe.chunkOf(xPos, yPos)].dirty = true;
+	pathGraph.dirty = true;
+
+}
+
+/*
+Rebuilds every dirty cluster, spread over all threads, then recosts every trade lane. Does nothing
+if no cluster is dirty.
+
+Must only be called while no paths are being found. This is called at the start of spaceBattle.
+*/
+void updatePathGraph() {
+	if (!pathGraph.dirty) return;
+	pathGraph.dirty = false;
+
+	// Rebuilds the dirty clusters.
+	parallelFor(0, pathGraph.numClusters, 16, [](int beg, int end) {
+		for (int c = beg; c < end; ++c) if (pathGraph.clusters[c].dirty) buildPathCluster(c);
+
+	});
+
+	// Recosts the trade lanes, which may cross any cluster.
+	costPathLanes();
+
+}
+
+/*
+Finds the cheapest path between two tiles, placing every tile of the path (including both ends)
+in path. Returns false if there is no path.
+
+Paths between nearby tiles are found directly. Longer paths search the PathGraph: the start
+is joined to the nodes of its cluster and the destination to the nodes of its own, the graph is
+searched with A*, and then each step of the result is refined into tiles.
+
+Everything is allocated from the calling thread's scratch space without a ScratchScope of its
+own, as path may grow at any point. The caller's ScratchScope frees it along with path.
+*/
+bool findUniversePath(CoordU start, CoordU dest, ScratchVector<CoordU>& path) {
+	int startCluster = universe.chunkOf(start.x, start.y);
+	int destCluster = universe.chunkOf(dest.x, dest.y);
+	int goal = pathGraph.numNodes;
+	int costToDest, node, gValue;
+	PathOpenEntry entry;
+
+	PathWindow startWindow = pathClusterWindow(startCluster);
+	PathWindow destWindow = pathClusterWindow(destCluster);
+
+	// Allocates the searches within windows.
+	int* startDist = (int*)scratchArena.allocate(sizeof(int) * PATH_WINDOW_TILES);
+	int* destDist = (int*)scratchArena.allocate(sizeof(int) * PATH_WINDOW_TILES);
+	int* parentTiles = (int*)scratchArena.allocate(sizeof(int) * PATH_WINDOW_TILES);
+
+	// Finds short paths directly, within a window centred between the two ends. Otherwise,
+	// paths which cross a cluster's side would have to pass through one of its entrances.
+	path.push_back(start);
+	if (calcChebyshevDistance(start.x, start.y, dest.x, dest.y) <= UNIVERSE_CHUNK_SIZE) {
+		PathWindow window;
+		window.xBeg = (start.x + dest.x) / 2 - PATH_WINDOW_SIZE / 2;
+		window.yBeg = (start.y + dest.y) / 2 - PATH_WINDOW_SIZE / 2;
+		if (window.xBeg > universeWidth - PATH_WINDOW_SIZE) window.xBeg = universeWidth - PATH_WINDOW_SIZE;
+		if (window.yBeg > universeHeight - PATH_WINDOW_SIZE) window.yBeg = universeHeight - PATH_WINDOW_SIZE;
+		if (window.xBeg < 0) window.xBeg = 0;
+		if (window.yBeg < 0) window.yBeg = 0;
+		window.xEnd = window.xBeg + PATH_WINDOW_SIZE < universeWidth ? window.xBeg + PATH_WINDOW_SIZE : universeWidth;
+		window.yEnd = window.yBeg + PATH_WINDOW_SIZE < universeHeight ? window.yBeg + PATH_WINDOW_SIZE : universeHeight;
+		if (refinePathStep(window, start, dest, destDist, parentTiles, path)) return true;
+
+	}
+
+	// Allocates the search. Each node stores its gValue, parent, and the trade lane it was reached by.
+	ExploredMap* exploredMap = requestExploredMap(pathGraph.numNodes + 1);
+	int* gValues = (int*)scratchArena.allocate(sizeof(int) * (pathGraph.numNodes + 1));
+	int* parents = (int*)scratchArena.allocate(sizeof(int) * (pathGraph.numNodes + 1));
+	int* lanes = (int*)scratchArena.allocate(sizeof(int) * (pathGraph.numNodes + 1));
+	ScratchVector<PathOpenEntry> open;
+	PathCluster& first = pathGraph.clusters[startCluster];
+	PathCluster& last = pathGraph.clusters[destCluster];
+
+	// Opens a node if it has been reached more cheaply.
+	auto relax = [&](int next, int gValue, int parent, int lane) {
+		if (exploredMap->get(next) == PATH_CLOSED) return;
+		if (exploredMap->get(next) == PATH_OPEN && gValues[next] <= gValue) return;
+		exploredMap->set(next, PATH_OPEN);
+		gValues[next] = gValue;
+		parents[next] = parent;
+		lanes[next] = lane;
+		CoordU loc = next == goal ? dest : pathGraph.nodes[next].loc;
+		open.push_back({ gValue + calcChebyshevDistance(loc.x, loc.y, dest.x, dest.y) * pathGraph.minCost, gValue, next });
+		std::push_heap(open.items, open.items + open.count);
+
+	};
+
+	// Joins the start to the nodes of its cluster. Uniform clusters are costed by distance alone.
+	if (!first.uniformCost) pathWindowSearch(startWindow, start, -1, startDist, nullptr);
+	for (int i = 0; i < first.numNodes; ++i) {
+		CoordU loc = pathGraph.nodes[first.nodes[i]].loc;
+		gValue = first.uniformCost ? calcChebyshevDistance(start.x, start.y, loc.x, loc.y) * first.uniformCost : startDist[startWindow.tile(loc)];
+		if (gValue != PATH_UNREACHABLE) relax(first.nodes[i], gValue, -1, -1);
+
+	}
+
+	// Searches from the destination, so that the nodes of its cluster can be joined to it. Step costs
+	// are paid on arrival, so the cost from a node is the cost to it, less its own cost, plus the destination's.
+	if (!last.uniformCost) pathWindowSearch(destWindow, dest, -1, destDist, nullptr);
+
+	// Searches the graph until the destination is reached.
+	while (!open.empty()) {
+		std::pop_heap(open.items, open.items + open.count);
+		entry = open.back();
+		open.pop_back();
+		node = entry.node;
+		if (exploredMap->get(node) == PATH_CLOSED || entry.gValue > gValues[node]) continue;
+		exploredMap->set(node, PATH_CLOSED);
+		if (node == goal) break;
+		PathNode& curr = pathGraph.nodes[node];
+		PathCluster& cluster = pathGraph.clusters[curr.cluster];
+
+		// Joins nodes of the destination's cluster to the destination.
+		if (curr.cluster == destCluster) {
+			if (last.uniformCost) relax(goal, entry.gValue + calcChebyshevDistance(curr.loc.x, curr.loc.y, dest.x, dest.y) * last.uniformCost, node, -1);
+			else if ((costToDest = destDist[destWindow.tile(curr.loc)]) != PATH_UNREACHABLE)
+				relax(goal, entry.gValue + costToDest - uMovementCost(curr.loc.x, curr.loc.y) + uMovementCost(dest.x, dest.y), node, -1);
+
+		}
+
+		// Crosses to the partner entrance of the neighbouring cluster.
+		if (curr.partner >= 0) {
+			CoordU loc = pathGraph.nodes[curr.partner].loc;
+			relax(curr.partner, entry.gValue + uMovementCost(loc.x, loc.y), node, -1);
+
+		}
+
+		// Moves to the other nodes of the cluster.
+		for (int i = 0; i < cluster.numNodes; ++i) {
+			int cost = cluster.costs[curr.local * cluster.numNodes + i];
+			if (i != curr.local && cost != PATH_UNREACHABLE) relax(cluster.nodes[i], entry.gValue + cost, node, -1);
+
+		}
+
+		// Follows the trade lanes of a System.
+		if (node >= pathGraph.firstSystem) {
+			for (int l = pathGraph.firstLane[node - pathGraph.firstSystem]; l < pathGraph.firstLane[node - pathGraph.firstSystem + 1]; ++l)
+				relax(pathGraph.lanes[l].to, entry.gValue + pathGraph.lanes[l].cost, node, l);
+
+		}
+	}
+
+	// Fails if the destination was never reached.
+	if (exploredMap->get(goal) != PATH_CLOSED) {
+		releaseExploredMap(exploredMap);
+		return false;
+
+	}
+	releaseExploredMap(exploredMap);
+
+	// Lists the nodes of the path and the trade lanes between them, from the destination backwards.
+	int length = 0;
+	int* steps = (int*)scratchArena.allocate(sizeof(int) * (pathGraph.numNodes + 1));
+	int* stepLanes = (int*)scratchArena.allocate(sizeof(int) * (pathGraph.numNodes + 1));
+	for (node = goal; node >= 0; node = parents[node]) {
+		stepLanes[length] = lanes[node];
+		steps[length++] = node;
+
+	}
+
+	// Refines each step of the path into tiles.
+	CoordU prev = start;
+	int prevCluster = startCluster;
+	for (int i = length - 1; i >= 0; --i) {
+		node = steps[i];
+		CoordU loc = node == goal ? dest : pathGraph.nodes[node].loc;
+		int nodeCluster = node == goal ? destCluster : pathGraph.nodes[node].cluster;
+
+		// Copies the tiles of a trade lane.
+		if (stepLanes[i] >= 0) {
+			PathLane& lane = pathGraph.lanes[stepLanes[i]];
+			System* system = uSystem(prev.x, prev.y);
+			for (int t = 1; t <= system->tradeLanes[lane.offset].x; ++t)
+				path.push_back({ (uint_least16_t)(system->loc.x + system->tradeLanes[lane.offset + t].x), (uint_least16_t)(system->loc.y + system->tradeLanes[lane.offset + t].y) });
+
+		}
+		// Steps across to a neighbouring cluster.
+		else if (nodeCluster != prevCluster) path.push_back(loc);
+
+		// Refines a step within a cluster.
+		else if (!refineClusterStep(nodeCluster, prev, loc, destDist, parentTiles, path)) return false;
+
+		prev = loc;
+		prevCluster = nodeCluster;
+
+	}
+	return true;
+
+}
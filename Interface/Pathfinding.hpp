@@ -174,8 +174,12 @@ bool operator<=(const PathCoordinate& coord, const PathCoordinate& other) {
 
 /*
 Fills and returns a Direction according to the inputed lambda expression.
+
+The direction functions take any callable type rather than a std::function, so that the lambda
+is inlined instead of being called indirectly for every tile.
 */
-inline Direction fillDirection(int xBeg, int yBeg, std::function<bool(int x, int y)> fillFunc) {
+template<class FillFunc>
+inline Direction fillDirection(int xBeg, int yBeg, const FillFunc& fillFunc) {
 	Direction dir;
 	dir.d.nw = fillFunc(xBeg - 1, yBeg -1);
 	dir.d.n  = fillFunc(xBeg,     yBeg - 1);
@@ -192,7 +196,8 @@ inline Direction fillDirection(int xBeg, int yBeg, std::function<bool(int x, int
 /*
 Performs an action in every direction according to the inputed lambda expression.
 */
-inline void actionDirection(int xBeg, int yBeg, std::function<void(int x, int y)> actionFunc) {
+template<class ActionFunc>
+inline auto actionDirection(int xBeg, int yBeg, const ActionFunc& actionFunc) -> decltype(actionFunc(xBeg, yBeg), void()) {
 	actionFunc(xBeg, yBeg - 1);
 	actionFunc(xBeg + 1, yBeg);
 	actionFunc(xBeg, yBeg + 1);
@@ -208,7 +213,8 @@ inline void actionDirection(int xBeg, int yBeg, std::function<void(int x, int y)
 Performs an action in every direction according to the inputed lambda expression.
 Will return true if any lambda returns true, otherwise will return false.
 */
-inline bool actionDirectionCond(int xBeg, int yBeg, std::function<bool(int x, int y)> actionFunc) {
+template<class ActionFunc>
+inline auto actionDirectionCond(int xBeg, int yBeg, const ActionFunc& actionFunc) -> decltype(actionFunc(xBeg, yBeg), bool()) {
 	if (actionFunc(xBeg, yBeg - 1)) return true;
 	if (actionFunc(xBeg + 1, yBeg)) return true;
 	if (actionFunc(xBeg, yBeg + 1)) return true;
@@ -225,7 +231,8 @@ inline bool actionDirectionCond(int xBeg, int yBeg, std::function<bool(int x, in
 Performs an action in every direction according to the inputed lambda expression.
 This is distinct from actionDirection in that Dir is an input to the lambda.
 */
-inline void actionDirection(int xBeg, int yBeg, std::function<void(int x, int y, Dir d)> actionFunc) {
+template<class ActionFunc>
+inline auto actionDirection(int xBeg, int yBeg, const ActionFunc& actionFunc) -> decltype(actionFunc(xBeg, yBeg, north), void()) {
 	actionFunc(xBeg, yBeg - 1, north);
 	actionFunc(xBeg + 1, yBeg, east);
 	actionFunc(xBeg, yBeg + 1, south);
@@ -242,7 +249,8 @@ Performs an action in every direction according to the inputed lambda expression
 Will return true if any lambda returns true, otherwise will return false.
 This is distinct from actionDirection in that Dir is an input to the lambda.
 */
-inline bool actionDirectionCond(int xBeg, int yBeg, std::function<bool(int x, int y, Dir d)> actionFunc) {
+template<class ActionFunc>
+inline auto actionDirectionCond(int xBeg, int yBeg, const ActionFunc& actionFunc) -> decltype(actionFunc(xBeg, yBeg, north), bool()) {
 	if (actionFunc(xBeg, yBeg - 1, north)) return true;
 	if (actionFunc(xBeg + 1, yBeg, east)) return true;
 	if (actionFunc(xBeg, yBeg + 1, south)) return true;
@@ -343,99 +351,355 @@ void planetCoordDirection(Coordinate start, Coordinate dest, Direction* dir) {
 
 }
 
-// Global lists of pathfinding coordinates. Reused to avoid unecessary allocating/deallocating 
-// of coordinates during pathfinding.
-// There will be one list of coords per thread.
-LinkedList<PathCoordinate>** coordLists;
-bool* coordAccess;
+// Free list of pathfinding coordinates. Each search keeps its own, allocated from the calling
+// thread's ScratchArena, so that coordinates are reused within a search without limiting its size.
+typedef ScratchList<PathCoordinate> CoordList;
+
+// States of a tile within a pathfinding exploredMap. Tiles are placed in the
+// PathHeap when opened and are removed from it when closed.
+#define PATH_UNSEEN 0
+#define PATH_OPEN 1
+#define PATH_CLOSED 2
+
+/*
+Binary min-heap used as the open list for A* searches. Nodes are ordered by
+gValue + hValue, with ties going to the node with the larger gValue.
+
+Every tile in the heap has its heap position stored in slots, indexed by
+index(x, y, width). This allows decreaseKey to find an open tile in O(1).
+Slots are only valid for tiles marked PATH_OPEN in the calling function's
+exploredMap, so slots never need to be cleared between searches.
+
+There will be one PathHeap per thread.
+*/
+class PathHeap {
+public:
+
+	// Heap of nodes. The lowest fValue is at nodes[0].
+	LinkedListNode<PathCoordinate>** nodes;
+
+	// Heap position of every open tile.
+	int* slots;
+
+	// Width of the searched area. Used to find the slot of a node.
+	int width;
+
+	// Current and maximum number of nodes in the heap.
+	int numNodes;
+	int nodeCapacity;
+
+	// Number of slots allocated.
+	int slotCapacity;
+
+	// Readies the heap for a search over an area of the given size.
+	void reset(int width, int height);
+
+	// Checks if the heap is empty.
+	inline bool isEmpty() { return !numNodes; }
+
+	// Adds a node to the heap.
+	void push(LinkedListNode<PathCoordinate>* node);
+
+	// Removes and returns the node with the lowest fValue.
+	LinkedListNode<PathCoordinate>* pop();
+
+	// Lowers the gValue of an open tile and updates its parent.
+	LinkedListNode<PathCoordinate>* decreaseKey(int x, int y, float gValue, LinkedListNode<PathCoordinate>* previous);
+
+	// Empties the heap into the inputed coordList.
+	void empty(CoordList* coordList);
+
+private:
+
+	// Checks if node a should be popped before node b.
+	inline bool before(LinkedListNode<PathCoordinate>* a, LinkedListNode<PathCoordinate>* b);
+
+	// Places a node at the given position and updates its slot.
+	inline void place(LinkedListNode<PathCoordinate>* node, int pos);
+
+	// Moves the node at pos up or down the heap until it is in order.
+	void siftUp(int pos);
+	void siftDown(int pos);
+
+};
+
+/*
+Readies the heap for a search over an area of the given size. Grows slots
+if the area is larger than any area searched previously.
+*/
+void PathHeap::reset(int width, int height) {
+	this->width = width;
+	numNodes = 0;
+
+	// Grows slots to fit the area.
+	if (slotCapacity < width * height) {
+		slotCapacity = width * height;
+		slots = (int*)realloc(slots, sizeof(int) * slotCapacity);
+
+	}
+}
+
+/*
+Adds a node to the heap. The node's tile should be marked PATH_OPEN by the caller.
+*/
+void PathHeap::push(LinkedListNode<PathCoordinate>* node) {
+
+	// Grows nodes if the heap is full.
+	if (numNodes == nodeCapacity) {
+		nodeCapacity = nodeCapacity ? nodeCapacity * 2 : 256;
+		nodes = (LinkedListNode<PathCoordinate>**)realloc(nodes, sizeof(LinkedListNode<PathCoordinate>*) * nodeCapacity);
+
+	}
+
+	// Places the node at the bottom of the heap and moves it up.
+	place(node, numNodes);
+	siftUp(numNodes++);
+
+}
 
 /*
-Initializes the coordinate list to contain at least the given number of coordinates.
+Removes and returns the node with the lowest fValue. The heap should not be empty.
 */
-void initCoordLists(int numItems) {
-	int size = 0;
-	int needed;
-	int numLists = numThreads;
-
-	// Creates the coordLists if none have been created.
-	if (coordLists == nullptr) {
-		coordLists = new LinkedList<PathCoordinate>* [numLists];
-		coordAccess = new bool[numLists];
-		for (int i = 0; i < numLists; ++i) {
-			coordLists[i] = new LinkedList<PathCoordinate>();
-			coordAccess[i] = true;
-
-		}
+LinkedListNode<PathCoordinate>* PathHeap::pop() {
+	LinkedListNode<PathCoordinate>* ret = nodes[0];
+
+	// Moves the last node to the top of the heap and moves it down.
+	if (--numNodes) {
+		place(nodes[numNodes], 0);
+		siftDown(0);
+
 	}
 
-	// Calculates the total amount of coordinates needed.
-	for (int i = 0; i < numLists; ++i) size += numItems - coordLists[i]->size();
+	// Returns the removed node.
+	ret->child = nullptr;
+	return ret;
+
+}
+
+/*
+Lowers the gValue of an open tile and updates its parent.
+Returns the updated node, or nullptr if the inputed gValue is not lower than the
+tile's current gValue.
+*/
+LinkedListNode<PathCoordinate>* PathHeap::decreaseKey(int x, int y, float gValue, LinkedListNode<PathCoordinate>* previous) {
+	int pos = slots[index(x, y, width)];
+	LinkedListNode<PathCoordinate>* node = nodes[pos];
+
+	// Returns nullptr if no cheaper path has been found.
+	if (gValue >= node->value->gValue) return nullptr;
+
+	// Updates the node and moves it up the heap.
+	node->value->gValue = gValue;
+	node->previous = previous;
+	siftUp(pos);
+	return node;
+
+}
+
+/*
+Empties the heap into the inputed coordList.
+*/
+void PathHeap::empty(CoordList* coordList) {
+	for (int i = 0; i < numNodes; ++i) {
+		nodes[i]->child = nullptr;
+		coordList->addc(nodes[i]);
+
+	}
+	numNodes = 0;
+
+}
+
+/*
+Checks if node a should be popped before node b. Compares fValues, and
+prefers the node with the larger gValue when fValues are equal.
+*/
+inline bool PathHeap::before(LinkedListNode<PathCoordinate>* a, LinkedListNode<PathCoordinate>* b) {
+	float aF = a->value->gValue + a->value->hValue;
+	float bF = b->value->gValue + b->value->hValue;
+	return aF < bF || (aF == bF && a->value->gValue > b->value->gValue);
 
-	// Creates enough LinkedListNodes to fill the gap.
-	LinkedListNode<PathCoordinate>* nodes = (LinkedListNode<PathCoordinate>*)malloc(sizeof(LinkedListNode<PathCoordinate>) * size);
-	PathCoordinate* coords = (PathCoordinate*)malloc(sizeof(PathCoordinate) * size);
+}
 
-	// Places the coords into the nodes.
-	for (int i = 0; i < size; ++i) nodes[i].value = coords++;
+/*
+Places a node at the given position and updates its slot.
+*/
+inline void PathHeap::place(LinkedListNode<PathCoordinate>* node, int pos) {
+	nodes[pos] = node;
+	slots[index(node->value->coord.x, node->value->coord.y, width)] = pos;
 
-	// Initializes each coordList to contain at least numItems PathCoordinates.
-	int currNode = 0;
-	for (int i = 0; i < numLists; ++i) {
-		needed = numItems - coordLists[i]->size();
-		for (int j = 0; j < needed; ++j) {
-			coordLists[i]->addc(nodes++);
+}
+
+/*
+Moves the node at pos up the heap until its parent is before it.
+*/
+void PathHeap::siftUp(int pos) {
+	LinkedListNode<PathCoordinate>* node = nodes[pos];
+	int parent;
+
+	// Moves parents down until a place for node is found.
+	while (pos) {
+		parent = (pos - 1) >> 1;
+		if (!before(node, nodes[parent])) break;
+		place(nodes[parent], pos);
+		pos = parent;
 
-		}
 	}
+	place(node, pos);
+
 }
 
 /*
-Initializes the coordinate list to contain at least 10000 coords.
-TODO make amount of coords dynamic, like dummy size
+Moves the node at pos down the heap until it is before both of its children.
 */
-void initCoordLists() {
+void PathHeap::siftDown(int pos) {
+	LinkedListNode<PathCoordinate>* node = nodes[pos];
+	int child;
+
+	// Moves children up until a place for node is found.
+	while ((child = (pos << 1) + 1) < numNodes) {
+		if (child + 1 < numNodes && before(nodes[child + 1], nodes[child])) ++child;
+		if (!before(nodes[child], node)) break;
+		place(nodes[child], pos);
+		pos = child;
+
+	}
+	place(node, pos);
+
+}
+
+// Global PathHeaps. There will be one heap per thread.
+PathHeap* pathHeaps;
+SlotPool pathHeapPool;
+
+/*
+Initializes one empty PathHeap per thread. Heaps grow as they are used.
+*/
+void initPathHeaps() {
+	if (pathHeaps != nullptr) return;
+	pathHeaps = (PathHeap*)calloc(numThreads, sizeof(PathHeap));
+	pathHeapPool.init(numThreads);
+
+}
+
+/*
+Allows threads to request access to a PathHeap. The heap will be reset to
+fit an area of the given size. Should always return a value.
+*/
+PathHeap* requestPathHeap(int width, int height) {
+	int i = pathHeapPool.claim();
+
+	// Resets and returns the PathHeap.
+	pathHeaps[i].reset(width, height);
+	return &pathHeaps[i];
+
+}
 
-	// Calls initCoordLists with 10000 as the argument.
-	initCoordLists(10000);
+/*
+Allows threads to release access rights to a PathHeap.
+*/
+inline void releasePathHeap(PathHeap* heap) {
+	pathHeapPool.release((int)(heap - pathHeaps));
 
 }
 
+// Number of states which a tile may take within an ExploredMap, including PATH_UNSEEN.
+#define EXPLORED_MAP_STATES 4
+
 /*
-Allows threads to request access to a coordList. Should always return a value.
+Map used to mark down explored tiles during searches. Each tile stores a 16 bit
+stamp rather than a flag, so clearing the map only increments the epoch instead
+of writing over every tile. The map is only written over when the epoch wraps.
+
+A tile is in state s (PATH_OPEN, PATH_CLOSED, etc.) when its stamp is equal to
+epoch + s. Any stamp no greater than epoch is PATH_UNSEEN.
+
+There will be one ExploredMap per thread, similar to PathHeaps.
 */
-LinkedList<PathCoordinate>* requestCoordList() {
-	static std::shared_mutex coordListMutex;
+class ExploredMap {
+public:
+
+	// Stamp of every tile.
+	uint_least16_t* stamps;
+
+	// Stamp representing PATH_UNSEEN in the current search.
+	uint_least16_t epoch;
+
+	// Number of tiles allocated.
+	int capacity;
 
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex> lock(coordListMutex);
+	// Marks every tile as PATH_UNSEEN.
+	inline void clear();
 
-	// Finds the first available coordList.
-	// It is assumed that at least one will be available at any time.
-	int i;
-	for (i = 0;; ++i) {
+	// Returns the state of a tile.
+	inline uint_least8_t get(int i) { return stamps[i] > epoch ? stamps[i] - epoch : PATH_UNSEEN; }
+
+	// Sets the state of a tile. The state should not be PATH_UNSEEN.
+	inline void set(int i, uint_least8_t state) { stamps[i] = epoch + state; }
+
+	// Checks if a tile has been visited, and marks it visited.
+	inline bool visited(int i) { return stamps[i] > epoch; }
+	inline void visit(int i) { stamps[i] = epoch + PATH_OPEN; }
+
+};
+
+/*
+Marks every tile as PATH_UNSEEN by moving on to the next epoch. Resets all
+stamps if the epoch would overflow.
+*/
+inline void ExploredMap::clear() {
 
-		// If i is accessible, breaks.
-		if (coordAccess[i]) {
-			coordAccess[i] = false;
-			break;
+	// Moves to the next epoch. Previous stamps are all no greater than the new epoch.
+	if (epoch <= UINT16_MAX - 2 * EXPLORED_MAP_STATES) epoch += EXPLORED_MAP_STATES;
+
+	// Resets all stamps if the epoch has run out.
+	else {
+		memset(stamps, 0, sizeof(uint_least16_t) * capacity);
+		epoch = 0;
 
-		}
 	}
+}
 
-	// Returns the coordList.
-	return coordLists[i];
+// Global ExploredMaps. There will be one map per thread.
+ExploredMap* exploredMaps;
+SlotPool exploredMapPool;
+
+/*
+Initializes one empty ExploredMap per thread. Maps are allocated when first requested.
+*/
+void initExploredMaps() {
+	if (exploredMaps != nullptr) return;
+	exploredMaps = (ExploredMap*)calloc(numThreads, sizeof(ExploredMap));
+	exploredMapPool.init(numThreads);
 
 }
 
 /*
-Allows threads to release access rights to a coordList.
+Allows threads to request access to an ExploredMap containing at least numTiles
+tiles. The map will be cleared. Should always return a value.
 */
-void releaseCoordList(LinkedList<PathCoordinate>* inputList) {
-	int numLists = numThreads;
+ExploredMap* requestExploredMap(int numTiles) {
+	ExploredMap* map = &exploredMaps[exploredMapPool.claim()];
+
+	// Reallocates the map if it is too small. New maps start out cleared.
+	if (map->capacity < numTiles) {
+		free(map->stamps);
+		map->stamps = (uint_least16_t*)calloc(numTiles, sizeof(uint_least16_t));
+		map->capacity = numTiles;
+		map->epoch = 0;
+		return map;
+
+	}
+
+	// Clears and returns the map.
+	map->clear();
+	return map;
 
-	// Finds the coordList in the array and marks it as available.
-	for (int i = 0; i < numLists; ++i)
-		if (coordLists[i] == inputList)
-			coordAccess[i] = true;
+}
 
-}
\ No newline at end of file
+/*
+Allows threads to release access rights to an ExploredMap.
+*/
+inline void releaseExploredMap(ExploredMap* map) {
+	exploredMapPool.release((int)(map - exploredMaps));
+
+}
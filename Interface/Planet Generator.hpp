@@ -1,61 +1,24 @@
 #pragma once
 
-// Number of elements in a habitable page. Should be around 1MB.
-#define HABITABLE_PAGE_SIZE ((1048576 - 8) / sizeof(HabitablePlanet))
-
-// Number of elements in a barren page. Should be around 1MB.
-#define BARREN_PAGE_SIZE ((1048576 - 8) / sizeof(BarrenPlanet))
-
-// Block size used when reallocating HabitablePage page table.
-#define NUM_HABITABLE_PAGES 256
-
-// Block size used when reallocating BarrenPage page table.
-#define NUM_BARREN_PAGES 256
-
-// Page of Habitable Planets.
-struct HabitablePage {
-	HabitablePlanet planets[HABITABLE_PAGE_SIZE];
-	uint16_t arrCurrPlanet;
-	bool active;
-
-	// 5 padding
-
-};
-
-// Page of Barren Planets.
-struct BarrenPage {
-	BarrenPlanet planets[BARREN_PAGE_SIZE];
-	uint16_t arrCurrBarren;
-	bool active;
-
-	// 5 padding
-
-};
-
 // Contains all HabitablePlanets. Minimizes memory use from allocations.
-int numHabitablePages;
-HabitablePage** habitablePages;
+PagedPool<HabitablePlanet> habitablePool;
 
 // Contains all BarrenPlanets. Minimizes memory use from allocations.
-int numBarrenPages;
-BarrenPage** barrenPages;
+PagedPool<BarrenPlanet> barrenPool;
 
 // Stores all planet tiles.
 std::vector<PlanetTile*> allPlanetTiles;
 
-// Initializes the habitablePages array.
+// Initializes habitablePool.
 void initHabitablePlanets(int numHabitable);
 
-// Places a HabitablePlanet into habitablePages.
+// Places a HabitablePlanet into habitablePool.
 HabitablePlanet* placeHabitable(int size);
 
-// Finds the location of a given HabitablePlanet within the paging table.
-inline void findHabitableIndex(int& page, int& index, HabitablePlanet* planet);
-
-// Initializes the barrenPlanets array.
+// Initializes barrenPool.
 void initBarrenPlanets(int numBarren);
 
-// Places a barren planet into barrenPlanets.
+// Places a barren planet into barrenPool.
 BarrenPlanet* placeBarren();
 
 // Generates a random planet from scratch.
@@ -176,26 +139,15 @@ PlanetTile* placePlanetTiles(int size, bool init) {
 }
 
 /*
-Initializes the habitablePages array.
+Initializes habitablePool.
 */
 void initHabitablePlanets(int numHabitable) {
+	habitablePool.init(numHabitable);
 
-	// Frees habitablePages for reuse.
-	if (numHabitablePages) {
-		for (int i = 0; i < numHabitablePages; ++i) {
-			if (habitablePages[i]) delete habitablePages[i];
-			habitablePages[i] = nullptr;
-
-		}
-		delete[] habitablePages;
-
-	}
-
-	// Initializes habitablePages.
-	numHabitablePages = numHabitable / HABITABLE_PAGE_SIZE + 1;
-	habitablePages = (HabitablePage**)calloc(numHabitablePages + NUM_HABITABLE_PAGES - (numHabitablePages % NUM_HABITABLE_PAGES), sizeof(HabitablePage*));
-	for (int i = 0; i < numHabitablePages; ++i)
-		habitablePages[i] = (HabitablePage*)calloc(1, sizeof(HabitablePage));
+	// Empties the PlanetSets, whose planets were freed with the pool.
+	warPlanets.clear();
+	ownedPlanets.clear();
+	climatePlanets.clear();
 
 	// Sets the number of HabitablePlanets to 0.
 	numHabitablePlanets = 0;
@@ -203,47 +155,10 @@ void initHabitablePlanets(int numHabitable) {
 }
 
 /*
-Places a habitable planet into habitablePages.
-
-Returns the int depositIndex of the planet in habitablePages cast to a HabitablePlanet.
-These ints will later be recast to SystemPlanetTiles in beginGenerateSystems.
+Places a habitable planet into habitablePool.
 */
 HabitablePlanet* placeHabitable(int size) {
-	static std::shared_mutex placeHabitableMutex;
-
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex> lock(placeHabitableMutex);
-
-	// Attempts to place the planet within one of the current pages.
-	HabitablePlanet* planet = nullptr;
-	for (int i = 0; i < numHabitablePages; ++i) {
-		if (habitablePages[i]->arrCurrPlanet < HABITABLE_PAGE_SIZE) {
-			planet = &(habitablePages[i]->planets[habitablePages[i]->arrCurrPlanet]);
-			++habitablePages[i]->arrCurrPlanet;
-			break;
-
-		}
-	}
-
-	// If placement failed, creates a new page and places the planet there.
-	// Will only place when all threads are at this function or returned.
-	if (planet == nullptr) {
-
-		// If the page table is not large enough, reallocates it.
-		if (!(numHabitablePages + 1 % NUM_HABITABLE_PAGES))
-			habitablePages = (HabitablePage**)realloc(habitablePages, (numHabitablePages + NUM_HABITABLE_PAGES) * sizeof(HabitablePage*));
-
-		// Creates a new HabitablePage.
-		habitablePages[numHabitablePages] = (HabitablePage*)calloc(1, sizeof(HabitablePage));
-			
-		// Places the planet in the first index of the new page.
-		planet = &habitablePages[numHabitablePages]->planets[0];
-		++habitablePages[numHabitablePages]->arrCurrPlanet;
-
-		// Moves on to the next page.
-		++numHabitablePages;
-		
-	}
+	HabitablePlanet* planet = habitablePool.allocate();
 
 	// Increments numHabitablePlanets.
 	++numHabitablePlanets;
@@ -257,82 +172,10 @@ HabitablePlanet* placeHabitable(int size) {
 }
 
 /*
-Requests a HabitablePage. Returns the index of the next available page in habitablePages, otherwise -1.
-TODO if infrastructure permits it, use a static global to increment through habitable pages.
-*/
-int requestHabitablePage() {
-	static std::shared_mutex requestHabitablePageMutex;
-
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex> lock(requestHabitablePageMutex);
-
-	// Parses through each galaxy and returns the next available one.
-	for (int i = 0; i < numHabitablePages; ++i) {
-		if (!habitablePages[i]->active) {
-			habitablePages[i]->active = true;
-			return i;
-
-		}
-	}
-
-	// Returns -1 if no HabitablePage was found.
-	return -1;
-
-}
-
-/*
-Returns a HabitablePage.
-*/
-void releaseHabitablePage(int index) {
-	habitablePages[index]->active = false;
-
-}
-
-// Returns all HabitablePage.
-void releaseAllHabitablePages() {
-	for (int i = 0; i < numHabitablePages; ++i) habitablePages[i]->active = false;
-
-}
-
-/*
-Finds the location of a given HabitablePlanet within the paging table.
-*/
-inline void findHabitableIndex(int& page, int& index, HabitablePlanet* planet) {
-
-	// Finds the page.
-	for (page = 0; page < numHabitablePages; ++page) {
-
-		// Returns the value if the HabitablePlanet is within bounds.
-		if ((char*)planet >= (char*)habitablePages[page] &&
-			(char*)planet < (char*)habitablePages[page] + sizeof(HabitablePage)) {
-			index = ((char*)planet - (char*)habitablePages[page]) / sizeof(HabitablePlanet);
-			return;
-
-		}
-	}
-}
-
-/*
-Initializes the barrenPlanets array.
+Initializes barrenPool.
 */
 void initBarrenPlanets(int numBarren) {
-
-	// Frees barrenPages for reuse.
-	if (numBarrenPages) {
-		for (int i = 0; i < numBarrenPages; ++i) {
-			if (barrenPages[i]) delete barrenPages[i];
-			barrenPages[i] = nullptr;
-
-		}
-		delete[] barrenPages;
-
-	}
-
-	// Initializes barrenPages.
-	numBarrenPages = numBarren / BARREN_PAGE_SIZE + 1;
-	barrenPages = (BarrenPage**)calloc(numBarrenPages + NUM_BARREN_PAGES - (numBarrenPages % NUM_BARREN_PAGES), sizeof(BarrenPage*));
-	for (int i = 0; i < numBarrenPages; ++i)
-		barrenPages[i] = (BarrenPage*)calloc(1, sizeof(BarrenPage));
+	barrenPool.init(numBarren);
 
 	// Sets the number of BarrenPlanets to 0.
 	numBarrenPlanets = 0;
@@ -340,44 +183,10 @@ void initBarrenPlanets(int numBarren) {
 }
 
 /*
-Places a barren planet into barrenPlanets.
+Places a barren planet into barrenPool.
 */
 BarrenPlanet* placeBarren() {
-	static std::shared_mutex placeBarrenMutex;
-
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex> lock(placeBarrenMutex);
-
-	// Attempts to place the planet within one of the current pages.
-	BarrenPlanet* planet = nullptr;
-	for (int i = 0; i < numBarrenPages; ++i) {
-		if (barrenPages[i]->arrCurrBarren < BARREN_PAGE_SIZE) {
-			planet = &(barrenPages[i]->planets[barrenPages[i]->arrCurrBarren]);
-			++(barrenPages[i]->arrCurrBarren);
-			break;
-
-		}
-	}
-
-	// If placement failed, creates a new page and places the planet there.
-	// Will only place when all threads are at this function or returned.
-	if (planet == nullptr) {
-
-		// If the page table is not large enough, reallocates it.
-		if (!(numBarrenPages + 1 % NUM_BARREN_PAGES))
-			barrenPages = (BarrenPage**)realloc(barrenPages, (numBarrenPages + NUM_BARREN_PAGES) * sizeof(BarrenPage*));
-
-		// Creates a new BarrenPage.
-		barrenPages[numBarrenPages] = (BarrenPage*)calloc(1, sizeof(BarrenPage));
-
-		// Places the planet in the first index of the new page.
-		planet = &(barrenPages[numBarrenPages]->planets[0]);
-		++barrenPages[numBarrenPages]->arrCurrBarren;
-
-		// Moves on to the next page.
-		++numBarrenPages;
-
-	}
+	BarrenPlanet* planet = barrenPool.allocate();
 
 	// Increments numBarrenPlanets.
 	++numBarrenPlanets;
@@ -387,10 +196,6 @@ BarrenPlanet* placeBarren() {
 
 }
 
-// Undefines constants which are used only for initializing planets.
-#undef NUM_HABITABLE_PAGES
-#undef NUM_BARREN_PAGES
-
 /*
 Generates a habitable from scratch, with no size parameter and no inputed array of PlanetTiles.
 
@@ -625,13 +430,13 @@ Earth's atmospheric composition http://www.ux1.eiu.edu/~cfjps/1400/atmos_origin.
 void randomizeAtmosphere(HabitablePlanet* planet) {
 	int totWeight = 0;
 
-	// Generates the gases.
-	planet->gases[Oxygen] = (rand() % 2000000000000000) * ((double)planet->size / 70); // Max 200% EarthO2.
-	planet->gases[Methane] = planet->gases[Oxygen] < 1000000000 ? (rand() % 2000000000000000) * ((double)planet->size / 70) :
-		rand() % (rand() % 2000000000000000) * ((double)planet->size / 70); // Max 40% || small% totEarth.
-	planet->gases[Null_Gases] = (rand() % 6000000000000000 + 4000000000000000) * ((double)planet->size / 70); // max 200% totEarth.
-	planet->gases[Pollutants] = (rand() % 100000000000000)* ((double)planet->size / 70); // max 2% totEarth.
-	planet->gases[Poisons] = (rand() % 1000000) * ((double)planet->size / 70); // max trivial.
+	// Generates the gases. randB(15) matches the range of MSVC's rand, which this was tuned with.
+	planet->gases[Oxygen] = (randB(15) % 2000000000000000) * ((double)planet->size / 70); // Max 200% EarthO2.
+	planet->gases[Methane] = planet->gases[Oxygen] < 1000000000 ? (randB(15) % 2000000000000000) * ((double)planet->size / 70) :
+		randB(15) % (randB(15) % 2000000000000000) * ((double)planet->size / 70); // Max 40% || small% totEarth.
+	planet->gases[Null_Gases] = (randB(15) % 6000000000000000 + 4000000000000000) * ((double)planet->size / 70); // max 200% totEarth.
+	planet->gases[Pollutants] = (randB(15) % 100000000000000)* ((double)planet->size / 70); // max 2% totEarth.
+	planet->gases[Poisons] = (randB(15) % 1000000) * ((double)planet->size / 70); // max trivial.
 
 	// Sums the weights of atmospheric gases and calculates the planet temperature.
 	// Pollutants have 5x the weight.
@@ -724,13 +529,16 @@ absolute value of the difference between 7 and the tile's heat.
 void generateMoisture(int size, int** dummyPlanet, int** moistureDummy, int** heatDummy, int** canvas) {
 	int xPos;
 	int yPos;
+	int padded;
 	int baseHeat;
 	int gValue;
 	LinkedListNode<PathCoordinate>* coord;
 	LinkedListNode<PathCoordinate>* currentCoord;
 
-	// Requests a coordList for this function.
-	LinkedList<PathCoordinate>* coordList = requestCoordList();
+	// Creates a coordList for this function from scratch space.
+	ScratchScope scratch;
+	CoordList coordList;
+	PlanetGrid* grid = planetGrid(size);
 
 	// Chooses a tile to generate moisture from.
 	for (int i = 0; i < size; ++i) {
@@ -748,7 +556,7 @@ void generateMoisture(int size, int** dummyPlanet, int** moistureDummy, int** he
 				LinkedList<PathCoordinate> frontier = LinkedList<PathCoordinate>();
 
 				// Creates the first coordinate.
-				coord = coordList->popc();
+				coord = coordList.popc();
 				coord->value->gValue = 1;
 				coord->value->coord = { i, j };
 				frontier.addc(coord);
@@ -772,46 +580,41 @@ void generateMoisture(int size, int** dummyPlanet, int** moistureDummy, int** he
 						moistureDummy[currentCoord->value->coord.x][currentCoord->value->coord.y] = gValue;
 
 					// Adds all surrounding coordinates to the frontier.
-					for (int x = -1; x < 2; ++x) {
-						for (int y = -1; y < 2; ++y) {
-
-							// Gets the coordinates for the new path coordinate.
-							xPos = currentCoord->value->coord.x + x;
-							yPos = currentCoord->value->coord.y + y;
-							wrapAroundPlanet(size, &xPos, &yPos);
+					padded = grid->pad(currentCoord->value->coord.x, currentCoord->value->coord.y);
+					for (int d = 0; d < PLANET_NEIGHBOURS + 1; ++d) {
 
-							// Creates a new PathCoordinate.
-							coord = coordList->popc();
-							coord->value->coord = {xPos, yPos};
+						// Gets the coordinates for the new path coordinate.
+						xPos = grid->cell(padded, grid->around[d]).x;
+						yPos = grid->cell(padded, grid->around[d]).y;
 
-							// gValue increment is chosen based on planet heat and Mountain presence.
-							if (dummyPlanet[xPos][yPos] > Mountain) gValue = 1;
-							else if (dummyPlanet[xPos][yPos] == Mountain) gValue = size / 4;
-							else gValue = abs(heatDummy[xPos][yPos] - 6) / 2 + 1;
-							coord->value->gValue = {currentCoord->value->gValue + gValue};
+						// Creates a new PathCoordinate.
+						coord = coordList.popc();
+						coord->value->coord = {xPos, yPos};
 
-							// Adds the new coordinate to the frontier if it has not already been explored.
-							if (canvas[xPos][yPos] && coord->value->gValue <= size) {
-								frontier.addc(coord);
-								canvas[coord->value->coord.x][coord->value->coord.y] = 0;
+						// gValue increment is chosen based on planet heat and Mountain presence.
+						if (dummyPlanet[xPos][yPos] > Mountain) gValue = 1;
+						else if (dummyPlanet[xPos][yPos] == Mountain) gValue = size / 4;
+						else gValue = abs(heatDummy[xPos][yPos] - 6) / 2 + 1;
+						coord->value->gValue = {currentCoord->value->gValue + gValue};
 
-							}
-							else coordList->addc(coord);
+						// Adds the new coordinate to the frontier if it has not already been explored.
+						if (canvas[xPos][yPos] && coord->value->gValue <= size) {
+							frontier.addc(coord);
+							canvas[coord->value->coord.x][coord->value->coord.y] = 0;
 
 						}
+						else coordList.addc(coord);
+
 					}
 
 					// Returns currentCoord's memory.
-					coordList->addc(currentCoord);
+					coordList.addc(currentCoord);
 
 				}
 			}
 		}
 	}
 
-	// Releases this thread's coordList.
-	releaseCoordList(coordList);
-
 }
 
 /*
@@ -819,7 +622,8 @@ Generates coastal tiles adjacent to land. Does so by changing all water tiles wi
 into coast.
 */
 void generateCoastline(int size, int** dummyPlanet) {
-	int xPos, yPos;
+	PlanetGrid* grid = planetGrid(size);
+	int padded;
 
 	// Parses through the planet looking for land tiles.
 	for (int i = 0; i < size; ++i) {
@@ -827,15 +631,13 @@ void generateCoastline(int size, int** dummyPlanet) {
 
 			// If a land tile is found, looks for adjacent water.
 			if (dummyPlanet[i][j] < Lake) {
-				for (int x = i - 1; x < i + 2; ++x) {
-					for (int y = j - 1; y < j + 2; ++y) {
-						xPos = x; yPos = y;
-						wrapAroundPlanet(size, &xPos, &yPos);
+				padded = grid->pad(i, j);
+				for (int d = 0; d < PLANET_NEIGHBOURS + 1; ++d) {
+					const PlanetCell& cell = grid->cell(padded, grid->around[d]);
 
-						// If adjacent water is found, reassigns it to coast.
-						if (dummyPlanet[xPos][yPos] > Lake) dummyPlanet[xPos][yPos] = Coast;
+					// If adjacent water is found, reassigns it to coast.
+					if (dummyPlanet[cell.x][cell.y] > Lake) dummyPlanet[cell.x][cell.y] = Coast;
 
-					}
 				}
 			}
 		}
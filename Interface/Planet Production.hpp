@@ -1,29 +1,26 @@
 #pragma once
 
+// Number of ownedPlanets given to each buildingProduction task.
+#define PRODUCTION_GRAIN 32
+
 /*
-Manages production for a page of planets.
+Manages production for a range of the ownedPlanets.
 */
-void buildingProduction() {
-	int page = requestHabitablePage();
-
-	// Returns if there is no available page.
-	if (page < 0) return;
-
-	// Performs planetary production for all HabitablePlanets on a page.
-	for (int i = 0; i < habitablePages[page]->arrCurrPlanet; ++i) {
-		habitablePages[page]->planets[i].ownersProduction();
+void buildingProduction(int beg, int end) {
 
-	}
-
-	// Continues until there are no remaining HabitablePages.
-	buildingProduction();
+	// Performs planetary production for each HabitablePlanet in the range.
+	for (int i = beg; i < end; ++i) ownedPlanets.planets[i]->ownersProduction();
 
 }
 
 /*
 Manages production of resources for each planet. This is mostly copied from Climate Change.
+Only the ownedPlanets are visited, in runs of PRODUCTION_GRAIN, since unowned planets produce nothing.
 */
 void planetProduction() {
-	buildingProduction();
+	ProfileScope scope(PRODUCTION_ZONE);
+	parallelFor(0, ownedPlanets.numPlanets, PRODUCTION_GRAIN, [](int beg, int end) {
+		buildingProduction(beg, end);
 
-}
\ No newline at end of file
+	});
+}
@@ -0,0 +1,391 @@
+#pragma once
+
+// Tells the compiler about the scheduler's thread indices.
+extern thread_local int workerIndex;
+
+// Tells the compiler about the number of threads.
+extern int numThreads;
+
+// Number of ProfileEvents held by each thread's ProfileRing. Must be a power of two.
+#define PROFILE_RING_SIZE 4096
+
+// Maximum number of threads which may record ProfileEvents.
+#define MAX_PROFILE_RINGS 256
+
+// Number of turns whose TurnProfiles are kept for querying.
+#define PROFILE_HISTORY 128
+
+// Number of buckets in each histogram. Bucket b counts turns which took less than 2^b microseconds
+// (and at least 2^(b - 1)). The last bucket also counts anything longer.
+#define PROFILE_HISTOGRAM_BUCKETS 24
+
+/*
+Zones of a turn which are timed. TURN_ZONE covers an entire turn. CLEANUP_ZONE covers the
+end of turn bookkeeping, such as freeing scratch space.
+*/
+enum ProfileZone {
+	TURN_ZONE,
+	CLIMATE_ZONE,
+	PRODUCTION_ZONE,
+	GOVERNMENT_ZONE,
+	SPACE_BATTLE_ZONE,
+	SPACE_THREATS_ZONE,
+	MANAGE_CLOSURES_ZONE,
+	GROUND_BATTLES_ZONE,
+	CLEANUP_ZONE,
+	NUM_PROFILE_ZONES
+
+};
+
+// Names of each ProfileZone.
+const char* profileZoneNames[NUM_PROFILE_ZONES] = {"turn", "climate", "production", "government", "spaceBattle",
+	"spaceThreats", "manageClosures", "groundBattles", "cleanup"};
+
+/*
+Types of ProfileEvent.
+WALL_EVENTs are recorded by ProfileScopes, and span an entire zone on the submitting thread.
+WORK_EVENTs are recorded by worker threads for each Task, excluding time spent idle within it.
+IDLE_EVENTs are recorded by TaskGroup::wait, and contain only the time spent without a Task to execute.
+*/
+enum ProfileEventType {
+	WALL_EVENT,
+	WORK_EVENT,
+	IDLE_EVENT
+
+};
+
+/*
+A single timed event. Times are steady_clock nanoseconds.
+*/
+struct ProfileEvent {
+	long long start;
+	long long duration;
+	uint_least8_t zone;
+	uint_least8_t type;
+
+};
+
+/*
+Ring buffer of ProfileEvents belonging to a single thread. Only the owning thread writes
+to it, and only collectProfile reads from it. If more than PROFILE_RING_SIZE events are
+recorded between collections, the oldest are lost.
+*/
+struct ProfileRing {
+	ProfileEvent events[PROFILE_RING_SIZE];
+	std::atomic<unsigned int> head;
+	unsigned int tail;
+	bool worker;
+
+};
+
+// Every registered ProfileRing.
+ProfileRing* profileRings[MAX_PROFILE_RINGS];
+std::atomic<int> numProfileRings(0);
+
+// ProfileRing of the calling thread. Created upon recording the thread's first event.
+thread_local ProfileRing* profileRing = nullptr;
+
+// Zone that the calling thread is currently working on. Tasks inherit the zone of the thread that ran them.
+thread_local int profileZone = TURN_ZONE;
+
+// Depth of nested Tasks being executed by the calling thread.
+thread_local int profileTaskDepth = 0;
+
+// Total time the calling thread has spent idle in TaskGroup::wait.
+thread_local long long profileIdle = 0;
+
+/*
+Timings for a single turn, or the sum of many turns. For each zone, wall is the time from the
+zone's start to its end, work is the time spent by all threads executing it, and idle is the
+time spent by all threads waiting on barriers within it. Time not accounted for by work and idle
+(out of wall * threads) was spent by workers with nothing queued.
+*/
+struct TurnProfile {
+	int turn;
+	int threads;
+	long long wall[NUM_PROFILE_ZONES];
+	long long work[NUM_PROFILE_ZONES];
+	long long idle[NUM_PROFILE_ZONES];
+
+};
+
+// TurnProfiles of the last PROFILE_HISTORY turns. numTurnProfiles counts every collected turn.
+TurnProfile turnProfiles[PROFILE_HISTORY];
+int numTurnProfiles;
+
+// Sum of every collected TurnProfile.
+TurnProfile profileTotals;
+
+// Histograms of each zone's wall time, one entry per turn the zone was performed.
+int profileHistograms[NUM_PROFILE_ZONES][PROFILE_HISTOGRAM_BUCKETS];
+
+// Guards the above collected profile data, which is read by the interface.
+std::mutex profileMutex;
+
+/*
+Returns the current time in steady_clock nanoseconds.
+*/
+inline long long profileNow() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+}
+
+/*
+Records an event in the calling thread's ProfileRing, creating and registering the ring if needed.
+Events are dropped if MAX_PROFILE_RINGS threads have already registered.
+*/
+inline void recordProfileEvent(int zone, int type, long long start, long long duration) {
+	unsigned int head;
+
+	// Registers a ProfileRing for this thread.
+	if (profileRing == nullptr) {
+		profileRing = new ProfileRing();
+		profileRing->worker = workerIndex != 0;
+		int index = numProfileRings.fetch_add(1);
+		if (index < MAX_PROFILE_RINGS) profileRings[index] = profileRing;
+
+	}
+
+	// Writes the event, then publishes it.
+	head = profileRing->head.load(std::memory_order_relaxed);
+	profileRing->events[head & (PROFILE_RING_SIZE - 1)] = {start, duration, (uint_least8_t)zone, (uint_least8_t)type};
+	profileRing->head.store(head + 1, std::memory_order_release);
+
+}
+
+/*
+Times a zone from construction to destruction. Tasks run within the scope are attributed to the zone.
+*/
+class ProfileScope {
+public:
+
+	// Begins timing the zone.
+	ProfileScope(int zone) : zone(zone), previousZone(profileZone), start(profileNow()) { profileZone = zone; }
+
+	// Records the zone's wall time.
+	~ProfileScope() {
+		recordProfileEvent(zone, WALL_EVENT, start, profileNow() - start);
+		profileZone = previousZone;
+
+	}
+
+private:
+	int zone;
+	int previousZone;
+	long long start;
+
+};
+
+/*
+Times a Task from construction to destruction. Only the outermost Task on a worker thread is
+recorded, since Tasks executed while it waits are part of its time. Time spent idle within the
+Task is excluded. Tasks executed by the submitting thread are covered by its ProfileScope.
+*/
+class ProfileTask {
+public:
+
+	// Begins timing the Task and attributes the calling thread's work to its zone.
+	ProfileTask(int zone) : zone(zone), previousZone(profileZone), timed(workerIndex && !profileTaskDepth) {
+		if (timed) {
+			start = profileNow();
+			idle = profileIdle;
+
+		}
+		profileZone = zone;
+		++profileTaskDepth;
+
+	}
+
+	// Records the Task's work time.
+	~ProfileTask() {
+		--profileTaskDepth;
+		profileZone = previousZone;
+		if (timed) recordProfileEvent(zone, WORK_EVENT, start, profileNow() - start - (profileIdle - idle));
+
+	}
+
+private:
+	int zone;
+	int previousZone;
+	bool timed;
+	long long start;
+	long long idle;
+
+};
+
+/*
+Accumulates the idle time of a single TaskGroup::wait. idling is called whenever no Task
+could be found, and working whenever one is found. Records an IDLE_EVENT upon destruction.
+*/
+class ProfileWait {
+public:
+
+	// Begins a wait.
+	ProfileWait() : start(profileNow()), idleStart(0), idle(0) { }
+
+	// Marks the thread as idle if it is not already.
+	inline void idling() { if (!idleStart) idleStart = profileNow(); }
+
+	// Marks the thread as working, ending any idle period.
+	inline void working() {
+		if (idleStart) {
+			idle += profileNow() - idleStart;
+			idleStart = 0;
+
+		}
+	}
+
+	// Records the wait's idle time.
+	~ProfileWait() {
+		working();
+		if (idle) {
+			profileIdle += idle;
+			recordProfileEvent(profileZone, IDLE_EVENT, start, idle);
+
+		}
+	}
+
+private:
+	long long start;
+	long long idleStart;
+	long long idle;
+
+};
+
+/*
+Returns the histogram bucket for a duration in nanoseconds.
+*/
+inline int profileBucket(long long duration) {
+	int bucket = 0;
+	for (long long us = duration / 1000; us && bucket < PROFILE_HISTOGRAM_BUCKETS - 1; us >>= 1) ++bucket;
+	return bucket;
+
+}
+
+/*
+Drains every ProfileRing into a TurnProfile for the inputed turn, then adds it to the history,
+totals and histograms. Must be called by the thread that runs turns, once no Tasks are running.
+The time spent draining is counted in the turn's CLEANUP_ZONE, though it falls outside TURN_ZONE.
+*/
+void collectProfile(int turn) {
+	TurnProfile profile = {};
+	ProfileRing* ring;
+	ProfileEvent* event;
+	unsigned int head;
+	long long start = profileNow();
+	int rings = numProfileRings.load() < MAX_PROFILE_RINGS ? numProfileRings.load() : MAX_PROFILE_RINGS;
+
+	// Reads every event recorded since the last collection.
+	profile.turn = turn;
+	profile.threads = numThreads;
+	for (int r = 0; r < rings; ++r) {
+		ring = profileRings[r];
+		if (ring == nullptr) continue;
+		head = ring->head.load(std::memory_order_acquire);
+		if (head - ring->tail > PROFILE_RING_SIZE) ring->tail = head - PROFILE_RING_SIZE;
+		for (; ring->tail != head; ++ring->tail) {
+			event = &ring->events[ring->tail & (PROFILE_RING_SIZE - 1)];
+			switch (event->type) {
+
+			// A submitting thread works for the whole zone, except when idle.
+			case WALL_EVENT:
+				profile.wall[event->zone] += event->duration;
+				if (!ring->worker) profile.work[event->zone] += event->duration;
+				break;
+
+			case WORK_EVENT:
+				profile.work[event->zone] += event->duration;
+				break;
+
+			case IDLE_EVENT:
+				profile.idle[event->zone] += event->duration;
+				if (!ring->worker) profile.work[event->zone] -= event->duration;
+				break;
+
+			}
+		}
+	}
+
+	// Counts the draining as cleanup.
+	start = profileNow() - start;
+	profile.wall[CLEANUP_ZONE] += start;
+	profile.work[CLEANUP_ZONE] += start;
+
+	// The turn's work and idle are those of every zone within it.
+	profile.work[TURN_ZONE] = 0;
+	for (int z = TURN_ZONE + 1; z < NUM_PROFILE_ZONES; ++z) {
+		profile.work[TURN_ZONE] += profile.work[z];
+		profile.idle[TURN_ZONE] += profile.idle[z];
+
+	}
+
+	// Stores the TurnProfile.
+	const std::lock_guard<std::mutex> lock(profileMutex);
+	turnProfiles[numTurnProfiles++ % PROFILE_HISTORY] = profile;
+	profileTotals.turn = turn;
+	profileTotals.threads = numThreads;
+	for (int z = 0; z < NUM_PROFILE_ZONES; ++z) {
+		profileTotals.wall[z] += profile.wall[z];
+		profileTotals.work[z] += profile.work[z];
+		profileTotals.idle[z] += profile.idle[z];
+		if (profile.wall[z]) ++profileHistograms[z][profileBucket(profile.wall[z])];
+
+	}
+}
+
+/*
+Clears every collected TurnProfile and histogram, and discards events not yet collected.
+Must be called while no Tasks are running.
+*/
+void resetProfile() {
+	int rings = numProfileRings.load() < MAX_PROFILE_RINGS ? numProfileRings.load() : MAX_PROFILE_RINGS;
+
+	// Discards uncollected events, i.e. those recorded during generation.
+	for (int r = 0; r < rings; ++r)
+		if (profileRings[r] != nullptr) profileRings[r]->tail = profileRings[r]->head.load(std::memory_order_acquire);
+
+	// Clears the collected data.
+	const std::lock_guard<std::mutex> lock(profileMutex);
+	numTurnProfiles = 0;
+	profileTotals = {};
+	memset(profileHistograms, 0, sizeof(profileHistograms));
+
+}
+
+/*
+Copies the TurnProfile from turnsAgo turns ago (0 being the latest) into profile.
+Returns false if that turn is no longer (or not yet) available.
+*/
+bool getTurnProfile(int turnsAgo, TurnProfile* profile) {
+	const std::lock_guard<std::mutex> lock(profileMutex);
+	if (turnsAgo < 0 || turnsAgo >= PROFILE_HISTORY || turnsAgo >= numTurnProfiles) return false;
+	*profile = turnProfiles[(numTurnProfiles - 1 - turnsAgo) % PROFILE_HISTORY];
+	return true;
+
+}
+
+/*
+Copies the sum of every collected TurnProfile into profile. Returns the number of turns collected.
+*/
+int getProfileTotals(TurnProfile* profile) {
+	const std::lock_guard<std::mutex> lock(profileMutex);
+	*profile = profileTotals;
+	return numTurnProfiles;
+
+}
+
+/*
+Copies the histogram of a zone's wall times into histogram, which must hold PROFILE_HISTOGRAM_BUCKETS
+ints. Returns the number of turns in which the zone was performed.
+*/
+int getProfileHistogram(int zone, int* histogram) {
+	int count = 0;
+	const std::lock_guard<std::mutex> lock(profileMutex);
+	for (int b = 0; b < PROFILE_HISTOGRAM_BUCKETS; ++b) {
+		histogram[b] = profileHistograms[zone][b];
+		count += histogram[b];
+
+	}
+	return count;
+
+}
@@ -12,6 +12,15 @@ void resizeReportView(int windowW, int windowH);
 // Renders the Report View.
 void renderReportView();
 
+// Renders a line of text within the Report View.
+void renderReportText(const std::string& text, int x, int y);
+
+// Number of recent turns averaged by the Report View.
+#define REPORT_AVERAGE_TURNS 32
+
+// Height of each row of the Report View, in pixels.
+#define REPORT_ROW_HEIGHT 16
+
 /*
 Initializes the Report View.
 */
@@ -52,9 +61,19 @@ void resizeReportView(int windowW, int windowH) {
 }
 
 /*
-Renders the Report View.
+Renders the Report View. Shows where recent turns were spent: for each phase, its mean wall time
+and a bar splitting the time of every thread into work (green), barrier idle (red) and time
+spent with nothing queued (grey). Below is a histogram of turn times.
 */
 void renderReportView() {
+	TurnProfile profile;
+	TurnProfile mean = {};
+	int histogram[PROFILE_HISTOGRAM_BUCKETS];
+	int numTurns = 0;
+	int maxCount = 1;
+	int barWidth = reportViewport.w - 16;
+	int y = 4;
+	SDL_Rect bar;
 
 	// TEMP : Sets the colour to white.
 	SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
@@ -62,6 +81,86 @@ void renderReportView() {
 	// TEMP: Renders the reportViewport's background.
 	SDL_RenderFillRect(renderer, &reportViewport);
 
-	// TODO add items.
+	// Sets the viewport to the reportViewport.
+	SDL_RenderSetViewport(renderer, &reportViewport);
+
+	// Sums the most recent TurnProfiles.
+	while (numTurns < REPORT_AVERAGE_TURNS && getTurnProfile(numTurns, &profile)) {
+		for (int z = 0; z < NUM_PROFILE_ZONES; ++z) {
+			mean.wall[z] += profile.wall[z];
+			mean.work[z] += profile.work[z];
+			mean.idle[z] += profile.idle[z];
+
+		}
+		mean.threads = profile.threads;
+		++numTurns;
+
+	}
+
+	// Renders the title.
+	renderReportText("Mean of last " + std::to_string(numTurns) + " turns (" + std::to_string(mean.threads) + " threads)", 8, y);
+	y += REPORT_ROW_HEIGHT + 4;
+
+	// Renders each zone's mean wall time and its split between work and idle.
+	for (int z = 0; numTurns && z < NUM_PROFILE_ZONES; ++z) {
+		long long capacity = mean.wall[z] * mean.threads;
+		char line[64];
+		snprintf(line, sizeof(line), "%-16s %9.3f ms", profileZoneNames[z], mean.wall[z] / 1000000.0 / numTurns);
+		renderReportText(line, 8, y);
+		y += REPORT_ROW_HEIGHT;
+
+		// Renders the bar's background as time spent with nothing queued.
+		bar = {8, y, barWidth, REPORT_ROW_HEIGHT / 2};
+		SDL_SetRenderDrawColor(renderer, 160, 160, 160, 255);
+		SDL_RenderFillRect(renderer, &bar);
+
+		// Renders work, then barrier idle time.
+		if (capacity > 0) {
+			bar.w = (int)(barWidth * (mean.work[z] > 0 ? mean.work[z] : 0) / capacity);
+			if (bar.w > barWidth) bar.w = barWidth;
+			SDL_SetRenderDrawColor(renderer, 40, 170, 40, 255);
+			SDL_RenderFillRect(renderer, &bar);
+			bar.x += bar.w;
+			bar.w = (int)(barWidth * mean.idle[z] / capacity);
+			if (bar.x + bar.w > 8 + barWidth) bar.w = 8 + barWidth - bar.x;
+			SDL_SetRenderDrawColor(renderer, 200, 40, 40, 255);
+			SDL_RenderFillRect(renderer, &bar);
+
+		}
+		y += REPORT_ROW_HEIGHT;
+
+	}
+
+	// Renders the histogram of turn times. Bucket b holds turns of less than 2^b microseconds.
+	getProfileHistogram(TURN_ZONE, histogram);
+	for (int b = 0; b < PROFILE_HISTOGRAM_BUCKETS; ++b) if (histogram[b] > maxCount) maxCount = histogram[b];
+	y += 4;
+	renderReportText("Turn time histogram (log2 us)", 8, y);
+	y += REPORT_ROW_HEIGHT;
+	SDL_SetRenderDrawColor(renderer, 60, 60, 200, 255);
+	for (int b = 0; b < PROFILE_HISTOGRAM_BUCKETS; ++b) {
+		bar.w = barWidth / PROFILE_HISTOGRAM_BUCKETS - 1;
+		bar.h = 64 * histogram[b] / maxCount;
+		bar.x = 8 + b * (bar.w + 1);
+		bar.y = y + 64 - bar.h;
+		SDL_RenderFillRect(renderer, &bar);
+
+	}
+
+	// Sets the viewport to window.
+	SDL_RenderSetViewport(renderer, NULL);
+
+}
+
+/*
+Renders a line of text at the inputed position within the Report View.
+*/
+void renderReportText(const std::string& text, int x, int y) {
+	SDL_Surface* surface = TTF_RenderText_Blended(defaultFont, text.c_str(), { 0, 0, 0, 0xFF });
+	SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+	SDL_Rect area = {x, y, surface->w, surface->h};
+	SDL_RenderCopy(renderer, texture, NULL, &area);
+	SDL_DestroyTexture(texture);
+	SDL_FreeSurface(surface);
 
 }
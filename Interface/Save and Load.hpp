@@ -30,6 +30,10 @@ void saveRivers(std::ofstream* saveFile);
 // Saves the Deposits of each planet.
 void saveDeposits(std::ofstream* saveFile);
 
+// Saves the metadata of each page of a PagedPool.
+template<class T, int PAGE_BYTES>
+void savePoolPages(std::string& data, PagedPool<T, PAGE_BYTES>* pool);
+
 // Saves all RaceTemplates.
 void saveRaces(std::ofstream* saveFile);
 
@@ -81,6 +85,10 @@ void loadRivers(std::ifstream* saveFile);
 // Loads the Deposits of each planet.
 void loadDeposits(std::ifstream* saveFile);
 
+// Loads the metadata of each page of a PagedPool.
+template<class T, int PAGE_BYTES>
+void loadPoolPages(std::ifstream* saveFile, PagedPool<T, PAGE_BYTES>* pool, int numPages);
+
 // Loads all RaceTemplates.
 void loadRaces(std::ifstream* saveFile);
 
@@ -183,11 +191,11 @@ void saveFile(std::string fileName) {
 
 /*
 Saves metadata for the game.
-Saved in the form {dummySize:largeDummySize}
+Saved in the form {scratchSize}
 */
 void saveMetaData(std::ofstream* saveFile) {
 	std::string meta;
-	int dummySize;
+	int scratchSize = (int)scratchReserve;
 
 	// Places an extra newline for confirmToken.
 	meta += '\n';
@@ -195,11 +203,8 @@ void saveMetaData(std::ofstream* saveFile) {
 	// Starts with the designation meta.
 	meta += "meta\n";
 
-	// Saves dummySize.
-	meta.append((char*)((int*)threadDummies - 1), sizeof(int));
-
-	// Saves largeDummySize.
-	meta.append((char*)((int*)threadLargeDummies - 1), sizeof(int));
+	// Saves scratchSize.
+	meta.append((char*)&scratchSize, sizeof(scratchSize));
 
 	// Closes with a newline.
 	meta += '\n';
@@ -211,25 +216,28 @@ void saveMetaData(std::ofstream* saveFile) {
 
 /*
 Saves the tiles of a given universe to the saveFile.
-Saved in the form {tileID}.
+Saved in the form {universeWidth:universeHeight:sparse:numBlocks}, then {chunk:tileIDs[]} for
+each chunk with its own block. Other chunks are thin space.
 */
 void saveUniverseTiles(std::ofstream* saveFile) {
 	std::string tiles;
+	uint_least8_t sparse = universe.sparse;
 
 	// Starts with the designation utiles.
 	tiles += "utiles\n";
 
-	// Saves universeWidth and universeHeight.
+	// Saves universeWidth, universeHeight, and how the universe is stored.
 	tiles.append((char*)&universeWidth, sizeof(universeWidth));
 	tiles.append((char*)&universeHeight, sizeof(universeHeight));
+	tiles.append((char*)&sparse, sizeof(sparse));
+	tiles.append((char*)&universe.numBlocks, sizeof(universe.numBlocks));
 	tiles += '\n';
 
-	// Parses through the universe and places every tile in the file.
-	for (int i = 0; i < universeWidth; ++i) {
-
-		// Saves each row of tiles.
-		for (int j = 0; j < universeHeight; ++j)
-			tiles.append((char*)&uIndex(i, j).tileID, sizeof(uIndex(i, j).tileID));
+	// Saves the tiles of every chunk which has its own block.
+	for (int c = 0; c < universe.chunksWide * universe.chunksHigh; ++c) {
+		if (!universe.owned(c)) continue;
+		tiles.append((char*)&c, sizeof(c));
+		tiles.append((char*)universe.blocks[c].load()->tileIDs, sizeof(UniverseBlock::tileIDs));
 
 		// If tiles is large, empties it.
 		if (tiles.length() > 3600) {
@@ -263,7 +271,7 @@ void saveSystemTiles(std::ofstream* saveFile) {
 		for (int j = 0; j < universeHeight; ++j) {
 
 			// Saves a system's metadata.
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				tile = uSystem(i, j);
 
 				// Saves numStars, numHabitable, and numBarren.
@@ -303,7 +311,7 @@ void saveStars(std::ofstream* saveFile) {
 	// Saves the metadata of each star to the saveFile.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				tile = uSystem(i, j);
 
 				// Saves the metadata of each star to the saveFile.
@@ -347,7 +355,7 @@ void savePlanets(std::ofstream* saveFile) {
 	// Saves the metadata of each planet to the saveFile.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				tile = uSystem(i, j);
 
 				// Saves the metadata of each planet.
@@ -390,7 +398,7 @@ void saveBarrens(std::ofstream* saveFile) {
 	// Saves the metadata of each barren to the saveFile.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				tile = uSystem(i, j);
 
 				// Saves the metadata of each planet.
@@ -431,7 +439,7 @@ void savePlanetTiles(std::ofstream* saveFile) {
 	// Saves the planetTiles of each planet to the saveFile.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				tile = uSystem(i, j);
 
 				// Saves the tiles of each planet.
@@ -481,7 +489,7 @@ void saveRivers(std::ofstream* saveFile) {
 	// Saves the rivers of each planet in the universe.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				for (int plan = 0; plan < uSystem(i, j)->numHabitable; ++plan) {
 					currHabitable = uSystem(i, j)->planets[plan];
 
@@ -538,7 +546,7 @@ void saveDeposits(std::ofstream* saveFile) {
 	// Saves the deposits of each planet in the universe.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				for (int plan = 0; plan < uSystem(i, j)->numHabitable; ++plan) {
 					currHabitable = uSystem(i, j)->planets[plan];
 
@@ -574,32 +582,53 @@ void saveDeposits(std::ofstream* saveFile) {
 
 }
 
+/*
+Saves the metadata of each page of a PagedPool. Only live items are saved, so the live bits
+of each page are needed to place items at the same indices when loading.
+
+Saved in the form {Metadata1:Metadata2:...}
+	Metadata {highWater:live[]}
+*/
+template<class T, int PAGE_BYTES>
+void savePoolPages(std::string& data, PagedPool<T, PAGE_BYTES>* pool) {
+	uint_least64_t live;
+
+	// Saves the highWater and live bits of each page. Bits past highWater are not saved.
+	for (int page = 0; page < pool->numPages; ++page) {
+		data.append((char*)&pool->pages[page]->highWater, sizeof(int));
+		for (int word = 0; word * 64 < pool->pages[page]->highWater; ++word) {
+			live = pool->pages[page]->live[word].load(std::memory_order_relaxed);
+			data.append((char*)&live, sizeof(live));
+
+		}
+	}
+}
+
 /*
 Saves all RaceTemplates.
-Saved in the form {numRacePages:{Metadata1:Metadata2:...}:{RaceTemplate1:RaceTemplate2:...}}
-	Metadata {arrCurrRace}
+Saved in the form {numPages:{Metadata1:Metadata2:...}:{RaceTemplate1:RaceTemplate2:...}}
+	Metadata {highWater:live[]}
 	RaceTemplate {parentIndex:name[]:consumedGases[]:producedGases[]:consumed[]:productivities[]}
 */
 void saveRaces(std::ofstream* saveFile) {
 	std::string races;
 	RaceTemplate* race;
-	int a, b;
 	int index;
 
 	// Starts with the designation races.
 	races += "races\n";
 
-	// Saves the total number of RacePages.
-	races.append((char*)&numRacePages, sizeof(numRacePages));
+	// Saves the total number of pages in racePool.
+	races.append((char*)&racePool.numPages, sizeof(racePool.numPages));
 
-	// Saves the metadata of each RacePage.
-	for (int i = 0; i < numRacePages; ++i)
-		races.append((char*)&racePages[i]->arrCurrRace, sizeof(racePages[i]->arrCurrRace));
+	// Saves the metadata of each page.
+	savePoolPages(races, &racePool);
 
 	// Saves each RaceTemplate.
-	for (int i = 0; i < numRacePages; ++i) {
-		for (int j = 0; j < racePages[i]->arrCurrRace; ++j) {
-			race = &racePages[i]->races[j];
+	for (int i = 0; i < racePool.numPages; ++i) {
+		for (int j = 0; j < racePool.pages[i]->highWater; ++j) {
+			if (!racePool.isLive(i * racePool.PAGE_SIZE + j)) continue;
+			race = &racePool.pages[i]->items()[j];
 
 			// If the RaceTemplate has no parent, stores parent as -1.
 			if (race->parent == nullptr) {
@@ -609,8 +638,7 @@ void saveRaces(std::ofstream* saveFile) {
 			}
 			// If the RaceTemplate has a parent, stores its index.
 			else {
-				findRaceIndex(a, b, race->parent);
-				index = a * RACE_PAGE_SIZE + b;
+				index = racePool.indexOf(race->parent);
 				races.append((char*)&index, sizeof(index));
 
 			}
@@ -650,8 +678,8 @@ void saveRaces(std::ofstream* saveFile) {
 /*
 Saves all Markets.
 
-Saved in the form {numMarketPages:{Metadata1:Metadata2:...}:{Market1:Market2:...}}
-	Metadata {arrCurrMarket}
+Saved in the form {numPages:{Metadata1:Metadata2:...}:{Market1:Market2:...}}
+	Metadata {highWater:live[]}
 	Market {goods[]:numFoods:foods[]}
 
 Note that marketCapital is saved with Colonies.
@@ -663,19 +691,17 @@ void saveMarkets(std::ofstream* saveFile) {
 	// Starts with the designation markets.
 	markets += "markets\n";
 
-	// Saves the total number of MarketPages.
-	markets.append((char*)&numMarketPages, sizeof(numMarketPages));
-
-	// Saves the metadata of each MarketPage.
-	for (int i = 0; i < numMarketPages; ++i) {
-		markets.append((char*)&marketPages[i]->arrCurrMarket, sizeof(marketPages[i]->arrCurrMarket));
+	// Saves the total number of pages in marketPool.
+	markets.append((char*)&marketPool.numPages, sizeof(marketPool.numPages));
 
-	}
+	// Saves the metadata of each page.
+	savePoolPages(markets, &marketPool);
 
 	// Saves each Market.
-	for (int i = 0; i < numMarketPages; ++i) {
-		for (int j = 0; j < marketPages[i]->arrCurrMarket; ++j) {
-			market = &marketPages[i]->markets[j];
+	for (int i = 0; i < marketPool.numPages; ++i) {
+		for (int j = 0; j < marketPool.pages[i]->highWater; ++j) {
+			if (!marketPool.isLive(i * marketPool.PAGE_SIZE + j)) continue;
+			market = &marketPool.pages[i]->items()[j];
 
 			// Saves Goods.
 			markets.append((char*)&market->goods, sizeof(market->goods));
@@ -707,15 +733,13 @@ void saveMarkets(std::ofstream* saveFile) {
 /*
 Saves a RaceInstance. Helper function for saveColonies.
 
-Saved in the form {raceIndex:numPops:numUnemployed}
+Saved in the form {raceIndex:numPops:numUnemployed}. Orcs are not pooled and are saved as -1.
 */
 inline void saveRaceInstance(std::string& races, RaceInstance* race) {
-	int a, b;
 	int index;
 
 	// Saves the RaceInstance's RaceTemplate.
-	findRaceIndex(a, b, race->race);
-	index = a * RACE_PAGE_SIZE + b;
+	index = race->race == getOrcs() ? -1 : racePool.indexOf(race->race);
 	races.append((char*)&index, sizeof(index));
 
 	// Saves numPops.
@@ -729,8 +753,8 @@ inline void saveRaceInstance(std::string& races, RaceInstance* race) {
 /*
 Saves all Colonies.
 
-Saved in the form {numColonyPages:{Metadata1:Metadata2:...}:{Colony1:Colony2:...}}
-	Metadata {arrCurrColony}
+Saved in the form {numPages:{Metadata1:Metadata2:...}:{Colony1:Colony2:...}}
+	Metadata {highWater:live[]}
 	Colony {planetIndex:marketCapital:marketIndex:numRaces:races[]:governmentOwner}
 
 Note that Government is saved with Governments.
@@ -739,29 +763,25 @@ void saveColonies(std::ofstream* saveFile) {
 	std::string colonies;
 	Colony* colony;
 	int index;
-	int a, b;
 	uint_least8_t capital;
 
 	// Starts with the designation colonies.
 	colonies += "colonies\n";
 
-	// Saves the total number of ColonyPages.
-	colonies.append((char*)&numColonyPages, sizeof(numColonyPages));
+	// Saves the total number of pages in colonyPool.
+	colonies.append((char*)&colonyPool.numPages, sizeof(colonyPool.numPages));
 
-	// Saves the metadata of each ColonyPage.
-	for (int i = 0; i < numColonyPages; ++i) {
-		colonies.append((char*)&colonyPages[i]->arrCurrColony, sizeof(colonyPages[i]->arrCurrColony));
-
-	}
+	// Saves the metadata of each page.
+	savePoolPages(colonies, &colonyPool);
 
 	// Saves each colony.
-	for (int i = 0; i < numColonyPages; ++i) {
-		for (int j = 0; j < colonyPages[i]->arrCurrColony; ++j) {
-			colony = &colonyPages[i]->colonies[j];
+	for (int i = 0; i < colonyPool.numPages; ++i) {
+		for (int j = 0; j < colonyPool.pages[i]->highWater; ++j) {
+			if (!colonyPool.isLive(i * colonyPool.PAGE_SIZE + j)) continue;
+			colony = &colonyPool.pages[i]->items()[j];
 
 			// Saves the Colony's HabitablePlanet.
-			findHabitableIndex(a, b, colony->planet);
-			index = a * HABITABLE_PAGE_SIZE + b;
+			index = habitablePool.indexOf(colony->planet);
 			colonies.append((char*)&index, sizeof(index));
 
 			// Marks whether this Colony is the marketCapital of its Market.
@@ -769,8 +789,7 @@ void saveColonies(std::ofstream* saveFile) {
 			colonies.append((char*)&capital, sizeof(capital));
 
 			// Saves the Colony's Market.
-			findMarketIndex(a, b, colony->market);
-			index = a * MARKET_PAGE_SIZE + b;
+			index = marketPool.indexOf(colony->market);
 			colonies.append((char*)&index, sizeof(index));
 
 			// Saves the Colony's number of RaceTemplates.
@@ -802,8 +821,8 @@ void saveColonies(std::ofstream* saveFile) {
 /*
 Saves all governments.
 
-Saved in the form {numGovernmentPages:{Metadata1:Metadata2:...}:{Government1:Government2:...}}
-	Metadata {arrCurrGovernment}
+Saved in the form {numPages:{Metadata1:Metadata2:...}:{Government1:Government2:...}}
+	Metadata {highWater:live[]}
 	Government {behaviours[]:parentIndex:numColonies:colonies[]:units[]:flagColour}
 
 TODO if unitTable is associated with parent that should be marked somehow.
@@ -813,24 +832,22 @@ void saveGovernments(std::ofstream* saveFile) {
 	Government* government;
 	int index;
 	uint_least8_t behaviour;
-	int a, b;
+	int a;
 
 	// Starts with the designation governments.
 	governments += "governments\n";
 
-	// Saves the total number of GovernmentPages.
-	governments.append((char*)&numGovernmentPages, sizeof(numGovernmentPages));
-
-	// Saves the metadata of each GovernmentPage.
-	for (int i = 0; i < numGovernmentPages; ++i) {
-		governments.append((char*)&governmentPages[i]->arrCurrGovernment, sizeof(governmentPages[i]->arrCurrGovernment));
+	// Saves the total number of pages in governmentPool.
+	governments.append((char*)&governmentPool.numPages, sizeof(governmentPool.numPages));
 
-	}
+	// Saves the metadata of each page.
+	savePoolPages(governments, &governmentPool);
 
 	// Saves each Government.
-	for (int page = 0; page < numGovernmentPages; ++page) {
-		for (int currGovernment = 0; currGovernment < governmentPages[page]->arrCurrGovernment; ++currGovernment) {
-			government = &governmentPages[page]->governments[currGovernment];
+	for (int page = 0; page < governmentPool.numPages; ++page) {
+		for (int currGovernment = 0; currGovernment < governmentPool.pages[page]->highWater; ++currGovernment) {
+			if (!governmentPool.isLive(page * governmentPool.PAGE_SIZE + currGovernment)) continue;
+			government = &governmentPool.pages[page]->items()[currGovernment];
 
 			// Saves the Government's behaviours.
 			for (int b = 0; b < NUM_GOVERNMENT_BEHAVIOURS; ++b) {
@@ -855,8 +872,7 @@ void saveGovernments(std::ofstream* saveFile) {
 			}
 			// If the Government has a parent, stores its index.
 			else {
-				findGovernmentIndex(a, b, government->parent);
-				index = a * GOVERNMENT_PAGE_SIZE + b;
+				index = governmentPool.indexOf(government->parent);
 				governments.append((char*)&index, sizeof(index));
 
 			}
@@ -868,8 +884,7 @@ void saveGovernments(std::ofstream* saveFile) {
 			for (int col = 0; col < government->numColonies; ++col) {
 
 				// Saves the Colony.
-				findColonyIndex(a, b, government->colonies[col]);
-				index = a * COLONY_PAGE_SIZE + b;
+				index = colonyPool.indexOf(government->colonies[col]);
 				governments.append((char*)&index, sizeof(int));
 
 			}
@@ -911,7 +926,6 @@ void saveHabitableOwners(std::ofstream* saveFile) {
 	std::string owners;
 	HabitablePlanet* planet;
 	Owner* owner;
-	int a, b;
 	int ind;
 
 	// Starts with the designation owners.
@@ -920,7 +934,7 @@ void saveHabitableOwners(std::ofstream* saveFile) {
 	// Saves the owners of each planet in the universe.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				for (int plan = 0; plan < uSystem(i, j)->numHabitable; ++plan) {
 					planet = uSystem(i, j)->planets[plan];
 
@@ -939,8 +953,7 @@ void saveHabitableOwners(std::ofstream* saveFile) {
 						}
 						// If the Owner has a Colony, stores its index.
 						else {
-							findColonyIndex(a, b, owner->colony);
-							ind = a * COLONY_PAGE_SIZE + b;
+							ind = colonyPool.indexOf(owner->colony);
 							owners.append((char*)&ind, sizeof(ind));
 
 						}
@@ -954,8 +967,7 @@ void saveHabitableOwners(std::ofstream* saveFile) {
 						}
 						// If the Owner has an owner, stores its index.
 						else {
-							findGovernmentIndex(a, b, (Government*)owner->owner);
-							ind = a * GOVERNMENT_PAGE_SIZE + b;
+							ind = governmentPool.indexOf((Government*)owner->owner);
 							owners.append((char*)&ind, sizeof(ind));
 
 						}
@@ -990,7 +1002,6 @@ void saveBarrenOwners(std::ofstream* saveFile) {
 	std::string owners;
 	BarrenPlanet* planet;
 	Owner* owner;
-	int a, b;
 	int ind;
 
 	// Starts with the designation owners.
@@ -1028,7 +1039,6 @@ void saveBattles(std::ofstream* saveFile) {
 	GroundOwner* owner;
 	int size;
 	int ind;
-	int a, b;
 
 	// Starts with the designation battles.
 	battles += "battles\n";
@@ -1036,7 +1046,7 @@ void saveBattles(std::ofstream* saveFile) {
 	// Saves the Battles of each planet in the universe.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				for (int plan = 0; plan < uSystem(i, j)->numHabitable; ++plan) {
 					battle = uSystem(i, j)->planets[plan]->battle;
 
@@ -1056,8 +1066,7 @@ void saveBattles(std::ofstream* saveFile) {
 							owner = &battle->owners[own];
 
 							// If the Owner has a Colony, stores its index.
-							findColonyIndex(a, b, owner->owner);
-							ind = a * COLONY_PAGE_SIZE + b;
+							ind = colonyPool.indexOf(owner->owner);
 							battles.append((char*)&ind, sizeof(ind));
 
 							// TODO save groundUnitTemplate here. For now it is inferred from Colony.
@@ -1190,6 +1199,12 @@ void loadFile(std::string fileName) {
 	// Loads the Battles of each planet.
 	loadBattles(&saveFile);
 
+	// Places each planet into the PlanetSets now that its Battle and owners are loaded.
+	habitablePool.forEach([](HabitablePlanet* planet) { planet->updateActivity(); });
+
+	// Builds the PathGraph over the loaded universe.
+	initPathGraph();
+
 	// Close the file and return true.
 	saveFile.close();
 
@@ -1199,18 +1214,14 @@ void loadFile(std::string fileName) {
 Loads metadata for the game.
 */
 void loadMetaData(std::ifstream* saveFile) {
-	int dummySize;
+	int scratchSize;
 
 	// Confirms that meta has been found.
 	confirmToken(saveFile, "meta");
 
-	// Loads dummySize.
-	saveFile->read((char*)&dummySize, sizeof(dummySize));
-	initDummies(dummySize);
-
-	// Loads largeDummySize.
-	saveFile->read((char*)&dummySize, sizeof(dummySize));
-	initLargeDummies(dummySize);
+	// Loads scratchSize.
+	saveFile->read((char*)&scratchSize, sizeof(scratchSize));
+	initScratch(scratchSize);
 
 }
 
@@ -1218,36 +1229,56 @@ void loadMetaData(std::ifstream* saveFile) {
 Loads the tiles of the inputed file to the universe.
 */
 void loadUniverseTiles(std::ifstream* saveFile) {
-	uint_least8_t buff;
-	int** dummyUniverse;
+	uint_least8_t sparse;
+	int numBlocks;
+	int* chunks;
+	uint_least8_t* tileIDs;
+	int numSystems = 0;
+	int currSystem = 0;
 
 	// Confirms that utiles has been found.
 	confirmToken(saveFile, "utiles");
 
-	// Finds universeWidth and universeHeight.
+	// Finds universeWidth, universeHeight, and how the universe is stored.
 	saveFile->read((char*)&universeWidth, sizeof(universeWidth));
 	saveFile->read((char*)&universeHeight, sizeof(universeHeight));
+	saveFile->read((char*)&sparse, sizeof(sparse));
+	saveFile->read((char*)&numBlocks, sizeof(numBlocks));
 
 	// Parses through \n
 	saveFile->ignore(1);
 
-	// Allocates a universe canvas.
-	dummyUniverse = createCanvas(universeWidth, universeHeight);
-
-	// Loads the universe into a dummy.
-	for (int i = 0; i < universeWidth; ++i) {
-		for (int j = 0; j < universeHeight; ++j) {
-			saveFile->read((char*)&buff, sizeof(uint_least8_t));
-			dummyUniverse[i][j] = buff;
+	// Loads every saved block, counting its Systems.
+	chunks = (int*)malloc(numBlocks * sizeof(int));
+	tileIDs = (uint_least8_t*)malloc(numBlocks * UNIVERSE_CHUNK_TILES);
+	for (int b = 0; b < numBlocks; ++b) {
+		saveFile->read((char*)&chunks[b], sizeof(int));
+		saveFile->read((char*)&tileIDs[b * UNIVERSE_CHUNK_TILES], UNIVERSE_CHUNK_TILES);
+		for (int t = 0; t < UNIVERSE_CHUNK_TILES; ++t) if (tileIDs[b * UNIVERSE_CHUNK_TILES + t] == SYSTEM_TILE) ++numSystems;
 
-		}
 	}
 
 	// Creates a new universe of the appropriate size.
-	universeToSpace(dummyUniverse, universeWidth, universeHeight);
+	allSystemSpace = (System*)calloc(numSystems, sizeof(System));
+	initUniverse(universeWidth, universeHeight, sparse);
+
+	// Places the tiles of each block. Every saved chunk is given its own block.
+	for (int b = 0; b < numBlocks; ++b) {
+		int x = chunks[b] / universe.chunksHigh * UNIVERSE_CHUNK_SIZE;
+		int y = chunks[b] % universe.chunksHigh * UNIVERSE_CHUNK_SIZE;
+		universe.touch(chunks[b]);
+		for (int i = x; i < x + UNIVERSE_CHUNK_SIZE; ++i) {
+			for (int j = y; j < y + UNIVERSE_CHUNK_SIZE; ++j) {
+				int tileID = tileIDs[b * UNIVERSE_CHUNK_TILES + UniverseGrid::offset(i, j)];
+				placeUniverseTile(i, j, tileID, tileID == SYSTEM_TILE ? &allSystemSpace[currSystem++] : nullptr);
 
-	// Deallocates the universe canvas.
-	deallocateCanvas(dummyUniverse, universeWidth, universeHeight);
+			}
+		}
+	}
+
+	// Releases held data.
+	free(chunks);
+	free(tileIDs);
 
 }
 
@@ -1264,7 +1295,7 @@ void loadSystemTiles(std::ifstream* saveFile) {
 	// Finds the system to work with.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				currSystem = uSystem(i, j);
 
 				// Places the systems' metadata.
@@ -1291,7 +1322,7 @@ void loadStars(std::ifstream* saveFile) {
 	// Finds the system to work with.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				tile = uSystem(i, j);
 
 				// Places the stars' metadata.
@@ -1323,7 +1354,7 @@ void loadPlanets(std::ifstream* saveFile) {
 	// Finds the system to work with.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				tile = uSystem(i, j);
 
 				// Places the planets and loads their metadata.
@@ -1354,7 +1385,7 @@ void loadPlanets(std::ifstream* saveFile) {
 	// Places planet tiles for each system.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeWidth; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				tile = uSystem(i, j);
 
 				// Places planet tiles for each planet within each system.
@@ -1383,7 +1414,7 @@ void loadBarrens(std::ifstream* saveFile) {
 	// Finds the system to work with.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				tile = uSystem(i, j);
 
 				// Places the planets and loads their metadata.
@@ -1420,7 +1451,7 @@ void loadPlanetTiles(std::ifstream* saveFile) {
 	// Finds the system to work with.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				tile = uSystem(i, j);
 
 				// Loads the PlanetTiles for every planet.
@@ -1453,7 +1484,7 @@ void loadRivers(std::ifstream* saveFile) {
 	// Finds the system to work with.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				tile = uSystem(i, j);
 
 				// Loads the Rivers for each planet.
@@ -1499,7 +1530,7 @@ void loadDeposits(std::ifstream* saveFile) {
 	// Finds the system to work with.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				tile = uSystem(i, j);
 
 				// Loads the deposits for each planet.
@@ -1532,6 +1563,23 @@ void loadDeposits(std::ifstream* saveFile) {
 	}
 }
 
+/*
+Loads the metadata of each page of a PagedPool. The pool must already contain numPages pages.
+*/
+template<class T, int PAGE_BYTES>
+void loadPoolPages(std::ifstream* saveFile, PagedPool<T, PAGE_BYTES>* pool, int numPages) {
+	uint_least64_t live[PagedPool<T, PAGE_BYTES>::LIVE_WORDS];
+	int highWater;
+
+	// Restores the highWater and live bits of each page.
+	for (int page = 0; page < numPages; ++page) {
+		saveFile->read((char*)&highWater, sizeof(highWater));
+		saveFile->read((char*)live, ((highWater + 63) / 64) * sizeof(uint_least64_t));
+		pool->restorePage(page, highWater, live);
+
+	}
+}
+
 /*
 Loads all RaceTemplates.
 */
@@ -1543,20 +1591,18 @@ void loadRaces(std::ifstream* saveFile) {
 	// Confirms that races has been found.
 	confirmToken(saveFile, "races");
 
-	// Initializes the RacePage table.
-	saveFile->read((char*)buff, sizeof(numRacePages));
-	initRaces(*(int*)buff * RACE_PAGE_SIZE - 1);
+	// Initializes racePool.
+	saveFile->read((char*)buff, sizeof(racePool.numPages));
+	initRaces(*(int*)buff * racePool.PAGE_SIZE - 1);
 
-	// Loads the metadata for each RacePage.
-	for (int page = 0; page < numRacePages; ++page) {
-		saveFile->read((char*)&racePages[page]->arrCurrRace, sizeof(racePages[page]->arrCurrRace));
-
-	}
+	// Loads the metadata for each page.
+	loadPoolPages(saveFile, &racePool, *(int*)buff);
 
 	// Loads all RaceTemplates.
-	for (int page = 0; page < numRacePages; ++page) {
-		for (int currRace = 0; currRace < racePages[page]->arrCurrRace; ++currRace) {
-			race = &racePages[page]->races[currRace];
+	for (int page = 0; page < racePool.numPages; ++page) {
+		for (int currRace = 0; currRace < racePool.pages[page]->highWater; ++currRace) {
+			if (!racePool.isLive(page * racePool.PAGE_SIZE + currRace)) continue;
+			race = &racePool.pages[page]->items()[currRace];
 
 			// Assigns parent.
 			saveFile->read((char*)buff, sizeof(int));
@@ -1564,7 +1610,7 @@ void loadRaces(std::ifstream* saveFile) {
 			// If the saved value is negative, assigns parent to nullptr.
 			if (*(int*)buff < 0) race->parent = nullptr;
 			// If the saved value is non-negative, finds the parent.
-			else race->parent = &racePages[(*(int*)buff / RACE_PAGE_SIZE)]->races[*(int*)buff % RACE_PAGE_SIZE];
+			else race->parent = racePool.at(*(int*)buff);
 
 			// Assigns name.
 			saveFile->getline(cbuff, 50, '\n');
@@ -1596,20 +1642,18 @@ void loadMarkets(std::ifstream* saveFile) {
 	// Confirms that markets has been found.
 	confirmToken(saveFile, "markets");
 
-	// Initializes the MarketPage table.
-	saveFile->read((char*)buff, sizeof(numMarketPages));
-	initMarkets(*(int*)buff * MARKET_PAGE_SIZE - 1);
-
-	// Loads the metadata for each MarketPage.
-	for (int page = 0; page < numMarketPages; ++page) {
-		saveFile->read((char*)&marketPages[page]->arrCurrMarket, sizeof(marketPages[page]->arrCurrMarket));
+	// Initializes marketPool.
+	saveFile->read((char*)buff, sizeof(marketPool.numPages));
+	initMarkets(*(int*)buff * marketPool.PAGE_SIZE - 1);
 
-	}
+	// Loads the metadata for each page.
+	loadPoolPages(saveFile, &marketPool, *(int*)buff);
 
 	// Loads all Markets.
-	for (int page = 0; page < numMarketPages; ++page) {
-		for (int currMarket = 0; currMarket < marketPages[page]->arrCurrMarket; ++currMarket) {
-			market = &marketPages[page]->markets[currMarket];
+	for (int page = 0; page < marketPool.numPages; ++page) {
+		for (int currMarket = 0; currMarket < marketPool.pages[page]->highWater; ++currMarket) {
+			if (!marketPool.isLive(page * marketPool.PAGE_SIZE + currMarket)) continue;
+			market = &marketPool.pages[page]->items()[currMarket];
 
 			// Loads Goods.
 			saveFile->read((char*)&market->goods, sizeof(market->goods));
@@ -1638,7 +1682,7 @@ inline void loadRaceInstances(std::ifstream* saveFile, Colony* colony) {
 
 		// Loads the RaceInstance's RaceTemplate.
 		saveFile->read((char*)buff, sizeof(int));
-		race->race = &racePages[(*(int*)buff / RACE_PAGE_SIZE)]->races[*(int*)buff % RACE_PAGE_SIZE];
+		race->race = *(int*)buff == -1 ? getOrcs() : racePool.at(*(int*)buff);
 
 		// Loads the RaceInstance's numPops.
 		saveFile->read((char*)&race->numPops, sizeof(race->numPops));
@@ -1660,31 +1704,29 @@ void loadColonies(std::ifstream* saveFile) {
 	// Confirms that colonies has been found.
 	confirmToken(saveFile, "colonies");
 
-	// Initializes the ColonyPage table.
-	saveFile->read((char*)buff, sizeof(numColonyPages));
-	initColonies(*(int*)buff * COLONY_PAGE_SIZE - 1);
-
-	// Loads the metadata for each ColonyPage.
-	for (int page = 0; page < numColonyPages; ++page) {
-		saveFile->read((char*)&colonyPages[page]->arrCurrColony, sizeof(colonyPages[page]->arrCurrColony));
+	// Initializes colonyPool.
+	saveFile->read((char*)buff, sizeof(colonyPool.numPages));
+	initColonies(*(int*)buff * colonyPool.PAGE_SIZE - 1);
 
-	}
+	// Loads the metadata for each page.
+	loadPoolPages(saveFile, &colonyPool, *(int*)buff);
 
 	// Loads all Colonies.
-	for (int page = 0; page < numColonyPages; ++page) {
-		for (int currColony = 0; currColony < colonyPages[page]->arrCurrColony; ++currColony) {
-			colony = &colonyPages[page]->colonies[currColony];
+	for (int page = 0; page < colonyPool.numPages; ++page) {
+		for (int currColony = 0; currColony < colonyPool.pages[page]->highWater; ++currColony) {
+			if (!colonyPool.isLive(page * colonyPool.PAGE_SIZE + currColony)) continue;
+			colony = &colonyPool.pages[page]->items()[currColony];
 
 			// Loads the Colony's HabiablePlanet.
 			saveFile->read((char*)buff, sizeof(int));
-			colony->planet = &habitablePages[(*(int*)buff / HABITABLE_PAGE_SIZE)]->planets[*(int*)buff % HABITABLE_PAGE_SIZE];
+			colony->planet = habitablePool.at(*(int*)buff);
 
 			// Determines whether this Colony is the marketCapital of its Market.
 			saveFile->read((char*)&capital, sizeof(capital));
 
 			// Loads the Colony's market.
 			saveFile->read((char*)buff, sizeof(int));
-			colony->market = &marketPages[(*(int*)buff / MARKET_PAGE_SIZE)]->markets[*(int*)buff % MARKET_PAGE_SIZE];
+			colony->market = marketPool.at(*(int*)buff);
 
 			// Loads the Colony's number of RaceInstances.
 			saveFile->read((char*)&colony->numRaces, sizeof(colony->numRaces));
@@ -1710,20 +1752,18 @@ void loadGovernments(std::ifstream* saveFile) {
 	// Confirms that governments has been found.
 	confirmToken(saveFile, "governments");
 
-	// Initializes the GovernmentPage table.
-	saveFile->read((char*)&buff, sizeof(numGovernmentPages));
-	initGovernments(buff * GOVERNMENT_PAGE_SIZE - 1);
+	// Initializes governmentPool.
+	saveFile->read((char*)&buff, sizeof(governmentPool.numPages));
+	initGovernments(buff * governmentPool.PAGE_SIZE - 1);
 
-	// Loads the metadata for each GovernmentPage.
-	for (int page = 0; page < numGovernmentPages; ++page) {
-		saveFile->read((char*)&governmentPages[page]->arrCurrGovernment, sizeof(governmentPages[page]->arrCurrGovernment));
-
-	}
+	// Loads the metadata for each page.
+	loadPoolPages(saveFile, &governmentPool, buff);
 
 	// Loads all Governments.
-	for (int page = 0; page < numGovernmentPages; ++page) {
-		for (int currGovernment = 0; currGovernment < governmentPages[page]->arrCurrGovernment; ++currGovernment) {
-			government = &governmentPages[page]->governments[currGovernment];
+	for (int page = 0; page < governmentPool.numPages; ++page) {
+		for (int currGovernment = 0; currGovernment < governmentPool.pages[page]->highWater; ++currGovernment) {
+			if (!governmentPool.isLive(page * governmentPool.PAGE_SIZE + currGovernment)) continue;
+			government = &governmentPool.pages[page]->items()[currGovernment];
 
 			// Loads the Government's behaviours.
 			for (int b = 0; b < NUM_GOVERNMENT_BEHAVIOURS; ++b) {
@@ -1747,7 +1787,7 @@ void loadGovernments(std::ifstream* saveFile) {
 			// If the saved value is negative, assigns parent to nullptr.
 			if (buff < 0) government->parent = nullptr;
 			// If the saved value is non-negative, finds the parent.
-			else government->parent = &governmentPages[(buff / GOVERNMENT_PAGE_SIZE)]->governments[buff % GOVERNMENT_PAGE_SIZE];
+			else government->parent = governmentPool.at(buff);
 
 			// Loads the Government's number of Colonies.
 			saveFile->read((char*)&government->numColonies, sizeof(government->numColonies));
@@ -1758,7 +1798,7 @@ void loadGovernments(std::ifstream* saveFile) {
 
 				// Loads the Government's Colony.
 				saveFile->read((char*)&buff, sizeof(int));
-				government->colonies[col] = &colonyPages[(buff / COLONY_PAGE_SIZE)]->colonies[buff % COLONY_PAGE_SIZE];
+				government->colonies[col] = colonyPool.at(buff);
 
 				// Marks the Government in the Colony.
 				government->colonies[col]->government = government;
@@ -1809,7 +1849,7 @@ void loadHabitableOwners(std::ifstream* saveFile) {
 	// Loads the owners of each planet in the universe.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				for (int plan = 0; plan < uSystem(i, j)->numHabitable; ++plan) {
 					planet = uSystem(i, j)->planets[plan];
 
@@ -1826,7 +1866,7 @@ void loadHabitableOwners(std::ifstream* saveFile) {
 						// If the saved value is negative, assigns colony to nullptr.
 						if (*(int*)buff < 0) owner->colony = nullptr;
 						// If the saved value is non-negative, finds the Colony.
-						else owner->colony = &colonyPages[(*(int*)buff / COLONY_PAGE_SIZE)]->colonies[*(int*)buff % COLONY_PAGE_SIZE];
+						else owner->colony = colonyPool.at(*(int*)buff);
 
 						// Loads the Owner's owner.
 						// TODO account for different types of owner.
@@ -1835,7 +1875,7 @@ void loadHabitableOwners(std::ifstream* saveFile) {
 						// If the saved value is negative, assigns owner to nullptr.
 						if (*(int*)buff < 0) owner->owner = nullptr;
 						// If the saved value is non-negative, finds the colony.
-						else owner->owner = &governmentPages[(*(int*)buff / GOVERNMENT_PAGE_SIZE)]->governments[*(int*)buff % GOVERNMENT_PAGE_SIZE];
+						else owner->owner = governmentPool.at(*(int*)buff);
 
 					}
 				}
@@ -1872,7 +1912,7 @@ void loadBattles(std::ifstream* saveFile) {
 	// Loads the Battles of each planet in the universe.
 	for (int i = 0; i < universeWidth; ++i) {
 		for (int j = 0; j < universeHeight; ++j) {
-			if (uIndex(i, j).tileID == SYSTEM_TILE) {
+			if (uTileID(i, j) == SYSTEM_TILE) {
 				for (int plan = 0; plan < uSystem(i, j)->numHabitable; ++plan) {
 
 					// Checks whether a battle exists.
@@ -1896,7 +1936,7 @@ void loadBattles(std::ifstream* saveFile) {
 
 							// Loads the Owner's Colony.
 							saveFile->read((char*)&buff, sizeof(buff));
-							owner->owner = &colonyPages[(buff / COLONY_PAGE_SIZE)]->colonies[buff % COLONY_PAGE_SIZE];
+							owner->owner = colonyPool.at(buff);
 
 							// Finds the Owner's groundUnitTemplate.
 							// TODO load groundUnitTemplate here. For now it is inferred from Colony.
@@ -1939,6 +1979,9 @@ void loadBattles(std::ifstream* saveFile) {
 						battle->battlefield = new GroundBattleTile[battle->planet->size * battle->planet->size];
 						saveFile->read((char*)battle->battlefield, battle->planet->size * battle->planet->size * sizeof(battle->battlefield[0]));
 
+						// Rebuilds the parts of the Battle which are not saved.
+						battle->rebuild();
+
 					}
 				}
 			}
@@ -1954,13 +1997,18 @@ void loadInitPlanets() {
 	int numHabitable = 0;
 
 	// Counts the number of habitable planets and barren planets.
-	for (int i = 0; i < universeWidth * universeHeight; ++i) {
-		if (universe[i].tileID == SYSTEM_TILE) {
-			numHabitable += universe[i].system->numHabitable;
-			numBarren += universe[i].system->numBarren;
+	forUniverseWindow(0, 0, universeWidth, universeHeight,
+		[](UniverseChunk& chunk)->bool { return chunk.numSystems > 0; },
+		[&numHabitable, &numBarren](int x, int y)->bool {
+			if (uTileID(x, y) == SYSTEM_TILE) {
+				numHabitable += uSystem(x, y)->numHabitable;
+				numBarren += uSystem(x, y)->numBarren;
+
+			}
+			return true;
 
 		}
-	}
+	);
 
 	// Calls initHabitable and initBarren.
 	initHabitablePlanets(numHabitable);
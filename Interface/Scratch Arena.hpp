@@ -0,0 +1,380 @@
+#pragma once
+
+// Minimum size of the first chunk of a ScratchArena, in bytes.
+#define SCRATCH_CHUNK_BYTES 1048576
+
+// Alignment of every allocation made from a ScratchArena.
+#define SCRATCH_ALIGNMENT 16
+
+// Number of bytes that each ScratchArena's first chunk should be able to hold. Set by initScratch.
+size_t scratchReserve;
+
+// Raised once per turn by resetScratch. Arenas which have fallen behind are reset when next used.
+std::atomic<unsigned int> scratchEpoch(0);
+
+// Sets the number of bytes reserved by each thread's ScratchArena.
+void initScratch(size_t size);
+
+// Frees all scratch space which was used during the current turn.
+void resetScratch();
+
+/*
+Position within a ScratchArena. Rewinding to a ScratchMark frees everything allocated after it.
+*/
+struct ScratchMark {
+	void* chunk;
+	size_t used;
+
+};
+
+/*
+Linear arena for temporaries. Replaces the dummies and coordLists which were previously shared
+between threads under a mutex.
+
+Each thread has its own ScratchArena (scratchArena), so allocating never needs a lock. Allocating
+moves an offset along the current chunk. Chunks are added as needed and are never moved, so
+earlier allocations stay valid while the arena grows. Memory is freed by rewinding to a
+ScratchMark, which ScratchScopes do automatically.
+
+Everything allocated outside of any ScratchScope lives until the end of the turn. resetScratch
+raises scratchEpoch, and each arena resets itself the next time it is used outside of a
+ScratchScope. When an arena resets, its chunks are merged into one, so a thread which needed
+several chunks in one turn needs only one from then on.
+*/
+class ScratchArena {
+public:
+
+	// Number of ScratchScopes currently open on this arena.
+	int depth;
+
+	// Constructor.
+	ScratchArena();
+
+	// Deconstructor. Frees every chunk.
+	~ScratchArena();
+
+	// Allocates bytes. The memory is not cleared.
+	void* allocate(size_t bytes);
+
+	// Returns the current position of the arena.
+	inline ScratchMark mark() { return { curr, used }; }
+
+	// Frees everything allocated after the inputed mark.
+	inline void rewind(ScratchMark mark) { curr = (Chunk*)mark.chunk; used = mark.used; }
+
+	// Resets the arena if resetScratch has been called since it was last reset.
+	inline void update() { if (!depth && epoch != scratchEpoch.load(std::memory_order_relaxed)) reset(); }
+
+	// Frees everything in the arena.
+	void reset();
+
+private:
+
+	/*
+	Chunk of memory. The chunk's data directly follows this header.
+	*/
+	struct Chunk {
+		Chunk* next;
+		size_t size;
+
+		// Returns the chunk's data.
+		inline unsigned char* data() { return (unsigned char*)(this + 1); }
+
+	};
+
+	// First and current chunks, and the number of bytes used in the current chunk.
+	// curr is nullptr while nothing has been allocated.
+	Chunk* first;
+	Chunk* curr;
+	size_t used;
+
+	// Value of scratchEpoch when this arena was last reset.
+	unsigned int epoch;
+
+	// Moves on to a chunk which can hold bytes, creating one if necessary.
+	void grow(size_t bytes);
+
+	// Creates a chunk with space for size bytes.
+	Chunk* createChunk(size_t size);
+
+};
+
+// ScratchArena belonging to the calling thread.
+thread_local ScratchArena scratchArena;
+
+/*
+Frees everything allocated from the calling thread's ScratchArena within its lifetime. Scopes
+must be destroyed in the opposite order to which they were created, which happens naturally
+when they are declared as local variables.
+*/
+class ScratchScope {
+public:
+
+	// Constructor. Marks the calling thread's ScratchArena.
+	ScratchScope();
+
+	// Deconstructor. Rewinds the arena to its mark.
+	~ScratchScope();
+
+	// Allocates an array of count items of type T. The array is not cleared.
+	template<class T>
+	inline T* array(int count) { return (T*)scratchArena.allocate(sizeof(T) * count); }
+
+	// Allocates a cleared array of count items of type T.
+	template<class T>
+	inline T* zeroed(int count) { return (T*)memset(scratchArena.allocate(sizeof(T) * count), 0, sizeof(T) * count); }
+
+private:
+
+	// Position of the arena when this scope was created.
+	ScratchMark start;
+
+};
+
+/*
+Growable array of trivially copyable items, allocated from the calling thread's ScratchArena.
+When full, the items are copied into an array twice as large. The old array is only freed when
+the arena is rewound.
+
+A ScratchVector must not grow while a ScratchScope created after it is open, since its new
+array would be freed along with that scope.
+*/
+template<class T>
+class ScratchVector {
+public:
+
+	// Items, number of items and capacity.
+	T* items;
+	int count;
+	int capacity;
+
+	// Constructor. Allocates space for capacity items.
+	ScratchVector(int capacity = 64) : items((T*)scratchArena.allocate(sizeof(T) * capacity)), count(0), capacity(capacity) { }
+
+	// Appends an item.
+	inline void push_back(const T& item) {
+		if (count == capacity) grow();
+		items[count++] = item;
+
+	}
+
+	// Removes the last item.
+	inline void pop_back() { --count; }
+
+	// Returns the last item.
+	inline T& back() { return items[count - 1]; }
+
+	// Checks if there are no items.
+	inline bool empty() { return !count; }
+
+	// Returns the number of items.
+	inline int size() { return count; }
+
+	// Accesses an item.
+	inline T& operator[](int i) { return items[i]; }
+
+private:
+
+	// Doubles the capacity.
+	void grow() {
+		T* newItems = (T*)scratchArena.allocate(sizeof(T) * capacity * 2);
+		memcpy(newItems, items, sizeof(T) * count);
+		items = newItems;
+		capacity *= 2;
+
+	}
+};
+
+/*
+Free list of LinkedListNodes and their values, allocated from the calling thread's ScratchArena.
+Replaces the coordLists, which held a fixed 10000 nodes each. popc creates a new node whenever
+the free list is empty, so searches are only limited by memory.
+
+The same restriction as ScratchVector applies: nodes must not be created while a ScratchScope
+created after the ScratchList is open.
+*/
+template<class C>
+class ScratchList {
+public:
+
+	// Constructor.
+	ScratchList() : root(nullptr) { }
+
+	// Pops a node from the free list, or creates one if the list is empty. The node's value is not cleared.
+	inline LinkedListNode<C>* popc() {
+		LinkedListNode<C>* node = root;
+		if (node) root = node->child;
+		else {
+			node = (LinkedListNode<C>*)scratchArena.allocate(sizeof(LinkedListNode<C>) + sizeof(C));
+			node->value = (C*)(node + 1);
+
+		}
+		node->child = nullptr;
+		return node;
+
+	}
+
+	// Returns a node to the free list.
+	inline void addc(LinkedListNode<C>* node) {
+		node->child = root;
+		root = node;
+
+	}
+
+private:
+
+	// First node of the free list.
+	LinkedListNode<C>* root;
+
+};
+
+/*
+Constructor. Chunks are only created once something is allocated.
+*/
+ScratchArena::ScratchArena() : depth(0), first(nullptr), curr(nullptr), used(0), epoch(0) { }
+
+/*
+Deconstructor. Frees every chunk.
+*/
+ScratchArena::~ScratchArena() {
+	Chunk* next;
+
+	// Frees the chunks.
+	for (Chunk* chunk = first; chunk; chunk = next) {
+		next = chunk->next;
+		free(chunk);
+
+	}
+}
+
+/*
+Allocates bytes from the arena. Sizes are rounded up to SCRATCH_ALIGNMENT.
+*/
+void* ScratchArena::allocate(size_t bytes) {
+	void* ret;
+
+	// Rounds bytes up to the alignment.
+	bytes = (bytes + SCRATCH_ALIGNMENT - 1) & ~(size_t)(SCRATCH_ALIGNMENT - 1);
+
+	// Resets the arena if the turn has ended, then finds space for the allocation.
+	update();
+	if (!curr || used + bytes > curr->size) grow(bytes);
+	ret = curr->data() + used;
+	used += bytes;
+	return ret;
+
+}
+
+/*
+Frees everything in the arena. Merges every chunk into a single chunk large enough to
+hold all of them, and at least scratchReserve bytes.
+*/
+void ScratchArena::reset() {
+	size_t total = 0;
+	Chunk* next;
+
+	// Merges the chunks if there are several of them or the first is too small.
+	if (first && (first->next || first->size < scratchReserve)) {
+		for (Chunk* chunk = first; chunk; chunk = next) {
+			next = chunk->next;
+			total += chunk->size;
+			free(chunk);
+
+		}
+		first = createChunk(total > scratchReserve ? total : scratchReserve);
+
+	}
+
+	// Starts from the beginning of the arena.
+	curr = nullptr;
+	used = 0;
+	epoch = scratchEpoch.load(std::memory_order_relaxed);
+
+}
+
+/*
+Moves on to the chunk after the current chunk. The chunk is replaced if it cannot hold bytes,
+and is created if it does not exist. New chunks are at least twice the size of the last.
+*/
+void ScratchArena::grow(size_t bytes) {
+	Chunk* prev = curr;
+	Chunk* next = prev ? prev->next : first;
+	Chunk* after = nullptr;
+	size_t size;
+
+	// Replaces the next chunk if it is too small. It is past the end of the arena, so it is unused.
+	if (next && next->size < bytes) {
+		after = next->next;
+		free(next);
+		next = nullptr;
+
+	}
+
+	// Creates a new chunk.
+	if (!next) {
+		size = prev ? prev->size * 2 : (scratchReserve > SCRATCH_CHUNK_BYTES ? scratchReserve : SCRATCH_CHUNK_BYTES);
+		if (size < bytes) size = bytes;
+		next = createChunk(size);
+		next->next = after;
+		if (prev) prev->next = next;
+		else first = next;
+
+	}
+
+	// Moves on to the chunk.
+	curr = next;
+	used = 0;
+
+}
+
+/*
+Creates a chunk with space for size bytes.
+*/
+ScratchArena::Chunk* ScratchArena::createChunk(size_t size) {
+	Chunk* chunk = (Chunk*)malloc(sizeof(Chunk) + size);
+	chunk->next = nullptr;
+	chunk->size = size;
+	return chunk;
+
+}
+
+/*
+Constructor. Resets the arena if the turn has ended, then marks it.
+*/
+ScratchScope::ScratchScope() {
+	scratchArena.update();
+	start = scratchArena.mark();
+	++scratchArena.depth;
+
+}
+
+/*
+Deconstructor. Frees everything allocated since this scope was created.
+*/
+ScratchScope::~ScratchScope() {
+	--scratchArena.depth;
+	scratchArena.rewind(start);
+
+}
+
+/*
+Sets the number of bytes reserved by each thread's ScratchArena. Each arena grows its first chunk
+to this size the next time it is reset. Should be large enough to hold a copy of the universe or
+of the largest planet.
+
+This is called in generateUniverse in Universe Generator.hpp and when loading.
+*/
+void initScratch(size_t size) {
+	scratchReserve = size;
+	resetScratch();
+
+}
+
+/*
+Frees all scratch space which was used during the current turn. Should only be called at the
+end of a phase, when no thread is inside a ScratchScope belonging to that phase.
+*/
+void resetScratch() {
+	scratchEpoch.fetch_add(1, std::memory_order_relaxed);
+
+}
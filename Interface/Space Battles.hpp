@@ -1,206 +1,155 @@
 #pragma once
 
-// Resources for spaceBattle multithreading.
-std::shared_mutex spaceBattleMutex;
-Semaphore spaceBattleSemaphore(0, 0);
+// Number of Squadrons given to each spaceBattle Task.
+#define SPACE_BATTLE_GRAIN 32
+
+// TODO temp
+// This is the maximum range to draw a threat from.
+#define THREAT_RANGE 8
+
+/*
+Performs space Battles and executes Squadron orders for a range of the SquadronRegistry.
+Squadrons deleted before the phase have empty entries, and are skipped. Squadrons defeated
+during the phase keep their entries until the phase is over, and do nothing when they act.
+*/
+void spaceBattle(int beg, int end) {
+
+	// Parses through each assigned Squadron to perform actions.
+	for (int i = beg; i < end; ++i) {
+		Squadron* squadron = squadronRegistry.entries[i].squadron;
+		if (squadron) squadron->action();
+
+	}
+}
 
 /*
 Performs space Battles and executes Squadron orders.
 
-Does so by requesting an integer from a mutexed function, then acquiring a strip
-of a Galaxy based on the returned integer.
+Rebuilds any dirty part of the PathGraph and syncs the SquadronRegistry, then splits it into runs of SPACE_BATTLE_GRAIN Squadrons, which are
+spread over all threads. Work therefore depends on the number of Squadrons rather than the area
+of each Galaxy, and each Squadron acts exactly once per turn. Since the registry is ordered by
+location, each run covers nearby Squadrons. Squadrons defeated during the phase are destroyed
+once every Squadron has acted.
 */
 void spaceBattle() {
-	Galaxy* gal;
-	int strip;
-	int xBeg, xEnd;
-	int yBeg, yEnd;
+	ProfileScope scope(SPACE_BATTLE_ZONE);
+	updatePathGraph();
+	syncSquadronRegistry();
+	parallelFor(0, squadronRegistry.numEntries, SPACE_BATTLE_GRAIN, [](int beg, int end) {
+		spaceBattle(beg, end);
 
-	// Requests a strip of a Galaxy to perform orders in.
-	for (int t = requestInt(); t < numGals * numThreads; t = requestInt()) {
+	});
+	destroyDefeatedSquadrons();
 
-		// Derives the appropriate Galaxy and strip to use from t.
-		gal = &galaxies[t / numThreads];
-		strip = t % numThreads;
+}
 
-		// Starts within the t / numThreads segment of the current Galaxy.
-		xBeg = gal->area.x + strip * (gal->area.w / numThreads);
+/*
+Manages Threat for all Squadrons within a range of SquadronCells.
 
-		// Ends at the t + 1 / numThreads segment of the current Galaxy.
-		xEnd = gal->area.x + (strip + 1) * (gal->area.w / numThreads);
+TODO make some means of determining which Squadrons are enemies.
+*/
+void squadronThreats(int cellBeg, int cellEnd) {
 
-		// Makes sure that the final strip reaches the end.
-		if (strip == numThreads - 1) xEnd = gal->area.x + gal->area.w;
+	// Parses through each assigned SquadronCell to find Squadrons.
+	for (int c = cellBeg; c < cellEnd; ++c) {
+		SquadronCell& cell = squadronCells[c];
 
-		// Strips are vertical to maximize spatial locality (see index function).
-		yBeg = gal->area.y;
-		yEnd = gal->area.y + gal->area.h;
+		// Manages all Squadrons in the cell.
+		for (int s = 0; s < cell.numSquadrons; ++s) {
+			Squadron* squadron = cell.squadrons[s];
 
-		// Parses through each assigned tile to find Squadrons.
-		for (int x = xBeg; x < xEnd; ++x) {
-			for (int y = yBeg; y < yEnd; ++y) {
+			// Adds all nearby enemy Squadrons as Threats.
+			// TODO create some means of determining who is an enemy.
+			forHostileSquadrons(squadron->loc.x, squadron->loc.y, THREAT_RANGE / 2, squadron->owner,
+				[squadron](Squadron* threat) { squadron->addThreat(threat); });
 
-				// Parses through each Squadron to perform actions.
-				for (int s = 0; s < uIndex(x, y).numSquadrons; ++s) {
-					uSquadron(x, y, s)->action();
+			// Handles threats for the current Squadron.
+			squadron->handleThreats();
 
-				}
-			}
 		}
 	}
 }
 
 /*
-Manages Threat for all Squadrons and Colonies.
-
-For Squadrons, manages threats by requesting an integer from a mutexed function,
-then managing Threats in a strip of a Galaxy based on the returned integer. This
-is the same as spaceBattle.
+Manages Threat for all Colonies within a ColonyPage.
 
-For Colonies, manages threats by requesting a ColonyPage and managing threats
-within said page.
-
-TODO change threat range
 TODO make some means of determining which Squadrons are enemies.
 */
-void spaceThreats() {
-	Galaxy* gal;
-	Colony* colony;
-	CoordU loc;
-	int t;
-	int strip;
-	int page;
-	int xBeg, xEnd;
-	int yBeg, yEnd;
-	int iBeg, iEnd;
-	int jBeg, jEnd;
-
-	// TODO temp
-	// This is the maximum range to draw a threat from.
-	const int range = 8;
-
-	// Requests a strip of a Galaxy to find threat in.
-	while ((t = requestInt()) < numGals * numThreads) {
-
-		// Derives the appropriate Galaxy and strip to use from t.
-		gal = &galaxies[t / numThreads];
-		strip = t % numThreads;
-
-		// Starts within the t / numThreads segment of the current Galaxy.
-		xBeg = gal->area.x + strip * (gal->area.w / numThreads);
-
-		// Ends at the t + 1 / numThreads segment of the current Galaxy.
-		xEnd = gal->area.x + (strip + 1) * (gal->area.w / numThreads);
-
-		// Makes sure that the final strip reaches the end.
-		if (strip == numThreads - 1) xEnd = gal->area.x + gal->area.w;
-
-		// Strips are vertical to maximize spatial locality (see index function).
-		yBeg = gal->area.y;
-		yEnd = gal->area.y + gal->area.h;
-
-		// Parses through each assigned tile to find Squadrons.
-		for (int x = xBeg; x < xEnd; ++x) {
-			for (int y = yBeg; y < yEnd; ++y) {
-
-				// Begins parsing if and only if there are Squadrons in the tile.
-				if (uIndex(x, y).numSquadrons) {
-
-					// Will not go over the bounds of the Galaxy.
-					iBeg = x - range / 2 < gal->area.x ? gal->area.x : x - range / 2;
-					iEnd = x + range / 2 > gal->area.x + gal->area.w ? gal->area.x + gal->area.w : x + range / 2;
-					jBeg = y - range / 2 < gal->area.y ? gal->area.y : y - range / 2;
-					jEnd = y + range / 2 > gal->area.y + gal->area.h ? gal->area.y + gal->area.h : y + range / 2;
-
-					// Manages all Squadrons in the tile.
-					for (int s = 0; s < uIndex(x, y).numSquadrons; ++s) {
-						Squadron* squadron = uSquadron(x, y, s);
-
-						// Removes deleted Threats from the Squadron.
-						removeDeletedSquadrons(uSquadron(x, y, s));
-
-						// Parses through all nearby tiles to find threats to the current Squadron.
-						for (int i = iBeg; i < iEnd; ++i) {
-							for (int j = jBeg; j < jEnd; ++j) {
-
-								// Adds all nearby enemy Squadrons as Threats.
-								// TODO create some means of determining who is an enemy.
-								for (int k = 0; k < uIndex(i, j).numSquadrons; ++k) {
-
-									// Adds threats to the Squadron.
-									if (uSquadron(i, j, k)->owner != squadron->owner)
-										squadron->addThreat(uSquadron(i, j, k));
-
-								}
-							}
-						}
-
-						// Handles threats for the current Squadron.
-						squadron->handleThreats();
-
-					}
-				}
-			}
-		}
-	}
+void colonyThreats(int page) {
 
-	// Parses through all Colonies and manages threat for them.
-	while ((page = requestColonyPage()) != -1) {
-		for (int col = 0; col < colonyPages[page]->arrCurrColony; ++col) {
-			colony = &colonyPages[page]->colonies[col];
+	// Parses through all live Colonies and manages threat for them.
+	colonyPool.forEachInPage(page, [](Colony* colony) {
+		CoordU loc;
 
-			// Will not add threats if the Colony is unowned.
-			if (!colony->government) continue;
+		// Will not add threats if the Colony is unowned.
+		if (!colony->government) return;
 
-			// Removes deleted Threats from the Colony.
-			removeDeletedSquadrons(colony);
+		// Adds all nearby enemy Squadrons as Threats.
+		// TODO create some means of determining who is an enemy
+		loc = colony->planet->loc;
+		forHostileSquadrons(loc.x, loc.y, THREAT_RANGE / 2, colony->government,
+			[colony](Squadron* threat) { colony->addThreat(threat); });
 
-			// Stores the location and Galaxy.
-			loc = colony->planet->loc;
-			gal = findGalaxy(loc.x, loc.y);
+		// Handles threatsa for the current Colony.
+		colony->handleThreats();
 
-			// Will not go over the bounds of the Galaxy.
-			iBeg = loc.x - range / 2 < gal->area.x ? gal->area.x : loc.x - range / 2;
-			iEnd = loc.x + range / 2 > gal->area.x + gal->area.w ? gal->area.x + gal->area.w : loc.x - range / 2;
-			jBeg = loc.y - range / 2 < gal->area.y ? gal->area.y : loc.y - range / 2;
-			jEnd = loc.y + range / 2 > gal->area.y + gal->area.h ? gal->area.y + gal->area.h : loc.y - range / 2;
+	});
+}
 
-			// Parses through all nearby tiles to find threats to the current Colony.
-			for (int i = iBeg; i < iEnd; ++i) {
-				for (int j = jBeg; j < jEnd; ++j) {
+/*
+Manages Threat for all Squadrons and Colonies.
 
-					// Adds all nearby enemy Squadrons as Threats.
-					// TODO create some means of determining who is an enemy
-					for (int k = 0; k < uIndex(i, j).numSquadrons; ++k) {
-						if (uSquadron(i, j, k)->owner != colony->government) {
-							colony->addThreat(uSquadron(i, j, k));
+For Squadrons, manages threats in runs of SquadronCells. Since cells are stored by column, each
+run covers a vertical strip of the universe.
+For Colonies, manages threats for each ColonyPage.
+Both query the SquadronGrid, so only cells within THREAT_RANGE / 2 of an entity are searched.
 
-						}
-					}
-				}
-			}
+TODO change threat range
+*/
+void spaceThreats() {
+	ProfileScope scope(SPACE_THREATS_ZONE);
 
-			// Handles threatsa for the current Colony.
-			colony->handleThreats();
+	// Manages threats for Squadrons.
+	parallelFor(0, squadronGridWidth * squadronGridHeight, squadronGridHeight, [](int beg, int end) {
+		squadronThreats(beg, end);
 
-		}
-	}
+	});
 
+	// Manages threats for Colonies.
+	parallelFor(0, colonyPool.numPages, 1, [](int beg, int end) {
+		for (int page = beg; page < end; ++page) colonyThreats(page);
+
+	});
 }
 
 /*
-Multithreaded closure management function.
+Multithreaded closure management function. Manages each dirty page of closures.
+
+Merged closures are relabeled in parallel, then released in a single thread since releasing
+modifies Governments, and finally flagged closures are split in parallel.
 */
 void manageClosures() {
-	int page;
+	ProfileScope scope(MANAGE_CLOSURES_ZONE);
 
-	// Performs closure management for each dirty ClosurePage.
-	while ((page = requestDirtyClosurePage()) >= 0) {
+	// Relabels the tiles of merged closures.
+	parallelFor(0, closurePool.numPages, 1, [](int beg, int end) {
+		for (int page = beg; page < end; ++page) if (closurePool.pages[page]->dirty) mergeClosures(page);
 
-		// Performs closure management for all closures on a dirty page.
-		for (int i = 0; i < habitablePages[page]->arrCurrPlanet; ++i) manageClosures(page);
+	});
 
-	}
+	// Releases merged closures.
+	for (int page = 0; page < closurePool.numPages; ++page) if (closurePool.pages[page]->dirty) flattenClosures(page);
+	for (int page = 0; page < closurePool.numPages; ++page) if (closurePool.pages[page]->dirty) releaseMergedClosures(page);
+
+	// Splits closures which may have been disconnected.
+	parallelFor(0, closurePool.numPages, 1, [](int beg, int end) {
+		for (int page = beg; page < end; ++page) {
+			if (!closurePool.pages[page]->dirty) continue;
+			closurePool.pages[page]->dirty = false;
+			splitClosures(page);
+
+		}
+	});
 }
 
 /*
@@ -212,15 +161,10 @@ void spaceBattles() {
 	// Manages space battles in a threaded fashion.
 	spaceBattle();
 
-	// Block that forces all threads wait until spaceBattle is over before proceeding.
-	spaceBattleSemaphore.post();
-	spaceBattleMutex.lock_shared();
-	spaceBattleMutex.unlock_shared();
-
 	// Manages space threats in a threaded fashion.
 	spaceThreats();
 
 	// Reconciles closures after battles are finished.
 	manageClosures();
 
-}
\ No newline at end of file
+}
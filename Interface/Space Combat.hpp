@@ -73,18 +73,18 @@ Stores a Squadron. Squadrons are composed of Ships.
 
 TODO include commanding officers.
 
-72 bytes, 0 bytes padding.
-sizeof is 72 bytes.
+72 bytes, 0 bytes padding, where std::vector takes 24 bytes. Debug builds may use a larger
+std::vector, so the size is checked against 48 bytes plus the vector below.
 */
 class Squadron {
 public:
 
 	// Threat queue of the Squadron.
-	std::vector<Threat> threats; // 32 bytes.
+	std::vector<Threat> threats; // 24 bytes.
 
 	// Miscellaneous data for this Squadron.
 	// Paths are accessed via getPath();
-	void* data;
+	void* data; // 8 bytes.
 
 	// Owner of this Squadron.
 	Government* owner; // 8 bytes.
@@ -96,7 +96,7 @@ public:
 	Ship* ships; // 8 bytes
 
 	// Estimated strength of the Squadron.
-	uint_least16_t strength; // 4 bytes
+	uint_least16_t strength; // 2 bytes
 
 	// Current location of the Squadron.
 	CoordU loc; // 4 bytes.
@@ -104,11 +104,18 @@ public:
 	// Number of ships in the squadron.
 	uint_least16_t numShips; // 2 bytes
 
+	// Index of the Squadron in the SquadronRegistry, or -1 if it has not been synced yet.
+	int registryIndex; // 4 bytes
+
+	// Handle of the Squadron within the SquadronStore.
+	SquadronHandle handle; // 4 bytes
+
 	// No bytes padding.
 
 	// Constructor for the Squadron. Assigns inputed values, initializes threats,
 	// and places the Squadron in the inputed tile.
-	Squadron(Government* owner, void (*behaviour)(Squadron* squadron), CoordU loc);
+	// Squadrons are created through squadronStore.create, which assigns their handle.
+	Squadron(SquadronHandle handle, Government* owner, void (*behaviour)(Squadron* squadron), CoordU loc);
 
 	// Deconstructor for the squadron. Frees all allocated memory and removes the
 	// Squadron from the universe.
@@ -168,6 +175,487 @@ public:
 
 };
 
+// Squadrons are packed into SquadronSlabs, so any change to their size should be deliberate.
+static_assert(sizeof(Squadron) == 48 + sizeof(std::vector<Threat>), "Squadron is no longer 48 bytes plus its threats.");
+
+// Number of bits of a SquadronHandle which hold the Squadron's slot. The remaining bits hold
+// the generation of the slot.
+#define SQUADRON_SLOT_BITS 22
+#define SQUADRON_SLOT_MASK ((1 << SQUADRON_SLOT_BITS) - 1)
+
+// Number of generations a slot goes through before its generation wraps around to 1.
+#define SQUADRON_GENERATIONS (1 << (32 - SQUADRON_SLOT_BITS))
+
+// Number of Squadrons in each SquadronSlab, and the maximum number of SquadronSlabs.
+#define SQUADRON_SLAB_SHIFT 10
+#define SQUADRON_SLAB_SIZE (1 << SQUADRON_SLAB_SHIFT)
+#define MAX_SQUADRON_SLABS (1 << (SQUADRON_SLOT_BITS - SQUADRON_SLAB_SHIFT))
+
+/*
+Slab of Squadrons within the SquadronStore. Slabs are never moved or freed while the universe
+exists, so Squadrons never move.
+*/
+struct SquadronSlab {
+
+	// Current generation of each slot. Raised whenever the slot's Squadron is destroyed.
+	std::atomic<uint_least16_t> generations[SQUADRON_SLAB_SIZE];
+
+	// Next free slot after each free slot, or -1.
+	int nextFree[SQUADRON_SLAB_SIZE];
+
+	// Storage for the Squadrons themselves.
+	alignas(Squadron) unsigned char storage[SQUADRON_SLAB_SIZE * sizeof(Squadron)];
+
+	// Returns the Squadrons of this slab.
+	inline Squadron* squadrons() { return (Squadron*)storage; }
+
+};
+
+/*
+Slab allocated store of every Squadron. Replaces removedSquadrons, which every Squadron and Colony
+had to search against its Threats after any Squadron was deleted.
+
+Squadrons are referred to by 32 bit SquadronHandles, holding the Squadron's slot and the slot's
+generation when the Squadron was created. Destroying a Squadron raises its slot's generation, so
+every handle to it goes stale at once, and get detects stale handles in O(1). Generations start
+at 1 and skip 0 when wrapping, so 0 is never a valid handle.
+
+Slabs are found through a fixed table, so get never needs a lock. create and destroy lock mtx.
+*/
+class SquadronStore {
+public:
+
+	// Constructor. The store has no slabs until a Squadron is created.
+	SquadronStore() : slabs(), numSlabs(0), highWater(0), freeHead(-1) { }
+
+	// Frees every slab. Squadrons which are still live are not destructed.
+	void init();
+
+	// Creates a Squadron in a free slot. Returns nullptr if every slot is in use.
+	Squadron* create(Government* owner, void (*behaviour)(Squadron* squadron), CoordU loc);
+
+	// Destructs a Squadron and frees its slot, making every handle to it stale.
+	void destroy(Squadron* squadron);
+
+	// Returns the Squadron referred to by a handle, or nullptr if the handle is stale or 0.
+	inline Squadron* get(SquadronHandle handle);
+
+private:
+
+	// Table of slabs, and the number of slabs.
+	SquadronSlab* slabs[MAX_SQUADRON_SLABS];
+	int numSlabs;
+
+	// Number of slots which have been handed out at least once.
+	int highWater;
+
+	// First free slot, or -1 if every slot below highWater is in use.
+	int freeHead;
+
+	// Guards the slab table and free list.
+	std::mutex mtx;
+
+};
+
+// Store of every Squadron.
+SquadronStore squadronStore;
+
+/*
+Frees every slab. Squadrons which are still live are not destructed.
+It is expected that this function will be called once per universe and in a single-threaded manner.
+*/
+void SquadronStore::init() {
+	for (int i = 0; i < numSlabs; ++i) free(slabs[i]);
+	numSlabs = 0;
+	highWater = 0;
+	freeHead = -1;
+
+}
+
+/*
+Creates a Squadron in a free slot. Reuses freed slots before using new ones, and adds a slab
+when every slab is full.
+
+Returns nullptr if every slot is in use and no slab can be added, either because the slab table
+is full or because the slab could not be allocated. Slots beyond the table would not fit in the
+slot bits of a SquadronHandle.
+*/
+Squadron* SquadronStore::create(Government* owner, void (*behaviour)(Squadron* squadron), CoordU loc) {
+	SquadronSlab* slab;
+	int slot;
+
+	// Takes a free slot.
+	{
+		const std::lock_guard<std::mutex> lock(mtx);
+		if (freeHead >= 0) {
+			slot = freeHead;
+			freeHead = slabs[slot >> SQUADRON_SLAB_SHIFT]->nextFree[slot & (SQUADRON_SLAB_SIZE - 1)];
+
+		}
+		else {
+
+			// Adds a slab if every slab is full. Every slot starts at generation 1.
+			if (highWater == numSlabs * SQUADRON_SLAB_SIZE) {
+				if (numSlabs == MAX_SQUADRON_SLABS) return nullptr;
+				slab = (SquadronSlab*)malloc(sizeof(SquadronSlab));
+				if (slab == nullptr) return nullptr;
+				for (int i = 0; i < SQUADRON_SLAB_SIZE; ++i) slab->generations[i].store(1, std::memory_order_relaxed);
+				slabs[numSlabs++] = slab;
+
+			}
+			slot = highWater++;
+
+		}
+	}
+
+	// Constructs the Squadron with a handle for its slot's current generation.
+	slab = slabs[slot >> SQUADRON_SLAB_SHIFT];
+	int index = slot & (SQUADRON_SLAB_SIZE - 1);
+	SquadronHandle handle = (SquadronHandle)slab->generations[index].load(std::memory_order_relaxed) << SQUADRON_SLOT_BITS | slot;
+	return new (&slab->squadrons()[index]) Squadron(handle, owner, behaviour, loc);
+
+}
+
+/*
+Destructs a Squadron and frees its slot. Raises the slot's generation, so that every handle to
+the Squadron goes stale.
+
+Note: It is assumed that this function will be mutexed elsewhere, as deleting a Squadron was.
+*/
+void SquadronStore::destroy(Squadron* squadron) {
+	int slot = squadron->handle & SQUADRON_SLOT_MASK;
+	SquadronSlab* slab = slabs[slot >> SQUADRON_SLAB_SHIFT];
+	int index = slot & (SQUADRON_SLAB_SIZE - 1);
+	uint_least16_t generation = (uint_least16_t)(squadron->handle >> SQUADRON_SLOT_BITS) + 1;
+
+	// Destructs the Squadron.
+	squadron->~Squadron();
+
+	// Makes every handle to the Squadron stale.
+	if (generation == SQUADRON_GENERATIONS) generation = 1;
+	slab->generations[index].store(generation, std::memory_order_release);
+
+	// Returns the slot to the free list.
+	const std::lock_guard<std::mutex> lock(mtx);
+	slab->nextFree[index] = freeHead;
+	freeHead = slot;
+
+}
+
+/*
+Returns the Squadron referred to by a handle, or nullptr if the handle is stale or 0.
+*/
+inline Squadron* SquadronStore::get(SquadronHandle handle) {
+	if (!handle) return nullptr;
+	int slot = handle & SQUADRON_SLOT_MASK;
+	SquadronSlab* slab = slabs[slot >> SQUADRON_SLAB_SHIFT];
+	int index = slot & (SQUADRON_SLAB_SIZE - 1);
+	if (slab->generations[index].load(std::memory_order_acquire) != handle >> SQUADRON_SLOT_BITS) return nullptr;
+	return &slab->squadrons()[index];
+
+}
+
+// Width and height of each SquadronCell, in tiles.
+#define SQUADRON_CELL_SIZE 8
+
+/*
+Bucket of the SquadronGrid. Holds every Squadron within a SQUADRON_CELL_SIZE square of tiles.
+Squadrons are unordered, so removal swaps the last Squadron into the removed slot.
+*/
+struct SquadronCell {
+	Squadron** squadrons;
+	int numSquadrons;
+	int capacity;
+	std::mutex mtx;
+
+};
+
+// Uniform grid of SquadronCells covering the universe. Cells are stored by column, so that
+// cells within a vertical strip of the universe are adjacent.
+SquadronCell* squadronCells;
+int squadronGridWidth;
+int squadronGridHeight;
+
+/*
+Creates an empty SquadronGrid for a universe of the inputed size, freeing any previous grid.
+*/
+void initSquadronGrid(int width, int height) {
+
+	// Frees the previous grid.
+	if (squadronCells) {
+		for (int i = 0; i < squadronGridWidth * squadronGridHeight; ++i) free(squadronCells[i].squadrons);
+		delete[] squadronCells;
+
+	}
+
+	// Creates the new grid.
+	squadronGridWidth = (width + SQUADRON_CELL_SIZE - 1) / SQUADRON_CELL_SIZE;
+	squadronGridHeight = (height + SQUADRON_CELL_SIZE - 1) / SQUADRON_CELL_SIZE;
+	squadronCells = new SquadronCell[squadronGridWidth * squadronGridHeight]();
+
+}
+
+/*
+Returns the SquadronCell containing the inputed tile.
+*/
+inline SquadronCell& squadronCell(int x, int y) {
+	return squadronCells[(x / SQUADRON_CELL_SIZE) * squadronGridHeight + y / SQUADRON_CELL_SIZE];
+
+}
+
+/*
+Adds a Squadron to the SquadronCell containing loc.
+*/
+void addGridSquadron(Squadron* squadron, CoordU loc) {
+	SquadronCell& cell = squadronCell(loc.x, loc.y);
+	const std::lock_guard<std::mutex> lock(cell.mtx);
+
+	// Grows the cell if it is full.
+	if (cell.numSquadrons == cell.capacity) {
+		cell.capacity = cell.capacity ? cell.capacity * 2 : 4;
+		cell.squadrons = (Squadron**)realloc(cell.squadrons, sizeof(Squadron*) * cell.capacity);
+
+	}
+
+	// Places the Squadron.
+	cell.squadrons[cell.numSquadrons++] = squadron;
+
+}
+
+/*
+Removes a Squadron from the SquadronCell containing loc.
+*/
+void removeGridSquadron(Squadron* squadron, CoordU loc) {
+	SquadronCell& cell = squadronCell(loc.x, loc.y);
+	const std::lock_guard<std::mutex> lock(cell.mtx);
+
+	// Finds the Squadron, then replaces it with the last Squadron in the cell.
+	for (int i = 0; i < cell.numSquadrons; ++i) {
+		if (cell.squadrons[i] == squadron) {
+			cell.squadrons[i] = cell.squadrons[--cell.numSquadrons];
+			return;
+
+		}
+	}
+}
+
+/*
+Moves a Squadron between SquadronCells if it has left its cell. Only one cell is locked at a time,
+which is safe since the grid is not queried while Squadrons are moving.
+*/
+inline void moveGridSquadron(Squadron* squadron, CoordU from, CoordU to) {
+	if (&squadronCell(from.x, from.y) == &squadronCell(to.x, to.y)) return;
+	removeGridSquadron(squadron, from);
+	addGridSquadron(squadron, to);
+
+}
+
+/*
+Calls func on every Squadron not belonging to owner within range tiles (on both axes) of (x, y).
+Only the SquadronCells overlapping the range are searched. Must not be called while Squadrons
+are being moved.
+*/
+template <class F>
+void forHostileSquadrons(int x, int y, int range, Government* owner, F func) {
+	int cellXBeg = x - range < 0 ? 0 : (x - range) / SQUADRON_CELL_SIZE;
+	int cellYBeg = y - range < 0 ? 0 : (y - range) / SQUADRON_CELL_SIZE;
+	int cellXEnd = (x + range) / SQUADRON_CELL_SIZE;
+	int cellYEnd = (y + range) / SQUADRON_CELL_SIZE;
+	if (cellXEnd >= squadronGridWidth) cellXEnd = squadronGridWidth - 1;
+	if (cellYEnd >= squadronGridHeight) cellYEnd = squadronGridHeight - 1;
+
+	// Parses through each SquadronCell overlapping the range.
+	for (int i = cellXBeg; i <= cellXEnd; ++i) {
+		for (int j = cellYBeg; j <= cellYEnd; ++j) {
+			SquadronCell& cell = squadronCells[i * squadronGridHeight + j];
+
+			// Calls func on each hostile Squadron within range.
+			for (int s = 0; s < cell.numSquadrons; ++s) {
+				Squadron* squadron = cell.squadrons[s];
+				if (squadron->owner != owner && abs(squadron->loc.x - x) <= range && abs(squadron->loc.y - y) <= range)
+					func(squadron);
+
+			}
+		}
+	}
+}
+
+/*
+Entry of the SquadronRegistry. The upper 32 bits of key hold the chunk and tile of the Squadron
+(see squadronLocationKey), and the lower 32 bits hold the order in which it was registered.
+squadron is nullptr once the Squadron has been deleted.
+*/
+struct SquadronEntry {
+	uint64_t key;
+	Squadron* squadron;
+
+};
+
+/*
+Dense registry of every live Squadron, so that the space phase iterates Squadrons rather than tiles.
+
+Entries are sorted by key, i.e. in the order in which the universe is stored, then by the order
+in which the Squadrons were registered. The order depends only on where each Squadron is, so
+it is the same from run to run. Squadron::move keeps the key of its entry up to date, and the
+destructor clears its entry. New Squadrons wait in pending until the registry is next synced,
+so that entries never move while Squadrons are acting.
+*/
+struct SquadronRegistry {
+	SquadronEntry* entries;
+	int numEntries;
+	int capacity;
+	Squadron** pending;
+	int numPending;
+	int pendingCapacity;
+	uint32_t nextSerial;
+	std::mutex mtx;
+
+};
+
+// Registry of every live Squadron.
+SquadronRegistry squadronRegistry;
+
+/*
+Returns the upper 32 bits of a SquadronEntry key for a Squadron at loc. Chunks fit within
+22 bits, since the universe is at most 65536 tiles wide, and tiles within a chunk fit within 10.
+*/
+inline uint64_t squadronLocationKey(CoordU loc) {
+	return (uint64_t)universe.chunkOf(loc.x, loc.y) << 42 | (uint64_t)UniverseGrid::offset(loc.x, loc.y) << 32;
+
+}
+
+/*
+Adds a newly created Squadron to the pending Squadrons of the SquadronRegistry.
+*/
+void registerSquadron(Squadron* squadron) {
+	const std::lock_guard<std::mutex> lock(squadronRegistry.mtx);
+
+	// Grows pending if it is full.
+	if (squadronRegistry.numPending == squadronRegistry.pendingCapacity) {
+		squadronRegistry.pendingCapacity = squadronRegistry.pendingCapacity ? squadronRegistry.pendingCapacity * 2 : 16;
+		squadronRegistry.pending = (Squadron**)realloc(squadronRegistry.pending, sizeof(Squadron*) * squadronRegistry.pendingCapacity);
+
+	}
+
+	// Places the Squadron.
+	squadron->registryIndex = -1;
+	squadronRegistry.pending[squadronRegistry.numPending++] = squadron;
+
+}
+
+/*
+Removes a Squadron from the SquadronRegistry. Synced Squadrons only clear their own entry,
+which is dropped on the next sync.
+*/
+void unregisterSquadron(Squadron* squadron) {
+
+	// Clears the Squadron's entry.
+	if (squadron->registryIndex >= 0) {
+		squadronRegistry.entries[squadron->registryIndex].squadron = nullptr;
+		return;
+
+	}
+
+	// Finds the Squadron in pending, then replaces it with the last pending Squadron.
+	const std::lock_guard<std::mutex> lock(squadronRegistry.mtx);
+	for (int i = 0; i < squadronRegistry.numPending; ++i) {
+		if (squadronRegistry.pending[i] == squadron) {
+			squadronRegistry.pending[i] = squadronRegistry.pending[--squadronRegistry.numPending];
+			return;
+
+		}
+	}
+}
+
+/*
+Updates the key of a Squadron's entry after it has moved. Only the Squadron's own entry is written,
+so Squadrons may move concurrently.
+*/
+inline void moveRegistrySquadron(Squadron* squadron) {
+	if (squadron->registryIndex < 0) return;
+	SquadronEntry& entry = squadronRegistry.entries[squadron->registryIndex];
+	entry.key = squadronLocationKey(squadron->loc) | (entry.key & 0xFFFFFFFF);
+
+}
+
+/*
+Brings the SquadronRegistry up to date. Drops the entries of deleted Squadrons, appends the
+pending Squadrons, then sorts every entry by key. Pending Squadrons are ordered by location and
+then by owner before being numbered, since they may have been created in any order by several
+threads.
+
+Must only be called while no Squadron is being created, moved or deleted.
+*/
+void syncSquadronRegistry() {
+	extern PagedPool<Government> governmentPool;
+	SquadronRegistry& registry = squadronRegistry;
+	int numLive = 0;
+
+	// Drops the entries of deleted Squadrons.
+	for (int i = 0; i < registry.numEntries; ++i) {
+		if (registry.entries[i].squadron) registry.entries[numLive++] = registry.entries[i];
+
+	}
+	registry.numEntries = numLive;
+
+	// Orders the pending Squadrons.
+	std::sort(registry.pending, registry.pending + registry.numPending, [](Squadron* a, Squadron* b) {
+		uint64_t aKey = squadronLocationKey(a->loc), bKey = squadronLocationKey(b->loc);
+		if (aKey != bKey) return aKey < bKey;
+		return governmentPool.indexOf(a->owner) < governmentPool.indexOf(b->owner);
+
+	});
+
+	// Grows the entries if the pending Squadrons do not fit.
+	if (registry.numEntries + registry.numPending > registry.capacity) {
+		while (registry.numEntries + registry.numPending > registry.capacity) registry.capacity = registry.capacity ? registry.capacity * 2 : 64;
+		registry.entries = (SquadronEntry*)realloc(registry.entries, sizeof(SquadronEntry) * registry.capacity);
+
+	}
+
+	// Appends the pending Squadrons. They are numbered after every existing Squadron, so they
+	// follow any Squadrons in the same tile.
+	for (int i = 0; i < registry.numPending; ++i) {
+		Squadron* squadron = registry.pending[i];
+		registry.entries[registry.numEntries++] = { squadronLocationKey(squadron->loc) | registry.nextSerial++, squadron };
+
+	}
+	registry.numPending = 0;
+
+	// Sorts the entries, since Squadrons may have moved. Keys are unique, so the order is deterministic.
+	std::sort(registry.entries, registry.entries + registry.numEntries,
+		[](const SquadronEntry& a, const SquadronEntry& b) { return a.key < b.key; });
+
+	// Reassigns the index of each Squadron.
+	for (int i = 0; i < registry.numEntries; ++i) registry.entries[i].squadron->registryIndex = i;
+
+}
+
+/*
+Destroys every synced Squadron which has been left without strength. Squadrons defeated during the
+space phase are only marked by their strength, since another thread may still be about to act on
+them, and are destroyed here once every Squadron has acted.
+
+Must only be called while no Squadron is acting.
+*/
+void destroyDefeatedSquadrons() {
+	for (int i = 0; i < squadronRegistry.numEntries; ++i) {
+		Squadron* squadron = squadronRegistry.entries[i].squadron;
+		if (squadron && !squadron->strength) squadronStore.destroy(squadron);
+
+	}
+}
+
+/*
+Empties the SquadronRegistry. Called along with initSquadronGrid when a new universe is created.
+*/
+void clearSquadronRegistry() {
+	squadronRegistry.numEntries = 0;
+	squadronRegistry.numPending = 0;
+	squadronRegistry.nextSerial = 0;
+
+}
+
 /*
 Estimates the strength of a certain number of ships of a Ship Template.
 
@@ -221,10 +709,12 @@ uint_least16_t estimateSquadronStrength(Squadron* squadron) {
 Constructor for the Squadron. Assigns inputed values, initializes threats,
 and places the Squadron in the inputed tile.
 */
-Squadron::Squadron(Government* owner, void (*behaviour)(Squadron* squadron), CoordU loc) :
-	owner(owner), loc(loc), behaviour(behaviour), data(nullptr), numShips(0), strength(0) {
+Squadron::Squadron(SquadronHandle handle, Government* owner, void (*behaviour)(Squadron* squadron), CoordU loc) :
+	owner(owner), loc(loc), behaviour(behaviour), data(nullptr), ships(nullptr), numShips(0), strength(0), handle(handle) {
 	threats = std::vector<Threat>();
-	uIndex(loc.x, loc.y).addSquadron(this);
+	addUniverseSquadron(loc.x, loc.y, this);
+	addGridSquadron(this, loc);
+	registerSquadron(this);
 
 }
 
@@ -232,16 +722,17 @@ Squadron::Squadron(Government* owner, void (*behaviour)(Squadron* squadron), Coo
 Deconstructor for the squadron. Frees all allocated memory and removes the
 Squadron from the universe.
 
-Note: It is assumed that this function will be mutexed elsewhere.
+Threats to the Squadron are not searched for. They hold its handle, which goes stale once
+squadronStore.destroy frees its slot.
 
-TODO make threat removal use a maximum range, or otherwise make it more efficient.
+Note: It is assumed that this function will be mutexed elsewhere.
 */
 Squadron::~Squadron() {
-	uIndex(loc.x, loc.y).removeSquadron(this);
+	removeUniverseSquadron(loc.x, loc.y, this);
+	removeGridSquadron(this, loc);
+	unregisterSquadron(this);
 	if (data) free(data);
 	free(ships);
-	extern void prepareRemovedSquadron(Squadron*);
-	prepareRemovedSquadron(this);
 
 }
 
@@ -287,10 +778,18 @@ void Squadron::reassignStrength() {
 }
 
 /*
-Performs the behaviour associated with this squadron.
+Performs the behaviour associated with this squadron. Defeated Squadrons do nothing. Strength is
+only lowered under the tile's lock, so it is read under the lock as well.
 */
 inline void Squadron::action() {
-	behaviour(this);
+	bool defeated;
+
+	// Checks whether the Squadron was defeated earlier in the phase.
+	uLock(loc.x, loc.y);
+	defeated = !strength;
+	uUnlock(loc.x, loc.y);
+
+	if (!defeated) behaviour(this);
 
 }
 
@@ -313,10 +812,12 @@ inline void Squadron::move(uint_least16_t xPos, uint_least16_t yPos) {
 	}
 
 	// Moves the Squadron from its current tile to its desired tile.
-	uIndex(loc.x, loc.y).removeSquadron(this);
-	uIndex(xPos, yPos).addSquadron(this);
+	removeUniverseSquadron(loc.x, loc.y, this);
+	addUniverseSquadron(xPos, yPos, this);
+	moveGridSquadron(this, loc, {xPos, yPos});
 	this->loc.x = xPos;
 	this->loc.y = yPos;
+	moveRegistrySquadron(this);
 
 	// Unlocks the mutex for this tile.
 	if (lock) uUnlock(xPos, yPos);
@@ -395,123 +896,31 @@ path[pathLength] is actually the final tile, since path[0] contains metadata.
 Note: Whatever is in data will be destroyed when this function is called.
 Note: This will set data as nullptr in case of failure.
 
-TODO this should eventually use links between systems as a small hack.
+Paths are found over the PathGraph, so long paths may follow trade lanes between Systems.
 */
 void Squadron::squadronPath(int xDest, int yDest) {
-	LinkedListNode<PathCoordinate>* currPos = nullptr;
-	LinkedListNode<PathCoordinate>* startPos = nullptr;
-	LinkedListNode<PathCoordinate>* coord;
 	CoordU* path;
-	int xPos, yPos;
-	int length = 0;
-
-	// Uses a map to mark down explored tiles.
-	uint_least8_t* exploredMap = requestDummy();
-	memset(exploredMap, 0, sizeof(uint_least8_t) * universeWidth * universeHeight);
-
-	// Requests a coordList for this function.
-	LinkedList<PathCoordinate>* coordList = requestCoordList();
-
-	// Creates a LinkedList for storing the frontier.
-	LinkedList<PathCoordinate> frontier = LinkedList<PathCoordinate>();
-
-	// Creates a LinkedList for storing explored.
-	LinkedList<PathCoordinate> explored = LinkedList<PathCoordinate>();
-
-	// Adds the initial tile to the frontier.
-	coord = coordList->popc();
-	coord->value->coord.x = loc.x;
-	coord->value->coord.y = loc.y;
-	coord->value->gValue = 0;
-	coord->value->hValue = calcTaxiDistance(loc.x, loc.y, xDest, yDest);
-	coord->previous = nullptr;
-	frontier.addc(coord);
-	exploredMap[index(loc.x, loc.y, universeWidth)] = true;
-
-	// Pathfinds until the desired coordinate is found.
-	while (!frontier.isEmpty()) {
-
-		// Starts exploring the node.
-		currPos = frontier.popc();
-		explored.addc(currPos);
-
-		// Marks this tile explored.
-		exploredMap[index(currPos->value->coord.x, currPos->value->coord.y, universeWidth)] = true;
-
-		// If currPos meets the inputed criteria, stops looping.
-		if (currPos->value->coord.x == xDest && currPos->value->coord.y == yDest) break;
-
-		// Explores each coordinate adjacent to currPos.
-		for (int i = -1; i < 2; ++i) {
-			for (int j = -1; j < 2; ++j) {
-				if (!i && !j) continue;
-				xPos = currPos->value->coord.x + i;
-				yPos = currPos->value->coord.y + j;
-				if (!universeInBounds(xPos, yPos)) continue;
-
-				// Places the coord if it has not been explored.
-				if (!exploredMap[index(xPos, yPos, universeWidth)]) {
-
-					// Adds the coord to the frontier.
-					coord = coordList->popc();
-					coord->value->coord.x = xPos;
-					coord->value->coord.y = yPos;
-					coord->value->gValue = currPos->value->gValue + 1;
-					coord->value->hValue = calcTaxiDistance(xPos, yPos, xDest, yDest);
-					coord->previous = currPos;
-					frontier.addcAsc(coord);
-
-				}
-			}
-		}
-	}
 
-	// Returns all values to the coordList.
-	while (!frontier.isEmpty()) coordList->addc(frontier.popc());
-	while (!explored.isEmpty()) coordList->addc(explored.popc());
+	// Finds the path's tiles in scratch space.
+	ScratchScope scratch;
+	ScratchVector<CoordU> tiles;
 
-	// If currPos does not contain the desired value, releases held resources
-	// and returns.
-	if (currPos->value->coord.x != xDest && currPos->value->coord.y != yDest) {
+	// If there is no path, releases data and returns.
+	if (!findUniversePath(loc, { (uint_least16_t)xDest, (uint_least16_t)yDest }, tiles)) {
 		if (data) free(data);
 		data = nullptr;
-		releaseCoordList(coordList);
-		releaseDummy(exploredMap);
 		return;
 
 	}
 
-	// Stores the starting position to allow multiple iterations along the path.
-	startPos = currPos;
-
-	// Calculates the path's length.
-	while (currPos) {
-		currPos = currPos->previous;
-		++length;
-
-	}
-	currPos = startPos;
-
 	// Allocates data.
 	if (data) free(data);
-	data = calloc(1, sizeof(CoordU) * (length + 1) + 8);
+	data = calloc(1, sizeof(CoordU) * (tiles.size() + 1) + 8);
 	path = getPath();
 
-	// Places the path's length.
-	path[0].y = length;
-	
-	// Places the path.
-	while (currPos) {
-		path[length].x = currPos->value->coord.x;
-		path[length].y = currPos->value->coord.y;
-		currPos = currPos->previous;
-		--length;
-
-	}
-
-	// Returns held resources.
-	releaseCoordList(coordList);
-	releaseDummy(exploredMap);
+	// Places the path's length, then the path.
+	path[0].y = tiles.size();
+	memcpy(path + 1, tiles.items, sizeof(CoordU) * tiles.size());
 
 }
 
@@ -561,55 +970,6 @@ inline bool Squadron::scan(CoordU dest) {
 
 }
 
-// Vector which stores removed Squadrons.
-std::vector<Squadron*> removedSquadrons = std::vector<Squadron*>();
-
-/*
-Below is a pair of functions used to track Squadrons which need to be removed from Threats.
-*/
-
-/*
-Marks that a reference to a Squadron should be removed from Threats.
-Note that by the time this is called, the Squadron will already have been deleted.
-*/
-void prepareRemovedSquadron(Squadron* squadron) {
-	static std::shared_mutex removeSquadronMutex;
-
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex> lock(removeSquadronMutex);
-
-	// Adds the inputed Squadron to the list of removed Squadrons.
-	removedSquadrons.push_back(squadron);
-
-}
-
-/*
-Removes all deleted Squadrons as Threats to the inputed Squadron.
-*/
-void removeDeletedSquadrons(Squadron* squadron) {
-	for (Squadron* remove : removedSquadrons)
-		squadron->removeThreat(remove);
-
-}
-
-/*
-Removes all deleted Squadrons as Threats to the inputed Colony.
-*/
-void removeDeletedSquadrons(Colony* colony) {
-	for (Squadron* remove : removedSquadrons)
-		colony->removeThreat(remove);
-
-}
-
-/*
-Removes all Squadrons from removedSquadrons.
-This should be called by the gameplay thread after SpaceBattles is finished.
-*/
-void emptyRemovedSquadrons() {
-	removedSquadrons.clear();
-
-}
-
 /*
 Below is an assortment of various useful helper functions relating to Squadrons.
 */
@@ -657,7 +1017,10 @@ void shipAttack(Ship& attacker, Ship& defender) {
 Performs battle between two Squadrons.
 
 Ships with higher range attack first. When range is equal, defenders are
-prioritized.
+prioritized. Squadrons left without strength are not destroyed here, since other threads may
+still act on them; destroyDefeatedSquadrons destroys them once the phase is over.
+
+Note: Assumes that the tile of both Squadrons is already locked.
 
 TODO make ships choose better targets.
 */
@@ -721,14 +1084,10 @@ void squadronAttack(Squadron* attacker, Squadron* defender) {
 		}
 	}
 
-	// Recalculates Squadron strength.
+	// Recalculates Squadron strength. Empty Squadrons are left with no strength.
 	attacker->reassignStrength();
 	defender->reassignStrength();
 
-	// Deletes either Squadron if they are empty.
-	if (!attacker->strength) delete attacker;
-	if (!defender->strength) delete defender;
-
 }
 
 /*
@@ -740,7 +1099,7 @@ Returns the first Squadron found which belongs to the inputed Government.
 inline Squadron* universeContainsOwnedSquadron(int xPos, int yPos, Government* government) {
 
 	// Attempts to find a Squadron owned by the inputed Government.
-	for (int i = 0; i < uIndex(xPos, yPos).numSquadrons; ++i) {
+	for (int i = 0; i < uNumSquadrons(xPos, yPos); ++i) {
 		if (uSquadron(xPos, yPos, i)->owner == government) {
 			return uSquadron(xPos, yPos, i);
 
@@ -766,7 +1125,7 @@ bool universeContainsEnemy(int xPos, int yPos, Government* government) {
 
 	// Checks to see if any squadron in the tile is owned by an enemy.
 	// TODO implement diplomacy check
-	for (int i = 0; i < uIndex(xPos, yPos).numSquadrons; ++i) {
+	for (int i = 0; i < uNumSquadrons(xPos, yPos); ++i) {
 		// if (uSquadron(xPos, yPos, i).owner is enemy to government) return true;
 
 	}
@@ -782,7 +1141,7 @@ Determines whether the inputed tile contains the inputed enemy Squadron.
 inline bool universeContainsSquadron(int xPos, int yPos, Squadron* squadron) {
 
 	// Returns true if the Squadron is found.
-	for (int i = 0; i < uIndex(xPos, yPos).numSquadrons; ++i)
+	for (int i = 0; i < uNumSquadrons(xPos, yPos); ++i)
 		if (uSquadron(xPos, yPos, i) == squadron) return true;
 	
 	// Returns false if the Squadron is not found.
@@ -886,7 +1245,8 @@ void squadronGuard(Squadron* squadron) {
 		// Attempts to pursue the nearest threat if a valid one was found.
 		if (min != 65536) {
 			squadron->squadronPath(squadron->threats[minIndex].coord.x, squadron->threats[minIndex].coord.y);
-			*((Squadron**)squadron->data) = squadron->threats[minIndex].squadron;
+			if (!squadron->data) return;
+			*((SquadronHandle*)squadron->data) = squadron->threats[minIndex].squadron;
 			squadron->behaviour = squadronPursue;
 
 		}
@@ -899,13 +1259,13 @@ This Squadron will pursue a given Threat.
 TODO implement an invalid behavior other than guarding.
 */
 void squadronPursue(Squadron* squadron) {
-	Squadron* enemy = *((Squadron**)squadron->data);
+	SquadronHandle handle = *((SquadronHandle*)squadron->data);
+	Squadron* enemy;
 	std::vector<Threat>::iterator threat;
 	int xPos, yPos;
 	bool valid;
 
 	// Locks the tile.
-	// TODO possible error: wait on lock, destroyed elsewhere, unlock, continue with invalid Squadron.
 	uLock(squadron->loc.x, squadron->loc.y);
 
 	// Stores xPos and yPos so the correct mutex is unlocked after movement.
@@ -913,10 +1273,12 @@ void squadronPursue(Squadron* squadron) {
 	yPos = squadron->loc.y;
 
 	// Determines whether the Threat being pursued still exists and is still
-	// tracked by the Squadron.
+	// tracked by the Squadron. The enemy is looked up after locking, so a stale handle
+	// is caught even if the enemy was destroyed while waiting on the lock.
 	// Note: threat is assigned here if and only if the enemy is valid.
-	valid = enemy->strength && (threat = std::find_if(squadron->threats.begin(),
-		squadron->threats.end(), [enemy](Threat threat) { return threat.squadron == enemy; }))
+	enemy = squadronStore.get(handle);
+	valid = squadron->strength && enemy && enemy->strength && (threat = std::find_if(squadron->threats.begin(),
+		squadron->threats.end(), [handle](Threat threat) { return threat.squadron == handle; }))
 		!= squadron->threats.end();
 
 	// If the threat is no longer valid, finds a new action and returns.
@@ -942,7 +1304,13 @@ void squadronPursue(Squadron* squadron) {
 	// following the threat.
 	if ((*threat).coord != squadron->getDest()) {
 		squadron->squadronPath((*threat).coord.x, (*threat).coord.y);
-		*((Squadron**)squadron->data) = enemy;
+		if (!squadron->data) {
+			squadron->behaviour = squadronGuard;
+			uUnlock(xPos, yPos);
+			return;
+
+		}
+		*((SquadronHandle*)squadron->data) = handle;
 
 	}
 
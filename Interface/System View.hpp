@@ -353,7 +353,7 @@ System* findNextCol() {
 		// If possible, finds a system with a colony.
 		for (; i < universeWidth; ++i) {
 			for (; j < universeHeight; ++j) {
-				if (uIndex(i, j).getTileID() == SYSTEM_TILE) {
+				if (uTileID(i, j) == SYSTEM_TILE) {
 					activeSystem = uSystem(i, j);
 					for (int p = 0; p < activeSystem->numHabitable; ++p) {
 						if (activeSystem->planets[p]->owners[1].colony != nullptr) {
@@ -1,5 +1,8 @@
 #pragma once
 
+// Universes whose Galaxies cover less than 1 / SPARSE_UNIVERSE_RATIO of their area are stored sparsely.
+#define SPARSE_UNIVERSE_RATIO 2
+
 /*
 Enum containing instructions for galaxy generation.
 */
@@ -40,6 +43,12 @@ void copyUniverseCanvas(int** sourceCanvas, int** copyCanvas, int size);
 // Copies a dummy universe to the universe.
 void universeToSpace(int** dummyGalaxy, int width, int height);
 
+// Allocates an empty universe.
+void initUniverse(int width, int height, bool sparse);
+
+// Sets a tile of a newly allocated universe.
+void placeUniverseTile(int x, int y, int tileID, System* system);
+
 // Creates arms for a galaxy.
 void createArms(int** dummyGalaxy, int** canvas, int width, int center, int armSize, int numArms, double slope);
 
@@ -159,17 +168,15 @@ void generateUniverse(int uniWidth, int uniHeight, int numGalaxies, int minDista
 	delete[] galaxies;
 	galaxies = tempGalaxies;
 
-	// Creates the global dummies in Multithreading.hpp to be used later. Dummies are treated as being square.
-	// TODO allow dummySize to account for barrens.
-	int dummySize = universeWidth >= universeHeight ? universeWidth + 2 : universeHeight + 2;
-	for (int i = 0; i < numGals; ++i) if (dummySize < tempInstrs[i].planetSize + 2) dummySize = tempInstrs[i].planetSize + 2;
-	initDummies(dummySize * dummySize);
-
-	// Creates the global large dummies in Multithreading.hpp to be used later. Dummies are treated as being square.
-	// TODO allow dummySize to account for barrens.
-	dummySize = 0;
-	for (int i = 0; i < numGals; ++i) if (dummySize < tempInstrs[i].planetSize + 2) dummySize = tempInstrs[i].planetSize + 2;
-	initLargeDummies(dummySize * dummySize);
+	// Reserves scratch space for each thread. It should hold a copy of the universe, or a byte for each
+	// tile of the largest planet as used by the battlefield's per-tile arrays, whichever's larger.
+	// Arenas grow past this when needed and keep the extra space from then on.
+	// TODO allow scratchSize to account for barrens.
+	int scratchSize = universeWidth >= universeHeight ? universeWidth + 2 : universeHeight + 2;
+	scratchSize *= scratchSize;
+	for (int i = 0; i < numGals; ++i) if (scratchSize < (tempInstrs[i].planetSize + 2) * (tempInstrs[i].planetSize + 2))
+		scratchSize = (tempInstrs[i].planetSize + 2) * (tempInstrs[i].planetSize + 2);
+	initScratch(scratchSize);
 
 	// Sets all Galaxies as available.
 	releaseAllGalaxies();
@@ -196,6 +203,9 @@ void generateUniverse(int uniWidth, int uniHeight, int numGalaxies, int minDista
 	// Generates the systems of the universe.
 	beginGenerateSystems(galaxies, tempInstrs);
 
+	// Builds the PathGraph over the universe and its trade lanes.
+	initPathGraph();
+
 	// Generates the empires of the universe.
 	generateEmpiresUniverse(galaxies, tempInstrs, numGals);
 
@@ -538,15 +548,12 @@ Deallocates the universe.
 void deallocateUniverse(int width, int height) {
 
 	// Will not act if there is no universe.
-	if (universe == nullptr) return;
+	if (universe.blocks == nullptr) return;
 
 	// Duct-tape solution for deleting SystemSpaceTiles.
 	// Counts SystemSpaceTiles.
 	int numSystems = 0;
-	for (int i = 0; i < width; ++i)
-		for (int j = 0; j < height; ++j)
-			if (universe[index(i, j, width)].tileID == SYSTEM_TILE)
-				++numSystems;
+	for (int c = 0; c < universe.chunksWide * universe.chunksHigh; ++c) numSystems += universe.chunks[c].numSystems;
 
 	// Deletes planets and barrens for SystemSpaceTile.
 	for (int i = 0; i < numSystems; ++i) {
@@ -558,7 +565,7 @@ void deallocateUniverse(int width, int height) {
 	// Deletes the galaxy data.
 	delete[] galaxies;
 	free(allSystemSpace);
-	delete[] universe;
+	universe.deallocate();
 
 }
 
@@ -591,11 +598,13 @@ void copyUniverseCanvas(int** sourceCanvas, int** copyCanvas, int size) {
 }
 
 /*
-Copies a dummy universe to the universe.
+Copies a dummy universe to the universe. The universe is stored sparsely if its Galaxies
+cover a small part of it, in which case only chunks overlapping a Galaxy are allocated.
 */
 void universeToSpace(int** dummySpace, int width, int height) {
 	int numSystems = 0;
 	int currSystem = 0;
+	long long galaxyArea = 0;
 
 	// Counts the number of Systems and converts all empty tiles to ThinSpaceTiles.
 	for (int i = 0; i < width; ++i) {
@@ -609,24 +618,73 @@ void universeToSpace(int** dummySpace, int width, int height) {
 	// Initializes the array of Systems.
 	allSystemSpace = (System*)calloc(numSystems, sizeof(System));
 
-	// Initializes the universe.
-	universe = (GalaxyTile*)calloc(width * height, sizeof(GalaxyTile));
+	// Initializes the universe. Its storage depends on how much of it is covered by Galaxies.
+	for (int g = 0; g < numGals; ++g) galaxyArea += (long long)galaxies[g].area.w * galaxies[g].area.h;
+	initUniverse(width, height, galaxyArea * SPARSE_UNIVERSE_RATIO < (long long)width * height);
 
-	// Initializes the universeMutexes.
-	universeMutexes = new std::shared_mutex[width > height ? width : height];
+	// Allocates the chunks of a sparse universe which overlap a Galaxy.
+	for (int g = 0; universe.sparse && g < numGals; ++g) {
+		SDL_Rect area = galaxies[g].area;
+		for (int x = area.x & ~(UNIVERSE_CHUNK_SIZE - 1); x < area.x + area.w; x += UNIVERSE_CHUNK_SIZE)
+			for (int y = area.y & ~(UNIVERSE_CHUNK_SIZE - 1); y < area.y + area.h; y += UNIVERSE_CHUNK_SIZE)
+				universe.touch(x, y);
+
+	}
 
 	// Copies each dummySpace tile to the universe.
 	for (int i = 0; i < width; ++i) {
 		for (int j = 0; j < height; ++j) {
-			uIndex(i, j).tileID = dummySpace[i][j];
-
-			// Adds a system if necessary.
-			if (dummySpace[i][j] == SYSTEM_TILE) uSystem(i, j) = &allSystemSpace[currSystem++];
+			placeUniverseTile(i, j, dummySpace[i][j], dummySpace[i][j] == SYSTEM_TILE ? &allSystemSpace[currSystem++] : nullptr);
 
 		}
 	}
 }
 
+/*
+Allocates an empty universe of unowned thin space, along with the universeMutexes and the
+SquadronGrid, and empties the SquadronRegistry and SquadronStore. A sparse universe allocates chunks as they are written to.
+*/
+void initUniverse(int width, int height, bool sparse) {
+
+	// Initializes the universe.
+	universe.allocate(width, height, sparse);
+
+	// Initializes the universeMutexes, freeing those of any previous universe.
+	delete[] universeMutexes;
+	universeMutexes = new std::shared_mutex[width > height ? width : height];
+
+	// Initializes the SquadronGrid, and empties the SquadronRegistry and SquadronStore.
+	initSquadronGrid(width, height);
+	clearSquadronRegistry();
+	squadronStore.init();
+
+}
+
+/*
+Sets the tileID of a tile in a newly allocated universe. SYSTEM_TILEs are given the inputed
+System, which is told its location, and counted towards their chunk. Thin space is left as is, so that a sparse universe
+only allocates chunks which contain something.
+*/
+void placeUniverseTile(int x, int y, int tileID, System* system) {
+	UniverseBlock* block;
+	int tile = UniverseGrid::offset(x, y);
+
+	// Every tile starts as thin space.
+	if (tileID == THIN_SPACE_TILE) return;
+
+	// Places the tile.
+	block = universe.touch(x, y);
+	block->tileIDs[tile] = tileID;
+
+	// Adds a system if necessary, and counts it towards its chunk.
+	if (tileID == SYSTEM_TILE) {
+		block->systems[tile] = system;
+		system->loc = { (uint_least16_t)x, (uint_least16_t)y };
+		++uChunk(x, y).numSystems;
+
+	}
+}
+
 /*
 Creates an n-armed galaxy. Does so by creating a template arm based on the inputed parameters,
 then copying and rotating it 2pi/n radians to create a regular n-armed star.
@@ -973,7 +1031,7 @@ void assignSystemPlanetCounts(Galaxy* galaxies, GalaxyInstruction* galInstrs, in
 		// Places the Habitables and Barrens within this galaxy.
 		for (int w = galaxies[i].area.x; w < galaxies[i].area.x + galaxies[i].area.w; ++w) {
 			for (int h = galaxies[i].area.y; h < galaxies[i].area.y + galaxies[i].area.h; ++h) {
-				if (uIndex(w, h).tileID == SYSTEM_TILE) {
+				if (uTileID(w, h) == SYSTEM_TILE) {
 					currSystem = uSystem(w, h);
 					currSystem->loc = { (uint_least16_t)w, (uint_least16_t)h };
 					currSystem->initHabitable(randB(8) % galInstrs[i].numHabitable + MIN_HABITABLE);
@@ -1003,7 +1061,7 @@ void placeAllPlanets(Galaxy* galaxies, GalaxyInstruction* galInstrs) {
 		// Places the Habitables and Barrens within this galaxy.
 		for (int w = galaxies[i].area.x; w < galaxies[i].area.x + galaxies[i].area.w; ++w) {
 			for (int h = galaxies[i].area.y; h < galaxies[i].area.y + galaxies[i].area.h; ++h) {
-				if (uIndex(w, h).tileID == SYSTEM_TILE) {
+				if (uTileID(w, h) == SYSTEM_TILE) {
 					currSystem = uSystem(w, h);
 
 					// Places and initializes the size of each planet.
@@ -1032,53 +1090,34 @@ void placeAllPlanets(Galaxy* galaxies, GalaxyInstruction* galInstrs) {
 	placePlanetTiles(numTiles + 1, true);
 
 	// Places the PlanetTiles for each planet.
-	for (int i = 0; i < numHabitablePages; ++i) {
-		for (int j = 0; j < habitablePages[i]->arrCurrPlanet; ++j) {
-			habitablePages[i]->planets[j].planet = placePlanetTiles(habitablePages[i]->planets[j].size * 
-				habitablePages[i]->planets[j].size, false);
+	habitablePool.forEach([](HabitablePlanet* planet) {
+		planet->planet = placePlanetTiles(planet->size * planet->size, false);
 
-		}
-	}
+	});
 }
 
-/*
-Finds a system for generation by the calling thread. Uses universeX and universeY to store position.
-Returns a SystemSpaceTile upon success, otherwise nullptr.
-*/
-System* requestSystemToGenerate() {
-	static std::shared_mutex requestSystemToGenerateMutex;
-
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex> lock(requestSystemToGenerateMutex);
-	
-	// Searches through each tile in the galaxy until the next system is found.
-	for (; universeX < universeWidth; ++universeX) {
-		if (universeY >= universeHeight) universeY = 0;
-		for (;  universeY < universeHeight; ++universeY) {
-			if (uIndex(universeX, universeY).tileID == SYSTEM_TILE) {
-				++universeY;
-				return uSystem(universeX, universeY - 1);
-
-			}
-		}
-	}
-
-	// If no tile was found, returns nullptr.
-	return nullptr;
-
-}
+// Dispatches universe columns to the threads generating systems.
+DispatchCursor systemColumnCursor;
 
 /*
-Generates systems in a threaded manner.
+Generates systems in a threaded manner. Each thread claims whole columns of the universe
+and generates every system within them.
 */
 void generateSystems(int** dummyPlanet, int** moistureDummy, int** heatDummy, int** riverDummy,
 	int** buildingDummy, int** canvas) {
-	System* system;
 
-	// Generates systems.
-	while (system = requestSystemToGenerate())
-		generateSystem(system, dummyPlanet, moistureDummy, heatDummy, riverDummy, buildingDummy, canvas);
+	// Generates the systems in each claimed column.
+	for (int x = systemColumnCursor.claim(); x >= 0; x = systemColumnCursor.claim()) {
+		for (int y = 0; y < universeHeight; ++y) {
+			if (uTileID(x, y) != SYSTEM_TILE) continue;
+
+			// Seeds the calling thread with the system's own stream, so that the system is the
+			// same whichever thread generates it.
+			seedRandomStream(randomStream(SYSTEM_STREAM, x, y));
+			generateSystem(uSystem(x, y), dummyPlanet, moistureDummy, heatDummy, riverDummy, buildingDummy, canvas);
 
+		}
+	}
 }
 
 /*
@@ -1103,46 +1142,41 @@ void beginGenerateSystems(Galaxy* galaxies, GalaxyInstruction* galInstrs) {
 	// Assigns the number of HabitablePlanets and BarrenPlanets into the SystemSpaceTiles of each Galaxy.
 	assignSystemPlanetCounts(galaxies, galInstrs, neededHab, neededBarr);
 
-	// Initializes habitablePages and barrenPages.
+	// Initializes the habitablePool and barrenPool.
 	initHabitablePlanets(neededHab);
 	initBarrenPlanets(neededBarr);
 
 	// Places HabitablePlanets and BarrenPlanets into each SystemSpaceTile in each Galaxy.
 	placeAllPlanets(galaxies, galInstrs);
 
-	// Sets universeX and universeY to 0 for system generation.
-	universeX = 0;
-	universeY = 0;
+	// Starts dispatching universe columns for system generation.
+	systemColumnCursor.reset(universeWidth);
 
-	// Uses each thread to generate systems.
-	for (int i = 0; i < numThreads - 1; ++i) threads[demandThread()] = new std::thread(generateSystems,
-		dummyPlanets[i], moistureDummies[i], heatDummies[i], riverDummies[i], buildingDummies[i],
-		canvases[i]);
+	// Uses each thread to generate systems. Each Task has its own set of canvases.
+	TaskGroup group;
+	for (int i = 0; i < numThreads - 1; ++i) group.run([=] { generateSystems(dummyPlanets[i], moistureDummies[i],
+		heatDummies[i], riverDummies[i], buildingDummies[i], canvases[i]); });
 	generateSystems(dummyPlanets[numThreads - 1], moistureDummies[numThreads - 1], heatDummies[numThreads - 1],
 		riverDummies[numThreads - 1], buildingDummies[numThreads - 1], canvases[numThreads - 1]);
 
-	// Joins all threads.
-	joinAllThreads();
-
-	// Sets universeX and universeY to 0 after system generation.
-	universeX = 0;
-	universeY = 0;
+	// Waits for all Tasks to finish.
+	group.wait();
 
 	// TODO DEBUG REMOVE
 	// Shows number of systems.
 	int numSystems = 0;
-	for (int i = 0; i < universeWidth * universeHeight; ++i)
-		if (universe[i].tileID == SYSTEM_TILE) ++numSystems;
+	for (int c = 0; c < universe.chunksWide * universe.chunksHigh; ++c) numSystems += universe.chunks[c].numSystems;
 
 	// TODO DEBUG REMOVE
-	// Shows num Systems, HabitablePlanets and BarrenPlanets.
-	printf("numSystems : %d\n", numSystems);
+	// Shows num Systems, HabitablePlanets and BarrenPlanets. Printed to stderr so that stdout only holds output
+	// meant for other programs, such as the benchmark's results.
+	fprintf(stderr, "numSystems : %d\n", numSystems);
 	//printf("neededHab : %d\n", neededHab);
-	printf("numHabitablePlanets : %d\n", numHabitablePlanets);
-	printf("numHabitablePages : %d\n", numHabitablePages);
+	fprintf(stderr, "numHabitablePlanets : %d\n", numHabitablePlanets);
+	fprintf(stderr, "numHabitablePages : %d\n", habitablePool.numPages);
 	//printf("neededBarr : %d\n", neededBarr);
-	printf("numBarrenPlanets : %d\n", numBarrenPlanets);
-	printf("numBarrenPages : %d\n", numBarrenPages);
+	fprintf(stderr, "numBarrenPlanets : %d\n", numBarrenPlanets);
+	fprintf(stderr, "numBarrenPages : %d\n", barrenPool.numPages);
 
 	// Deallocates the dummyPlanets and canvas.
 	deallocateCanvases(dummyPlanets, MAX_PLANET_WIDTH, numThreads);
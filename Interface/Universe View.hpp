@@ -75,14 +75,14 @@ void debugUniverseTile(int xPos, int yPos) {
 
 	// Prints general data.
 	printf("tile      : {%6d,%6d}\n", xPos, yPos);
-	printf("closure   : %16d\n", uIndex(xPos, yPos).closure);
+	printf("closure   : %16d\n", uClosureID(xPos, yPos));
 	printf("  start   : {%6d,%6d}\n", uClosure(xPos, yPos).start.x, uClosure(xPos, yPos).start.y);
 	printf("owner   : %16p\n", uOwner(xPos, yPos));
 
 	// Prints squadrons.
 	///*
-	printf("numSquadrons : %16d\n", uIndex(xPos, yPos).numSquadrons);
-	for (int i = 0; i < uIndex(xPos, yPos).numSquadrons; ++i) {
+	printf("numSquadrons : %16d\n", uNumSquadrons(xPos, yPos));
+	for (int i = 0; i < uNumSquadrons(xPos, yPos); ++i) {
 		squadron = uSquadron(xPos, yPos, i);
 
 		// Prints owner.
@@ -104,7 +104,7 @@ void debugUniverseTile(int xPos, int yPos) {
 			else if (squadron->behaviour == squadronGuard) printf("squadronGuard");
 			else if (squadron->behaviour == squadronPursue) {
 				printf("squadronPursue d(%d, %d) l(%d, %d)", squadron->getDest().x, squadron->getDest().y,
-					(*((Squadron**)squadron->data))->loc.x, (*((Squadron**)squadron->data))->loc.y);
+					squadronStore.get(*((SquadronHandle*)squadron->data))->loc.x, squadronStore.get(*((SquadronHandle*)squadron->data))->loc.y);
 
 			}
 			else if (squadron->behaviour == squadronMove) printf("squadronMove");
@@ -322,8 +322,8 @@ Enters a system after the user clicks it.
 void enterSystem(int xPos, int yPos) {
 
 	// If the user has clicked a SYSTEM_TILE, assigns it as activeSystem and renders it.
-	if (uIndex(xPos, yPos).getTileID() == SYSTEM_TILE) {
-		changeActiveSystem(uIndex(xPos, yPos).system);
+	if (uTileID(xPos, yPos) == SYSTEM_TILE) {
+		changeActiveSystem(uSystem(xPos, yPos));
 
 	}
 }
@@ -418,25 +418,25 @@ inline SDL_Rect getShipSprite(int shipSprite) {
 }
 
 /*
-Renders the Ships in a GalaxyTile.
+Renders the Ships in a universe tile.
 */
-inline void renderShips(int x, int y, GalaxyTile* tile) {
+inline void renderShips(int x, int y, int xPos, int yPos) {
 	SDL_Rect shipSprite;
 	int currShip = 0;
 	int numShips;
 
 	// Does nothing if the tile contains no Ships.
-	if (!tile->numSquadrons) return;
+	if (!uNumSquadrons(xPos, yPos)) return;
 
-	// Renders all Ships in the GalaxyTile.
+	// Renders all Ships in the tile.
 	// TODO implement
 
 	// TODO DEBUG REMOVE
-	numShips = tile->squadrons[0]->ships[0].num;
+	numShips = uSquadron(xPos, yPos, 0)->ships[0].num;
 	numShips = numShips > 255 ? 255 : numShips;
 
 	// TODO DEBUG REMOVE
-	shipSprite = getShipSprite(tile->squadrons[0]->ships[0].type.sprite);
+	shipSprite = getShipSprite(uSquadron(xPos, yPos, 0)->ships[0].type.sprite);
 
 	// TODO DEBUG REMOVE renders ships
 	for (int h = 0; h < SPRITE_SIZE / SMALL_SPRITE_SIZE; ++h) {
@@ -470,14 +470,14 @@ void renderUniverse() {
 
 			// Renders the tile.
 			tile = { i + universeViewport.x, j + universeViewport.y, universeTileSize, universeTileSize };
-			sprite = uIndex(x, y).getSprite();
+			sprite = universeTileSprite(uTileID(x, y));
 
 			// TODO DEBUG REMOVE
 			// Shows paths from current system outwards.
 			for (int k = 0; activeSystem && (activeSystem->tradeLanes[k].x || activeSystem->tradeLanes[k].y); ++k) {
 				if (x == activeSystem->loc.x + activeSystem->tradeLanes[k].x &&
 					y == activeSystem->loc.y + activeSystem->tradeLanes[k].y) {
-					sprite = uIndex(0, 0).getSprite();
+					sprite = universeTileSprite(uTileID(0, 0));
 
 				}
 			}
@@ -492,10 +492,10 @@ void renderUniverse() {
 			}
 
 			// If the tile was a SystemSpaceTile, calls renderUniverseSystem.
-			if (uIndex(x, y).getTileID() == SYSTEM_TILE) renderUniverseSystem(tile, x, y);
+			if (uTileID(x, y) == SYSTEM_TILE) renderUniverseSystem(tile, x, y);
 
 			// Renders the tile's Ships.
-			renderShips(i, j, &uIndex(x, y));
+			renderShips(i, j, x, y);
 
 		}
 		uUnlock(x, 0);
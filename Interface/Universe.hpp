@@ -5,7 +5,7 @@ This header contains information on closures as well as functions for modifying
 */
 
 // The universe used for gameplay.
-GalaxyTile* universe;
+UniverseGrid universe;
 
 // Stores all systems used in the universe.
 System* allSystemSpace;
@@ -13,6 +13,23 @@ System* allSystemSpace;
 // Mutex mediating access to the universe.
 std::shared_mutex universeMutex;
 
+// Adds a Squadron to the inputed universe tile.
+void addUniverseSquadron(int xPos, int yPos, Squadron* squadron);
+
+// Removes a Squadron from the inputed universe tile.
+void removeUniverseSquadron(int xPos, int yPos, Squadron* squadron);
+
+// Sets the closure of the inputed universe tile and updates its chunk's summary.
+void setUniverseClosure(int xPos, int yPos, int closure);
+
+// Calls func on every tile within the inputed window, skipping chunks which are not kept.
+template<class K, class F>
+void forUniverseWindow(int xBeg, int yBeg, int xEnd, int yEnd, K keep, F func);
+
+// Calls func on every tile of the inputed closure within the inputed bounds.
+template<class F>
+void forClosureTiles(int xMin, int yMin, int xMax, int yMax, int nClosure, F func);
+
 // Removes the current owner of the inputed GalaxyTile.
 void removeUniverseOwner(int xPos, int yPos);
 
@@ -20,8 +37,17 @@ void removeUniverseOwner(int xPos, int yPos);
 // Can use a Coordinate instead of two coordinates.
 void changeUniverseOwner(int xPos, int yPos, Government * owner);
 
-// Manages consolidation and splitting of closures for the inputed page.
-void manageClosures(int page);
+// Relabels the tiles of closures on the inputed page which have been merged into another closure.
+void mergeClosures(int page);
+
+// Points closures on the inputed page which have been merged directly at their final closure.
+void flattenClosures(int page);
+
+// Releases closures on the inputed page which have been merged into another closure or are empty.
+void releaseMergedClosures(int page);
+
+// Splits closures on the inputed page which may have been disconnected.
+void splitClosures(int page);
 
 /*
 Returns true if the inputed xPos and yPos are within the universe bounds,
@@ -32,11 +58,39 @@ inline bool universeInBounds(int xPos, int yPos) {
 
 }
 
+/*
+Returns the de-jure owner of the inputed tile, or nullptr if it has none.
+*/
+inline Government* uOwner(int xPos, int yPos) {
+	extern PagedPool<Government> governmentPool;
+	uint_least32_t owner = universe.block(xPos, yPos)->owners[UniverseGrid::offset(xPos, yPos)];
+	return owner ? governmentPool.at(owner - 1) : nullptr;
+
+}
+
+/*
+Sets the de-jure owner of the inputed tile. owner may be nullptr.
+*/
+inline void setUOwner(int xPos, int yPos, Government* owner) {
+	extern PagedPool<Government> governmentPool;
+
+	// Unowned tiles in a sparse universe may share the empty block.
+	if (!owner && !uOwner(xPos, yPos)) return;
+	universe.touch(xPos, yPos)->owners[UniverseGrid::offset(xPos, yPos)] = owner ? governmentPool.indexOf(owner) + 1 : 0;
+
+}
+
 /*
 Closures represent supply areas associated with squadrons. They are accessible
 via the 'closure' element of GalaxyTiles. Each SupplyClosure stores an int
 representing the number of tiles associated with it, allowing closures to be
 reformatted when GalaxyTiles change hands.
+
+Closures which become connected are merged immediately as a union-find: the
+smaller closure's parent is set to the larger, and its tiles are relabeled in
+manageClosures. Until then, findClosure gives the closure a tile truly belongs to.
+Each closure also keeps a bounding box and the sums of its tiles' coordinates,
+so that relabeling, splitting, and finding a centroid never scan the universe.
 */
 struct SpaceClosure {
 
@@ -52,195 +106,160 @@ struct SpaceClosure {
 	// Marks that the closure may have a split.
 	uint_least32_t split : 1;
 
-	// Marks that the closure may need reconciliation.
+	// Marks that the closure has been merged into its parent and its tiles need relabeling.
 	uint_least32_t rec : 1;
 
-};
-
-// The number of SpaceClosures in a ClosurePage.
-#define CLOSURE_PAGE_SIZE 1024
+	// Closure that this closure has been merged into. 0 if this closure has not been merged.
+	uint_least16_t parent;
 
-// Default number of closure pages. This is also the number used when expanding the roster of
-// closure pages.
-#define NUM_CLOSURE_PAGES 256
+	// Marks that another closure has been merged into this one since closures were last managed.
+	uint_least16_t merged : 1;
 
-// Page of closures.
-struct ClosurePage {
-	SpaceClosure closures[CLOSURE_PAGE_SIZE];
-	uint16_t arrCurrClosure; // Should store the lowest empty closure, update upon change
-	uint16_t numOpen;
-	bool active : 1;
-	bool dirty : 1;
+	// Bounding box of this closure's tiles. It may be larger than necessary, since it only
+	// shrinks when the closure is flooded by splitClosure.
+	uint_least16_t xMin, yMin;
+	uint_least16_t xMax, yMax;
 
-	// X bytes of padding?
+	// Sums of the coordinates of this closure's tiles. Used to find the centroid.
+	int_least64_t xSum;
+	int_least64_t ySum;
 
 };
 
-// Stores all closures.
-int numClosurePages;
-ClosurePage** closurePages;
+// Size of a page of closures. Pages are kept small so that manageClosures can skip
+// pages without changes and spread the rest over all threads.
+#define CLOSURE_PAGE_BYTES 65536
+
+// Stores all closures. Each page's dirty flag marks that it has closures to manage.
+PagedPool<SpaceClosure, CLOSURE_PAGE_BYTES> closurePool;
+
+// The number of SpaceClosures in a page of closurePool.
+#define CLOSURE_PAGE_SIZE (PagedPool<SpaceClosure, CLOSURE_PAGE_BYTES>::PAGE_SIZE)
 
 /*
-Initializes allClosures. Will round to the next multiple of NUM_CLOSURES.
+Initializes closurePool with capacity for numClosures.
 */
 void initClosures(int numClosures) {
-
-	// Frees closurePages for reuse.
-	if (numClosurePages) {
-		for (int i = 0; i < numClosurePages; ++i) {
-			if (closurePages[i]) delete closurePages[i];
-			closurePages[i] = nullptr;
-
-		}
-		delete[] closurePages;
-
-	}
-
-	// Initializes closurePages.
-	numClosurePages = numClosures / CLOSURE_PAGE_SIZE + 1;
-	closurePages = (ClosurePage**)calloc(numClosurePages + NUM_CLOSURE_PAGES - (numClosurePages % NUM_CLOSURE_PAGES), sizeof(ClosurePage*));
-	for (int i = 0; i < numClosurePages; ++i) {
-		closurePages[i] = (ClosurePage*)calloc(1, sizeof(ClosurePage));
-		closurePages[i]->numOpen = CLOSURE_PAGE_SIZE;
-
-	}
+	closurePool.init(numClosures);
 
 	// Ensures that the first closure of the first page is reserved for empty tiles.
-	closurePages[0]->arrCurrClosure = 1;
+	closurePool.allocate();
 
 }
 
 /*
 Places a closure. Note that 0 is reserved for unowned GalaxyTiles.
-
-Note: Access should be mutexed outside of this function.
 */
-int placeClosure() {
-	int closure = 0;
-
-	// Attempts to place the closure within one of the current pages.
-	for (int page = 0; page < numClosurePages; ++page) {
-		if (closurePages[page]->numOpen) {
-
-			// Occupies the first empty closure.
-			closure = page * CLOSURE_PAGE_SIZE + closurePages[page]->arrCurrClosure;
-			--closurePages[page]->numOpen;
-
-			// Finds and stores the next empty closure on the page.
-			if (closurePages[page]->numOpen) while (closurePages[page]->closures[++closurePages[page]->arrCurrClosure].owner != nullptr);
-
-			// Returns the closure upon success.
-			return closure;
-
-		}
-	}
-
-	// If placement failed, creates a new page and places the closure there.
-	// Will only place when all threads are at this function or returned.
-	if (!closure) {
-
-		// If the page table is not large enough, reallocates it.
-		if (!(numClosurePages + 1 % NUM_CLOSURE_PAGES))
-			closurePages = (ClosurePage**)realloc(closurePages, (numClosurePages + NUM_CLOSURE_PAGES) * sizeof(ClosurePage*));
-
-		// Creates a new ClosurePage.
-		closurePages[numClosurePages] = (ClosurePage*)calloc(1, sizeof(ClosurePage));
-		closurePages[numClosurePages]->numOpen = CLOSURE_PAGE_SIZE;
-
-		// Places the closure in the first index of the new page.
-		closure = (numClosurePages + 1) * CLOSURE_PAGE_SIZE;
-		++closurePages[numClosurePages]->arrCurrClosure;
-
-		// Moves on to the next page.
-		++numClosurePages;
-
-	}
-
-	// Returns the current closure.
-	return closure;
+inline int placeClosure() {
+	return closurePool.indexOf(closurePool.allocate());
 
 }
 
 /*
-Marks a closure as available by assigning all of its values to 0 and incrementing
-numOpen in its page.
+Marks a closure as available. Its values are all set to 0.
 
-NOTE: This has not been debugged.
 NOTE: This should never be called for closure 0.
 */
-void freeClosure(int clos) {
-	SpaceClosure* closure = &closurePages[clos / CLOSURE_PAGE_SIZE]->closures[clos % CLOSURE_PAGE_SIZE];
-
-	// Frees the closure.
-	memset(closure, 0, sizeof(SpaceClosure));
-
-	// Increments numOpen.
-	++closurePages[clos / CLOSURE_PAGE_SIZE]->numOpen;
+inline void freeClosure(int clos) {
+	closurePool.free(closurePool.at(clos));
 
 }
 
 /*
-Requests a ClosurePage. Returns the index of the next available page in closurePages, otherwise -1.
+Returns the closure that the inputed closure has been merged into, or the inputed
+closure if it has not been merged.
 */
-int requestDirtyClosurePage() {
-	static std::shared_mutex requestClosurePageMutex;
+inline int findClosure(int nClosure) {
+	while (indexClosure(nClosure).parent) nClosure = indexClosure(nClosure).parent;
+	return nClosure;
 
-	// Forbids concurrent access to this function.
-	const std::lock_guard<std::shared_mutex> lock(requestClosurePageMutex);
+}
 
-	// Parses through each galaxy and returns the next available one.
-	for (int i = 0; i < numClosurePages; ++i) {
-		if (!closurePages[i]->active && closurePages[i]->dirty) {
-			closurePages[i]->active = true;
-			closurePages[i]->dirty = false;
-			return i;
+/*
+Extends the bounding box of a closure to contain the inputed box. The box of a closure
+without tiles is replaced, so this should be called before numTiles is increased.
+*/
+inline void extendClosureBox(SpaceClosure* closure, int xMin, int yMin, int xMax, int yMax) {
+	if (!closure->numTiles) {
+		closure->xMin = xMin;
+		closure->yMin = yMin;
+		closure->xMax = xMax;
+		closure->yMax = yMax;
+		return;
 
-		}
 	}
+	if (xMin < closure->xMin) closure->xMin = xMin;
+	if (yMin < closure->yMin) closure->yMin = yMin;
+	if (xMax > closure->xMax) closure->xMax = xMax;
+	if (yMax > closure->yMax) closure->yMax = yMax;
 
-	// Returns -1 if no ClosurePage was found.
-	return -1;
+}
+
+/*
+Counts a tile towards a closure. Does not change the tile itself.
+*/
+inline void addClosureTile(SpaceClosure* closure, int xPos, int yPos) {
+	extendClosureBox(closure, xPos, yPos, xPos, yPos);
+	++closure->numTiles;
+	closure->xSum += xPos;
+	closure->ySum += yPos;
 
 }
 
 /*
-Returns a ClosurePage.
+Stops counting a tile towards a closure. Does not change the tile itself.
+The bounding box is left as is.
 */
-void releaseClosurePage(int index) {
-	closurePages[index]->active = false;
+inline void removeClosureTile(SpaceClosure* closure, int xPos, int yPos) {
+	--closure->numTiles;
+	closure->xSum -= xPos;
+	closure->ySum -= yPos;
 
 }
 
 /*
-Returns all ClosurePages.
+Merges the closures containing the two inputed closures. The smaller closure is made a
+child of the larger one and marked for relabeling by manageClosures.
+Returns the closure which both now belong to.
+
+Note: Access to this function should require universeMutex to be locked.
 */
-void releaseAllClosurePages() {
-	for (int i = 0; i < numClosurePages; ++i) closurePages[i]->active = false;
+int unionClosures(int nClosure1, int nClosure2) {
+	int root = findClosure(nClosure1);
+	int child = findClosure(nClosure2);
+
+	// Does nothing if the closures are already merged.
+	if (root == child) return root;
+
+	// Keeps the larger closure as the root, so that fewer tiles are relabeled.
+	if (indexClosure(child).numTiles > indexClosure(root).numTiles) std::swap(root, child);
+
+	// Merges the child into the root.
+	indexClosure(child).parent = root;
+	indexClosure(child).rec = true;
+	indexClosurePage(child)->dirty = true;
+	indexClosure(root).merged = true;
+	return root;
 
 }
 
 /*
 Pathfinds from the inputed centroid to the nearest path associated with the
 inputed closure. Pathfinding is done here to simplify assignClosureStart.
-
-Note: It could be more efficient to replace this function with one that
-	iterates over every universe tile and calculates the one with the minimum
-	distance to the centroid.
+The search never leaves the closure's bounding box, which always contains the centroid.
 */
 void assignClosureStart(int xPos, int yPos, SpaceClosure* closure, int nClosure) {
 	LinkedList<PathCoordinate> frontier = LinkedList<PathCoordinate>();
-	LinkedList<PathCoordinate>* coords = requestCoordList();
-	uint_least8_t* explored = requestDummy();
+	ScratchScope scratch;
+	CoordList coords;
+	ExploredMap* explored = requestExploredMap(universeWidth * universeHeight);
 	LinkedListNode<PathCoordinate>* currTile;
 
-	// Resets explored.
-	memset(explored, 0, universeWidth * universeHeight * sizeof(uint_least8_t));
-
 	// Starts from the calculated centroid.
 	// Note: xPos and yPos are reused later.
-	currTile = coords->popc();
+	currTile = coords.popc();
 	currTile->value->coord = {xPos, yPos};
-	explored[index(xPos, yPos, universeWidth)] = true;
+	explored->visit(index(xPos, yPos, universeWidth));
 	frontier.addc(currTile);
 
 	// Explores until a suitable start is found.
@@ -252,20 +271,20 @@ void assignClosureStart(int xPos, int yPos, SpaceClosure* closure, int nClosure)
 		yPos = currTile->value->coord.y;
 
 		// If the current tile is associated with the closure, ceases exploration.
-		if (uIndex(xPos, yPos).closure == nClosure) break;
+		if (uClosureID(xPos, yPos) == nClosure) break;
 
 		// Queues all unexplored tiles which are adjacent to the current tile.
 		actionDirection(xPos, yPos,
-			[&frontier, &coords, &explored](int x, int y)->void {
+			[&frontier, &coords, explored, closure](int x, int y)->void {
 				LinkedListNode<PathCoordinate>* tile;
 
-				// Does not go out of bounds of the universe.
-				if (!universeInBounds(x, y)) return;
+				// Does not leave the closure's bounding box.
+				if (x < closure->xMin || x > closure->xMax || y < closure->yMin || y > closure->yMax) return;
 
 				// Adds unexplored adjacent tiles to the frontier.
-				if (!explored[index(x, y, universeWidth)]) {
-					explored[index(x, y, universeWidth)] = true;
-					tile = coords->popc();
+				if (!explored->visited(index(x, y, universeWidth))) {
+					explored->visit(index(x, y, universeWidth));
+					tile = coords.popc();
 					tile->value->coord.x = x;
 					tile->value->coord.y = y;
 					frontier.addc(tile);
@@ -275,7 +294,7 @@ void assignClosureStart(int xPos, int yPos, SpaceClosure* closure, int nClosure)
 		);
 
 		// Returns the used coord to the coordlist.
-		coords->addc(currTile);
+		coords.addc(currTile);
 
 	}
 
@@ -283,57 +302,163 @@ void assignClosureStart(int xPos, int yPos, SpaceClosure* closure, int nClosure)
 	closure->start = currTile->value->coord;
 
 	// Returns all tiles to the coordlist.
-	while (!frontier.isEmpty()) coords->addc(frontier.popc());
-	coords->addc(currTile);
+	while (!frontier.isEmpty()) coords.addc(frontier.popc());
+	coords.addc(currTile);
 
 	// Releases held data.
-	releaseCoordList(coords);
-	releaseDummy(explored);
+	releaseExploredMap(explored);
 
 }
 
 /*
 Assigns the starting position of the closure to be roughly the centroid of the closure.
+The centroid is found from the closure's coordinate sums.
 */
 void assignClosureStart(SpaceClosure* closure, int nClosure) {
-	long int xCent = 0;
-	long int yCent = 0;
-	
-	// Sums the x and y values of all coordinates in this closure.
-	for (int x = 0; x < universeWidth; ++x) {
-		for (int y = 0; y < universeHeight; ++y) {
-			if (uIndex(x, y).closure == nClosure) {
-				xCent += x;
-				yCent += y;
 
-			}
-		}
-	}
+	// Does nothing if the closure has no tiles.
+	if (!closure->numTiles) return;
 
 	// Calculates the centroid of this closure.
-	xCent /= closure->numTiles;
-	yCent /= closure->numTiles;
+	int xCent = (int)(closure->xSum / closure->numTiles);
+	int yCent = (int)(closure->ySum / closure->numTiles);
 
 	// If the calculated centroid is a part of the closure, assigns the centroid
 	// and returns.
-	if (uIndex(xCent, yCent).closure == nClosure) closure->start = { xCent, yCent };
+	if (uClosureID(xCent, yCent) == nClosure) closure->start = { xCent, yCent };
 	// If the calculated centroid is not part of the closure, pathfinds to the
 	// nearest tile of the closure and uses that as the centroid.
 	else assignClosureStart(xCent, yCent, closure, nClosure);
 
 }
 
+/*
+Adds a Squadron to the inputed universe tile.
+*/
+void addUniverseSquadron(int xPos, int yPos, Squadron* squadron) {
+	UniverseBlock* block = universe.touch(xPos, yPos);
+	int tile = UniverseGrid::offset(xPos, yPos);
+	int numSquadrons = block->numSquadrons[tile];
+	Squadron**& squadrons = block->squadrons[tile];
+
+	// Array size will be incremented by 8.
+	const int inc = 8;
+
+	// If squadrons is empty, initializes it.
+	if (!numSquadrons) squadrons = (Squadron**)malloc(sizeof(Squadron*) * inc);
+	// If squadrons is too small, resizes it.
+	else if (!(numSquadrons % inc)) squadrons = (Squadron**)realloc(squadrons, sizeof(Squadron*) * (numSquadrons + inc));
+
+	// Assigns the Squadron to the tile.
+	squadrons[numSquadrons] = squadron;
+	++block->numSquadrons[tile];
+	uChunk(xPos, yPos).numSquadrons.fetch_add(1, std::memory_order_relaxed);
+
+}
+
+/*
+Removes a Squadron from the inputed universe tile.
+*/
+void removeUniverseSquadron(int xPos, int yPos, Squadron* squadron) {
+	UniverseBlock* block = universe.block(xPos, yPos);
+	int tile = UniverseGrid::offset(xPos, yPos);
+	int numSquadrons = block->numSquadrons[tile];
+	Squadron** squadrons = block->squadrons[tile];
+
+	// Finds the squadron.
+	int curr = 0;
+	for (; curr < numSquadrons && squadrons[curr] != squadron; ++curr);
+
+	// Removes the squadron.
+	--numSquadrons;
+	for (int i = curr; i < numSquadrons; ++i) squadrons[i] = squadrons[i + 1];
+	block->numSquadrons[tile] = numSquadrons;
+	uChunk(xPos, yPos).numSquadrons.fetch_sub(1, std::memory_order_relaxed);
+
+	// Deletes squadrons if numSquadrons is 0.
+	if (!numSquadrons) {
+		free(squadrons);
+		block->squadrons[tile] = nullptr;
+
+	}
+}
+
+/*
+Sets the closure of the inputed universe tile. Keeps the number of owned tiles and the
+closures of the tile's chunk up to date. closure may be 0 to remove the tile from its closure.
+Tiles which gain a closure are given their own block in a sparse universe.
+
+The owned count only changes when a tile gains or loses an owner, which happens under
+universeMutex. The closures mask may be raised by relabeling from several threads at once.
+*/
+void setUniverseClosure(int xPos, int yPos, int closure) {
+	UniverseChunk& chunk = uChunk(xPos, yPos);
+
+	// Unowned tiles in a sparse universe may share the empty block.
+	if (!closure && !uClosureID(xPos, yPos)) return;
+	uint_least16_t& tile = universe.touch(xPos, yPos)->closures[UniverseGrid::offset(xPos, yPos)];
+
+	// Counts tiles which gain or lose a closure. The mask is cleared with the last owned tile.
+	if (!tile && closure) chunk.numOwned.fetch_add(1, std::memory_order_relaxed);
+	else if (tile && !closure && chunk.numOwned.fetch_sub(1, std::memory_order_relaxed) == 1)
+		chunk.closures.store(0, std::memory_order_relaxed);
+
+	// Marks the closure as present in the chunk.
+	if (closure) chunk.closures.fetch_or((uint_least64_t)1 << (closure & 63), std::memory_order_relaxed);
+	tile = closure;
+
+}
+
+/*
+Calls func(x, y) on every tile from (xBeg, yBeg) up to but not including (xEnd, yEnd).
+Tiles are visited one chunk at a time. Chunks for which keep(chunk) is false are skipped
+entirely. Stops early if func returns false.
+*/
+template<class K, class F>
+void forUniverseWindow(int xBeg, int yBeg, int xEnd, int yEnd, K keep, F func) {
+
+	// Visits each chunk overlapping the window.
+	for (int cx = xBeg & ~(UNIVERSE_CHUNK_SIZE - 1); cx < xEnd; cx += UNIVERSE_CHUNK_SIZE) {
+		for (int cy = yBeg & ~(UNIVERSE_CHUNK_SIZE - 1); cy < yEnd; cy += UNIVERSE_CHUNK_SIZE) {
+			if (!keep(uChunk(cx, cy))) continue;
+
+			// Visits the tiles within both the chunk and the window.
+			int xLast = cx + UNIVERSE_CHUNK_SIZE < xEnd ? cx + UNIVERSE_CHUNK_SIZE : xEnd;
+			int yLast = cy + UNIVERSE_CHUNK_SIZE < yEnd ? cy + UNIVERSE_CHUNK_SIZE : yEnd;
+			for (int x = cx > xBeg ? cx : xBeg; x < xLast; ++x) {
+				for (int y = cy > yBeg ? cy : yBeg; y < yLast; ++y) {
+					if (!func(x, y)) return;
+
+				}
+			}
+		}
+	}
+}
+
+/*
+Calls func(x, y) on every tile of the inputed closure within the inputed (inclusive) bounds.
+Chunks which cannot contain the closure are skipped. Stops early if func returns false.
+*/
+template<class F>
+void forClosureTiles(int xMin, int yMin, int xMax, int yMax, int nClosure, F func) {
+	forUniverseWindow(xMin, yMin, xMax + 1, yMax + 1,
+		[nClosure](UniverseChunk& chunk)->bool { return chunk.mayContain(nClosure); },
+		[nClosure, &func](int x, int y)->bool { return uClosureID(x, y) != nClosure || func(x, y); });
+
+}
+
 /*
 Removes the current owner of the inputed GalaxyTile.
 
-NOTE: This function merely does bookeeping relating to the owner's closure and
-does not actually change the closure to 0.
+NOTE: This function does bookeeping relating to the owner's closure and
+sets the tile's closure to 0. The caller is expected to assign a new closure.
 
 NOTE: Access to this function should require universeMutex to be locked.
 */
 void removeUniverseOwner(int xPos, int yPos) {
 	SpaceClosure* closure = &uClosure(xPos, yPos);
-	int nClosure = uIndex(xPos, yPos).closure;
+	int nClosure = uClosureID(xPos, yPos);
+	int root;
 	Direction dir;
 
 	// Decrements the number of unoccupied tiles in the Galaxy and returns if the
@@ -344,23 +469,26 @@ void removeUniverseOwner(int xPos, int yPos) {
 
 	}
 
-	// Decrements the number of tiles associated with the current closure.
-	--closure->numTiles;
+	// Removes the tile from its closure.
+	setUniverseClosure(xPos, yPos, 0);
+	removeClosureTile(closure, xPos, yPos);
 
-	// Releases the closure and returns if it has no associated tiles.
+	// Marks the closure for release and returns if it has no associated tiles.
+	// Closures are released by manageClosures, since releasing modifies the owner's closures.
 	if (!closure->numTiles) {
-		freeClosure(nClosure);
+		indexClosurePage(nClosure)->dirty = true;
 		return;
 
 	}
 
-	// Checks to see if the closure may need a split.
-	dir = fillDirection(xPos, yPos, [nClosure](int x, int y)->bool { return uIndex(x, y).closure == nClosure; });
+	// Checks to see if the closure may need a split. Tiles of merged closures count as one closure.
+	root = findClosure(nClosure);
+	dir = fillDirection(xPos, yPos, [root](int x, int y)->bool { return findClosure(uClosureID(x, y)) == root; });
 
 	// Marks the closure for splitting if the tile is adjacent to two or more blocks.
 	if (directionNumBlocks(dir) > 1) {
-		closure->split = true;
-		indexClosurePage(nClosure)->dirty = true;
+		indexClosure(root).split = true;
+		indexClosurePage(root)->dirty = true;
 
 	}
 
@@ -371,7 +499,8 @@ void removeUniverseOwner(int xPos, int yPos) {
 
 /*
 Gives the inputed tile to the inputed Government. Will associate the added tile with an
-appropriate existing closure or create a new closure.
+appropriate existing closure or create a new closure. If the tile connects several of the
+Government's closures, they are merged.
 */
 void changeUniverseOwner(int xPos, int yPos, Government* owner) {
 	int closure;
@@ -384,13 +513,13 @@ void changeUniverseOwner(int xPos, int yPos, Government* owner) {
 
 	// If the tile is unowned, assigns the de-jure owner of this tile to be
 	// the inputed Government.
-	if (!uOwner(xPos, yPos)) uOwner(xPos, yPos) = owner;
+	if (!uOwner(xPos, yPos)) setUOwner(xPos, yPos, owner);
 
 	// Finds an adjacent closure belonging to the inputed Government.
 	for (int i = -1; i < 2; ++i) {
 		for (int j = -1; j < 2; ++j) {
 			if (uController(xPos + i, yPos + j) == owner) {
-				closure = uIndex(xPos + i, yPos + j).closure;
+				closure = findClosure(uClosureID(xPos + i, yPos + j));
 				goto assignClosure;
 
 			}
@@ -407,30 +536,21 @@ void changeUniverseOwner(int xPos, int yPos, Government* owner) {
 	assignClosure:;
 
 	// Assigns the inputed tile to an appropriate closure.
-	uIndex(xPos, yPos).closure = closure;
-	++indexClosure(closure).numTiles;
-
-	// Unlocks the mutex.
-	universeMutex.unlock();
+	setUniverseClosure(xPos, yPos, closure);
+	addClosureTile(&indexClosure(closure), xPos, yPos);
 
 	// If this tile bridges the gap between two closures owned by this government,
-	// marks the closure for reconcilation.
-	actionDirectionCond(xPos, yPos,
-		[owner, closure](int i, int j)->bool {
-
-			// Marks the closure for reconciliation if another owned closure is found.
-			if (uController(i, j) == owner && uIndex(i, j).closure != closure) {
-				indexClosure(closure).rec = true;
-				indexClosurePage(closure)->dirty = true;
-				return true;
-
-			}
-
-			// Continues operation if no owned closure is found.
-			return false;
+	// merges the closures.
+	actionDirection(xPos, yPos,
+		[owner, &closure](int i, int j)->void {
+			if (uController(i, j) == owner) closure = unionClosures(closure, uClosureID(i, j));
 
 		}
 	);
+
+	// Unlocks the mutex.
+	universeMutex.unlock();
+
 }
 
 /*
@@ -442,63 +562,94 @@ void changeUniverseOwner(CoordU loc, Government* owner) {
 }
 
 /*
-Changes the closure of a given tile. Assumes that the inputed tile is owned by
-the owner of the given closure.
-
-The replaced closure will be freed if it has no remaining tiles.
+Relabels every tile of a merged closure to the closure it was merged into. Only the
+merged closure's bounding box is searched. The merged closure itself is released later
+by releaseMergedClosures, since other merged closures may still lead through it.
 
-Note: Changes here should be replicated in splitClosure where new closures are assigned.
+Note: This is written here to make manageClosures more comprehensible.
 */
-void changeClosure(int xPos, int yPos, int closure) {
-	SpaceClosure* tempClosure = &uClosure(xPos, yPos);
-	int tempNClosure = uIndex(xPos, yPos).closure;
+void mergeClosure(SpaceClosure* closure, int nClosure) {
+	int root = findClosure(nClosure);
+	SpaceClosure* rootClosure = &indexClosure(root);
 
-	// Removes the tile from its original closure.
-	--tempClosure->numTiles;
+	// Does nothing if the closure has lost all of its tiles.
+	if (!closure->numTiles) return;
 
-	// Places the tile under control of the inputed closure.
-	uIndex(xPos, yPos).closure = closure;
-	++indexClosure(closure).numTiles;
+	// Relabels every tile of this closure.
+	forClosureTiles(closure->xMin, closure->yMin, closure->xMax, closure->yMax, nClosure, [root](int x, int y)->bool {
+		setUniverseClosure(x, y, root);
+		return true;
 
-	// Frees the replaced closure if it has no remaining tiles.
-	if (!tempClosure->numTiles) freeClosure(tempNClosure);
-	// Changes the start of the closure if it has been overwritten.
-	else if (tempClosure->start.x == xPos && tempClosure->start.y == yPos)
-		assignClosureStart(&indexClosure(closure), closure);
+	});
+
+	// Moves this closure's tiles to the root. Several closures may be merged into one root at once.
+	universeMutex.lock();
+	extendClosureBox(rootClosure, closure->xMin, closure->yMin, closure->xMax, closure->yMax);
+	rootClosure->numTiles += closure->numTiles;
+	rootClosure->xSum += closure->xSum;
+	rootClosure->ySum += closure->ySum;
+	universeMutex.unlock();
+	closure->numTiles = 0;
 
 }
 
 /*
-Attempts to split closures marked for splitting. Does so by counting all
-tiles of a given closure which are connected to the closure's start, then
-splitting the closure in such case where the number of tiles connected
-to the closure's start is not equal to the total number of tiles associated
-with the closure. The closure which is split off will have this function
-performed on it to make sure that three-way (and larger) splits are possible.
+Releases a closure whose tiles have been relabeled by mergeClosure. Splits pending on the
+released closure are passed to the closure it was merged into, unless that closure is released too.
+
+Note: This must not be run concurrently, since it modifies Governments' closures.
+*/
+void releaseMergedClosure(SpaceClosure* closure, int nClosure) {
+	int root = closure->parent;
+	SpaceClosure* rootClosure = &indexClosure(root);
+	bool split = closure->split;
+
+	// Releases the merged closure.
+	closure->owner->removeClosure(nClosure);
+	freeClosure(nClosure);
+
+	// Does nothing more if the root has already been released.
+	if (!rootClosure->owner) return;
+	rootClosure->merged = false;
+
+	// Releases the root if the merge left it empty.
+	if (!rootClosure->numTiles) {
+		rootClosure->owner->removeClosure(root);
+		freeClosure(root);
+		return;
+
+	}
+
+	// Moves the root's start if it does not lie within the root.
+	if (uClosureID(rootClosure->start.x, rootClosure->start.y) != root) assignClosureStart(rootClosure, root);
+
+	// Passes on any pending split. Released roots are skipped, so freed closures are never marked.
+	if (split) {
+		rootClosure->split = true;
+		indexClosurePage(root)->dirty = true;
+
+	}
+}
 
-NOTE: If split stored the number of blocks instead of a boolean, the recursion
-of this function could be simplified.
+/*
+Floods all tiles of a closure which are connected to the inputed tile, relabeling them to
+newClosure and counting them towards it. newClosure may be the same as nClosure.
+Flooded tiles are marked in explored.
 
 Note: This is written here to make manageClosures more comprehensible.
 */
-void splitClosure(SpaceClosure* closure, uint_least16_t nClosure, LinkedList<PathCoordinate>* coords, uint_least8_t* explored) {
+void floodClosure(int xPos, int yPos, int nClosure, int newClosure, CoordList* coords, ExploredMap* explored) {
 	LinkedList<PathCoordinate> frontier = LinkedList<PathCoordinate>();
 	LinkedListNode<PathCoordinate>* currTile;
-	int xPos, yPos;
-	int numTiles = 0;
-	int newClosure;
+	SpaceClosure* closure = &indexClosure(newClosure);
 
-	// Resets eplored.
-	memset(explored, 0, universeWidth * universeHeight);
-
-	// Starts from the starting point of the closure.
+	// Starts from the inputed tile.
 	currTile = coords->popc();
-	currTile->value->coord = closure->start;
-	explored[index(closure->start.x, closure->start.y, universeWidth)] = true;
+	currTile->value->coord = {xPos, yPos};
+	explored->visit(index(xPos, yPos, universeWidth));
 	frontier.addc(currTile);
 
-	// Counts and marks down all tiles belonging to this closure which are
-	// connected to the closure's start.
+	// Floods all tiles belonging to the closure which are connected to the inputed tile.
 	while (!frontier.isEmpty()) {
 
 		// Explores the first tile in the frontier.
@@ -506,14 +657,18 @@ void splitClosure(SpaceClosure* closure, uint_least16_t nClosure, LinkedList<Pat
 		xPos = currTile->value->coord.x;
 		yPos = currTile->value->coord.y;
 
-		// Queues all unexplored tiles in the current closure which are adjacent to the current tile.
+		// Gives the tile to the new closure.
+		setUniverseClosure(xPos, yPos, newClosure);
+		addClosureTile(closure, xPos, yPos);
+
+		// Queues all unexplored tiles in the closure which are adjacent to the current tile.
 		actionDirection(xPos, yPos,
-			[&frontier, &coords, &explored, nClosure](int x, int y)->void {
+			[&frontier, &coords, explored, nClosure](int x, int y)->void {
 				LinkedListNode<PathCoordinate>* tile;
 
 				// Adds unexplored tiles belonging to this closure to the frontier.
-				if (!explored[index(x, y, universeWidth)] && uIndex(x, y).closure == nClosure) {
-					explored[index(x, y, universeWidth)] = true;
+				if (!explored->visited(index(x, y, universeWidth)) && uClosureID(x, y) == nClosure) {
+					explored->visit(index(x, y, universeWidth));
 					tile = coords->popc();
 					tile->value->coord.x = x;
 					tile->value->coord.y = y;
@@ -525,138 +680,118 @@ void splitClosure(SpaceClosure* closure, uint_least16_t nClosure, LinkedList<Pat
 
 		// Returns the used coord to the coordlist.
 		coords->addc(currTile);
-		++numTiles;
-
-	}
-
-	// Splits the closure if the number of connected tiles is less than the
-	// total number of tiles.
-	// Note: I don't understand why <= works here, but it turns out that numTiles
-	// is equal to closure->numTiles when there is a split numTiles - 1 : 1.
-	if (numTiles < closure->numTiles) {
-
-		// Adds all non-connected tiles to a new closure.
-		newClosure = placeClosure();
-		indexClosure(newClosure).owner = closure->owner;
-		for (int i = 0; i < universeWidth * universeHeight; ++i) {
-			if (universe[i].closure == nClosure && !explored[i]) {
-				universe[i].closure = newClosure;
-				++indexClosure(newClosure).numTiles;
-				--indexClosure(nClosure).numTiles;
-				if (!indexClosure(newClosure).start) deIndex(indexClosure(newClosure).start.x, indexClosure(newClosure).start.y, i, universeWidth);
-
-			}
-		}
-
-		// If there was a split, checks the split closure to see if another split needs
-		// to be performed (as would happen when a three-way intersection is lost).
-		splitClosure(&indexClosure(newClosure), newClosure, coords, explored);
 
 	}
 }
 
 /*
-Entry function for recursive closure splitting. Allocates/frees shared memory.
+Attempts to split a closure marked for splitting. Does so by flooding all tiles of the closure
+which are connected to the closure's start, then searching the closure's bounding box for tiles
+which were not reached. Each group of unreached tiles is flooded into a new closure.
+
+The closure's tile count, coordinate sums, and bounding box are rebuilt by the flood, so the
+bounding box is exact afterwards.
+
+Note: This is written here to make manageClosures more comprehensible.
 */
 void splitClosure(SpaceClosure* closure, int nClosure) {
-	LinkedList<PathCoordinate>* coords = requestCoordList();
-	uint_least8_t* explored = requestDummy();
+	int xMin = closure->xMin, yMin = closure->yMin;
+	int xMax = closure->xMax, yMax = closure->yMax;
+	int numTiles = closure->numTiles;
+	int newClosure;
 
 	// Marks that the closure no longer needs to be split.
 	closure->split = false;
 
-	// Splits the closure.
-	splitClosure(closure, nClosure, coords, explored);
+	// Ensures that the start lies within the closure. This is done before requesting the
+	// ExploredMap below, since assignClosureStart requests its own.
+	if (uClosureID(closure->start.x, closure->start.y) != nClosure) assignClosureStart(closure, nClosure);
+	ScratchScope scratch;
+	CoordList coords;
+	ExploredMap* explored = requestExploredMap(universeWidth * universeHeight);
+
+	// Floods the tiles connected to the start. They are recounted during the flood.
+	closure->numTiles = 0;
+	closure->xSum = 0;
+	closure->ySum = 0;
+	floodClosure(closure->start.x, closure->start.y, nClosure, nClosure, &coords, explored);
+
+	// Gives each unreached group of tiles a new closure. The flood has shrunk the bounding box
+	// to the tiles connected to the start, so the original box is searched.
+	if (numTiles > closure->numTiles) forClosureTiles(xMin, yMin, xMax, yMax, nClosure, [&](int x, int y)->bool {
+		if (explored->visited(index(x, y, universeWidth))) return true;
+
+		// Creates the new closure. Several closures may be split at once.
+		universeMutex.lock();
+		newClosure = placeClosure();
+		closure->owner->addClosure(newClosure);
+		universeMutex.unlock();
+		indexClosure(newClosure).start = { x, y };
+
+		// Floods the group into the new closure.
+		floodClosure(x, y, nClosure, newClosure, &coords, explored);
+		numTiles -= indexClosure(newClosure).numTiles;
+		return numTiles > closure->numTiles;
+
+	});
 
 	// Releases held data.
-	releaseCoordList(coords);
-	releaseDummy(explored);
+	releaseExploredMap(explored);
+
+	// Moves the start if it is no longer near the centre of the closure.
+	assignClosureStart(closure, nClosure);
 
 }
 
 /*
-Reconciles closures. Does so by spreading the inputed closure over all connected
-owned tiles.
-
-Note: This is written here to make manageClosures more comprehensible.
-TODO: add functionality for merging attributes of closures when such 
-	  attributes exist.
+Relabels the tiles of every closure on the inputed page which has been merged into another.
 */
-void reconcileClosure(SpaceClosure* closure, uint_least16_t nClosure) {
-	LinkedList<PathCoordinate>* coords;
-	LinkedList<PathCoordinate> frontier = LinkedList<PathCoordinate>();
-	LinkedListNode<PathCoordinate>* currTile;
-	uint_least8_t* explored;
-	int xPos, yPos;
-	coords = requestCoordList();
-	explored = requestDummy();
-	memset(explored, 0, universeWidth * universeHeight);
+void mergeClosures(int page) {
+	closurePool.forEachInPage(page, [](SpaceClosure* closure) {
+		if (closure->rec) mergeClosure(closure, closurePool.indexOf(closure));
 
-	// Marks that the closure no longer needs to be reconciled.
-	closure->rec = false;
-
-	// Starts from the starting point of the closure.
-	currTile = coords->popc();
-	currTile->value->coord = closure->start;
-	explored[index(closure->start.x, closure->start.y, universeWidth)] = true;
-	frontier.addc(currTile);
-
-	// Spreads this closure over all connected owned tiles.
-	while (!frontier.isEmpty()) {
-
-		// Explores the first tile in the frontier.
-		currTile = frontier.popc();
-		xPos = currTile->value->coord.x;
-		yPos = currTile->value->coord.y;
-
-		// Removes the tile from its closure and gives it to the inputed closure.
-		changeClosure(xPos, yPos, nClosure);
-
-		// Queues all owned and unexplored tiles adjacent to the current tile.
-		actionDirection(xPos, yPos,
-			[&frontier, &coords, explored, closure](int x, int y)->void {
-				LinkedListNode<PathCoordinate>* tile;
+	});
+}
 
-				// Adds unexplored tiles belonging to this owner to the frontier.
-				if (!explored[index(x, y, universeWidth)] && uController(x, y) == closure->owner) {
-					explored[index(x, y, universeWidth)] = true;
-					tile = coords->popc();
-					tile->value->coord.x = x;
-					tile->value->coord.y = y;
-					frontier.addc(tile);
+/*
+Points every merged closure on the inputed page directly at the closure it was finally merged
+into. This must be done for every page before any merged closure is released, so that no
+closure is released while another still leads through it.
+*/
+void flattenClosures(int page) {
+	closurePool.forEachInPage(page, [](SpaceClosure* closure) {
+		if (closure->rec) closure->parent = findClosure(closure->parent);
 
-				}
-			}
-		);
+	});
+}
 
-		// Returns the used coord to the coordlist.
-		coords->addc(currTile);
+/*
+Releases every closure on the inputed page which has been merged into another or has lost all
+of its tiles.
 
-	}
+Note: This must not be run concurrently, since it modifies Governments' closures.
+*/
+void releaseMergedClosures(int page) {
+	closurePool.forEachInPage(page, [](SpaceClosure* closure) {
+		int nClosure = closurePool.indexOf(closure);
 
-	// Releases held data.
-	releaseCoordList(coords);
-	releaseDummy(explored);
+		// Releases merged closures.
+		if (closure->rec) releaseMergedClosure(closure, nClosure);
+		// Releases empty closures. Closures which others have been merged into are released above.
+		else if (closure->owner && !closure->numTiles && !closure->merged) {
+			closure->owner->removeClosure(nClosure);
+			freeClosure(nClosure);
 
+		}
+	});
 }
 
 /*
-Manages consolidation and splitting of closures for a given page.
-
-TODO implement multithreading for closure management.
-	note this may require a mutex for each nation so that no two same-nation closures overwrite one-another.
+Splits every closure on the inputed page which has been marked for splitting.
 */
-void manageClosures(int page) {
-	SpaceClosure* closure;
-
-	// Splits and reconciles all flagged closures.
-	for (int currClosure = 0; currClosure < CLOSURE_PAGE_SIZE; ++currClosure) {
-		closure = &closurePages[page]->closures[currClosure];
+void splitClosures(int page) {
+	closurePool.forEachInPage(page, [](SpaceClosure* closure) {
+		if (closure->split && closure->owner) splitClosure(closure, closurePool.indexOf(closure));
 
-		// Attempts to split marked closures.
-		if (closure->split) splitClosure(closure, page * CLOSURE_PAGE_SIZE + currClosure);
-		// Attempts to reconcile marked closures.
-		if (closure->rec) reconcileClosure(closure, page * CLOSURE_PAGE_SIZE + currClosure);
-
-	}
-}
\ No newline at end of file
+	});
+}
@@ -9,6 +9,9 @@ inline void deIndex(int& i, int& j, int f, int rowSize);
 // Calculates the distance between two points.
 inline int calcTaxiDistance(int x1, int y1, int x2, int y2);
 
+// Finds the index of the lowest set bit in a non-zero word.
+inline int lowestSetBit(uint64_t word);
+
 // Creates and returns an array of canvases.
 int*** createCanvases(int canvasSize, int numCanvases);
 
@@ -49,6 +52,20 @@ inline int calcTaxiDistance(int x1, int y1, int x2, int y2) {
 
 }
 
+/*
+Finds the index of the lowest set bit in a non-zero word.
+*/
+inline int lowestSetBit(uint64_t word) {
+#ifdef _MSC_VER
+	unsigned long bit;
+	_BitScanForward64(&bit, word);
+	return (int)bit;
+#else
+	return __builtin_ctzll(word);
+#endif
+
+}
+
 /*
 Creates and returns an array of canvases.
 */